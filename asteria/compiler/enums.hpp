@@ -134,6 +134,7 @@ enum Keyword : uint8_t
     keyword_muls        = 56,  // __muls
     keyword_isvoid      = 57,  // __isvoid
     keyword_ifcomplete  = 58,  // __ifcomplete
+    keyword_yield       = 59,
   };
 
 enum Jump_Target : uint8_t
@@ -149,6 +149,12 @@ class Statement
         S_expression expr;
       };
 
+    struct S_yield
+      {
+        Source_Location sloc;
+        S_expression expr;
+      };
+
     struct reference_declaration
       {
         Source_Location sloc;
@@ -181,6 +187,7 @@ class Statement
         index_assert      = 15,
         index_defer       = 16,
         index_references  = 17,
+        index_yield       = 18,
       };
 
   private:
@@ -204,6 +211,7 @@ class Statement
         , S_assert      // 15
         , S_defer       // 16
         , S_references  // 17
+        , S_yield       // 18
       );
 
   public:
@@ -7,6 +7,14 @@
 namespace asteria {
 namespace details_value {
 
+#ifdef ASTERIA_COMPACT_VALUE
+// Values that don't fit in a word are stored in boxes, which are allocated
+// dynamically, so storing them may throw.
+constexpr bool is_nothrow_boxing = false;
+#else
+constexpr bool is_nothrow_boxing = true;
+#endif
+
 template<typename xValue, typename xEnable = void>
 struct Valuable
   {
@@ -108,7 +116,7 @@ template<>
 struct Valuable<long>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage>
     static
@@ -123,7 +131,7 @@ template<>
 struct Valuable<long long>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage>
     static
@@ -168,7 +176,7 @@ template<>
 struct Valuable<cow_string>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage, typename xValue>
     static
@@ -183,7 +191,7 @@ template<>
 struct Valuable<cow_opaque>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage, typename xValue>
     static
@@ -198,7 +206,7 @@ template<>
 struct Valuable<cow_function>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage, typename xValue>
     static
@@ -213,7 +221,7 @@ template<>
 struct Valuable<cow_vector<Value>>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage, typename xValue>
     static
@@ -228,7 +236,7 @@ template<>
 struct Valuable<cow_dictionary<Value>>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage, typename xValue>
     static
@@ -243,7 +251,7 @@ template<>
 struct Valuable<cow_string::shallow_type>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage>
     static
@@ -258,7 +266,7 @@ template<size_t N>
 struct Valuable<const char (*)[N]>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage>
     static
@@ -275,7 +283,7 @@ struct Valuable<refcnt_ptr<xOpaque>,
         ::std::is_base_of<Abstract_Opaque, xOpaque>::value>::type>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage, typename xPointer>
     static
@@ -295,7 +303,7 @@ struct Valuable<refcnt_ptr<xFunction>,
         ::std::is_base_of<Abstract_Function, xFunction>::value>::type>
   {
     static constexpr bool is_enabled = true;
-    static constexpr bool is_noexcept = true;
+    static constexpr bool is_noexcept = is_nothrow_boxing;
 
     template<typename xStorage, typename xPointer>
     static
@@ -380,5 +388,381 @@ struct Valuable<xTuple,
       }
   };
 
+#ifdef ASTERIA_COMPACT_VALUE
+// This is the compact layout of values, which is selected at build time. A
+// value is a single word, which is interpreted as follows:
+//
+//   0x0000'0000'0000'0000                null
+//   0x0000'0000'0000'00X1                boolean `X`
+//   0x0000'PPPP'PPPP'PPPT                pointer to a box of type `T`
+//   0x0002'0000'0000'0000 ~ 0xFFFA'...   real, plus `real_offset`
+//   0xFFFC'0000'0000'0000 ~ 0xFFFF'...   50-bit integer, sign-extended
+//
+// Strings, opaque values, functions, arrays, objects, and integers that don't
+// fit in 50 bits are stored in boxes, which are shared by copies and cloned
+// before they are modified. NaNs are canonicalized, so they don't overlap
+// integers.
+using Compact_Variant = variant<ASTERIA_TYPES_AIXE9XIG_(V)>;
+
+struct alignas(16) Compact_Box
+  {
+    Compact_Variant stor;
+    mutable reference_counter<int> nref = { };
+  };
+
+class Compact_Storage;
+
+// This is returned by `Value::open_boolean()`, `open_integer()` and
+// `open_real()`, as a scalar in a word can't be referenced.
+template<typename xScalar>
+class Scalar_Ref
+  {
+  private:
+    Compact_Storage* m_stor;
+
+  public:
+    explicit constexpr
+    Scalar_Ref(Compact_Storage& stor)
+      noexcept
+      :
+        m_stor(&stor)
+      { }
+
+    Scalar_Ref&
+    operator=(const Scalar_Ref& other)
+      {
+        return *this = static_cast<xScalar>(other);
+      }
+
+    Scalar_Ref&
+    operator=(xScalar other);
+
+    operator xScalar()
+      const noexcept;
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator+=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) + other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator-=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) - other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator*=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) * other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator/=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) / other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator%=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) % other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator&=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) & other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator|=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) | other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator^=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) ^ other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator<<=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) << other);  }
+
+    template<typename xOther>
+    Scalar_Ref&
+    operator>>=(const xOther& other)
+      { return *this = static_cast<xScalar>(static_cast<xScalar>(*this) >> other);  }
+  };
+
+template<typename xScalar>
+inline
+tinyfmt&
+operator<<(tinyfmt& fmt, const Scalar_Ref<xScalar>& ref)
+  {
+    return fmt << static_cast<xScalar>(ref);
+  }
+
+class Compact_Storage
+  {
+  private:
+    static constexpr uint64_t cell_mask       = 0xFFFF'FFFF'FFFF'FFF0;
+    static constexpr uint64_t real_offset     = 0x0002'0000'0000'0000;
+    static constexpr uint64_t integer_tag     = 0xFFFC'0000'0000'0000;
+    static constexpr uint64_t integer_mask    = 0x0003'FFFF'FFFF'FFFF;
+
+    uint64_t m_word;
+
+  public:
+    constexpr
+    Compact_Storage()
+      noexcept
+      :
+        m_word(0)
+      { }
+
+    Compact_Storage(const Compact_Storage& other)
+      noexcept
+      :
+        m_word(other.m_word)
+      {
+        if(other.is_boxed())
+          other.do_get_box()->nref.increment();
+      }
+
+    Compact_Storage&
+    operator=(const Compact_Storage& other)
+      & noexcept
+      {
+        Compact_Storage temp(other);
+        ::std::swap(this->m_word, temp.m_word);
+        return *this;
+      }
+
+    Compact_Storage&
+    operator=(Compact_Storage&& other)
+      & noexcept
+      {
+        ::std::swap(this->m_word, other.m_word);
+        return *this;
+      }
+
+    ~Compact_Storage()
+      {
+        if(this->is_boxed())
+          this->free_box();
+      }
+
+  private:
+    static constexpr
+    bool
+    do_is_boxed_word(uint64_t word)
+      noexcept
+      { return (word < real_offset) && ((word & ~cell_mask) > type_boolean);  }
+
+    static
+    void
+    do_delete_box(uint64_t word)
+      noexcept;
+
+    // Destroying a box may run arbitrary code, which may assign to this value,
+    // so the new word is stored before the old box is deleted.
+    void
+    do_reset_word(uint64_t word)
+      noexcept
+      {
+        uint64_t old = this->m_word;
+        this->m_word = word;
+        if(do_is_boxed_word(old))
+          do_delete_box(old);
+      }
+
+    void
+    do_unshare_box();
+
+    void
+    do_set_integer_slow(V_integer other);
+
+    Compact_Box*
+    do_get_box()
+      const noexcept
+      { return reinterpret_cast<Compact_Box*>(static_cast<uintptr_t>(this->m_word & cell_mask));  }
+
+    template<typename xValue, typename... xArgs>
+    xValue&
+    do_emplace_boxed(xArgs&&... args)
+      {
+        auto box = new Compact_Box{ Compact_Variant(xValue(forward<xArgs>(args)...)) };
+        this->do_reset_word(reinterpret_cast<uintptr_t>(box) | box->stor.index());
+        return box->stor.template mut<xValue>();
+      }
+
+  public:
+    size_t
+    index()
+      const noexcept
+      {
+        if(this->m_word < real_offset)
+          return this->m_word & ~cell_mask;
+        else if(this->m_word >= integer_tag)
+          return type_integer;
+        else
+          return type_real;
+      }
+
+    bool
+    is_boxed()
+      const noexcept
+      { return do_is_boxed_word(this->m_word);  }
+
+    bool
+    is_box_unique()
+      const noexcept
+      { return this->do_get_box()->nref.unique();  }
+
+    // These are used by `Value` to destroy nested values iteratively.
+    Compact_Variant&
+    mut_boxed()
+      noexcept
+      {
+        ASTERIA_ASSERT(this->is_box_unique());
+        return this->do_get_box()->stor;
+      }
+
+    void
+    free_box()
+      noexcept
+      { this->do_reset_word(0);  }
+
+    template<typename xValue>
+    typename ::std::conditional<::std::is_scalar<xValue>::value,
+                                xValue, const xValue&>::type
+    as()
+      const noexcept
+      {
+        if constexpr (::std::is_same<xValue, V_boolean>::value)
+          return this->m_word >> 4;
+        else if constexpr (::std::is_same<xValue, V_integer>::value) {
+          if(ASTERIA_EXPECT(this->m_word >= integer_tag))
+            return static_cast<int64_t>(this->m_word << 14) >> 14;
+          else
+            return this->do_get_box()->stor.template as<V_integer>();
+        }
+        else if constexpr (::std::is_same<xValue, V_real>::value) {
+          uint64_t bits = this->m_word - real_offset;
+          V_real val;
+          ::memcpy(&val, &bits, sizeof(val));
+          return val;
+        }
+        else
+          return this->do_get_box()->stor.template as<xValue>();
+      }
+
+    template<typename xValue>
+    typename ::std::conditional<::std::is_scalar<xValue>::value,
+                                Scalar_Ref<xValue>, xValue&>::type
+    mut()
+      noexcept(::std::is_scalar<xValue>::value)
+      {
+        if constexpr (::std::is_scalar<xValue>::value)
+          return Scalar_Ref<xValue>(*this);
+        else {
+          if(!this->is_box_unique())
+            this->do_unshare_box();
+          return this->do_get_box()->stor.template mut<xValue>();
+        }
+      }
+
+    template<typename xValue, typename... xArgs>
+    decltype(auto)
+    emplace(xArgs&&... args)
+      {
+        if constexpr (::std::is_same<xValue, V_null>::value)
+          this->do_reset_word(0);
+        else if constexpr (::std::is_scalar<xValue>::value) {
+          this->set(xValue(forward<xArgs>(args)...));
+          return Scalar_Ref<xValue>(*this);
+        }
+        else
+          return this->do_emplace_boxed<xValue>(forward<xArgs>(args)...);
+      }
+
+    void
+    set(V_null)
+      noexcept
+      {
+        this->emplace<V_null>();
+      }
+
+    void
+    set(V_boolean other)
+      noexcept
+      {
+        this->do_reset_word(static_cast<uint64_t>(other) << 4 | type_boolean);
+      }
+
+    void
+    set(V_integer other)
+      {
+        uint64_t word = static_cast<uint64_t>(other) & integer_mask;
+        if(ASTERIA_UNEXPECT(static_cast<int64_t>(word << 14) >> 14 != other))
+          return this->do_set_integer_slow(other);
+
+        this->do_reset_word(word | integer_tag);
+      }
+
+    void
+    set(V_real other)
+      noexcept
+      {
+        uint64_t bits;
+        ::memcpy(&bits, &other, sizeof(bits));
+        if(ASTERIA_UNEXPECT((bits & 0x7FFF'FFFF'FFFF'FFFF) > 0x7FF0'0000'0000'0000))
+          bits = (bits & 0x8000'0000'0000'0000) | 0x7FF8'0000'0000'0000;
+
+        this->do_reset_word(bits + real_offset);
+      }
+
+    template<typename xValue,
+    ASTERIA_ENABLE_IF(!::std::is_scalar<typename remove_cvref<xValue>::type>::value)>
+    void
+    set(xValue&& other)
+      {
+        using value_type = typename remove_cvref<xValue>::type;
+        if((this->index() == Compact_Variant::index_of<value_type>::value)
+           && this->is_box_unique())
+          this->do_get_box()->stor.template mut<value_type>() = forward<xValue>(other);
+        else
+          this->emplace<value_type>(forward<xValue>(other));
+      }
+
+    // These are used by `Valuable<>`.
+    template<typename xValue,
+    ASTERIA_ENABLE_IF(!::std::is_same<typename remove_cvref<xValue>::type,
+                                      Compact_Storage>::value)>
+    Compact_Storage&
+    operator=(xValue&& other)
+      {
+        this->set(forward<xValue>(other));
+        return *this;
+      }
+  };
+
+template<typename xScalar>
+inline
+Scalar_Ref<xScalar>&
+Scalar_Ref<xScalar>::
+operator=(xScalar other)
+  {
+    this->m_stor->set(other);
+    return *this;
+  }
+
+template<typename xScalar>
+inline
+Scalar_Ref<xScalar>::
+operator xScalar()
+  const noexcept
+  {
+    return this->m_stor->template as<xScalar>();
+  }
+#endif
+
 }  // namespace details_value
 }  // namespace asteria
@@ -60,6 +60,7 @@ enum Switch_Clause_Type : uint8_t;
 enum Xop : uint8_t;
 enum AIR_Status : uint8_t;
 enum PTC_Aware : uint8_t;
+enum Hook_Mask : uint32_t;
 struct Abstract_Hooks;
 class Runtime_Error;
 class Reference;
@@ -76,6 +77,7 @@ class Random_Engine;
 class Module_Loader;
 class Variadic_Arguer;
 class Instantiated_Function;
+class Generator;
 class AIR_Node;
 class Argument_Reader;
 class Binding_Generator;
@@ -112,6 +114,10 @@ ASTERIA_DEFINE_TAG_(xtc_defer);
 ASTERIA_DEFINE_TAG_(xtc_function);
 ASTERIA_DEFINE_TAG_(xtc_assert);
 ASTERIA_DEFINE_TAG_(xtc_throw);
+ASTERIA_DEFINE_TAG_(xtc_fuel);
+ASTERIA_DEFINE_TAG_(xtc_cancel);
+ASTERIA_DEFINE_TAG_(xtc_timeout);
+ASTERIA_DEFINE_TAG_(xtc_interrupt);
 
 // Type erasure
 struct Rcbase
@@ -559,6 +565,18 @@ class cow_function
     void
     invoke(Reference& self, Global_Context& global, Reference_Stack&& stack)
       const;
+
+    // These functions operate on generators, which are returned by calls to
+    // functions that contain `yield`. `resume()` stores the next value into
+    // `value` and returns `true`, or returns `false` if the generator has
+    // completed.
+    bool
+    is_generator()
+      const noexcept;
+
+    bool
+    resume(Value& value, Global_Context& global)
+      const;
   };
 
 inline
@@ -630,6 +648,21 @@ const char*
 describe_frame_type(Frame_Type type)
   noexcept;
 
+// Kinds of hooks, which may be enabled individually
+enum Hook_Mask : uint32_t
+  {
+    hook_mask_none            = 0,
+    hook_mask_trap            = 0x0001,  // `on_trap()`
+    hook_mask_declare         = 0x0002,  // `on_declare()`
+    hook_mask_call            = 0x0004,  // `on_call()`
+    hook_mask_return          = 0x0008,  // `on_return()`
+    hook_mask_throw           = 0x0010,  // `on_throw()`
+    hook_mask_function_enter  = 0x0020,  // `on_function_enter()`
+    hook_mask_function_leave  = 0x0040,  // `on_function_leave()`
+    hook_mask_interrupt       = 0x0080,  // `on_interrupt()`
+    hook_mask_all             = 0x00FF,
+  };
+
 // Compiler status codes
 enum Compiler_Status : uint32_t
   {
@@ -769,6 +802,18 @@ struct Compiler_Options_v
     // calculated in source information.
     uint8_t tab_stop = 8;
     // (0x0007)
+
+    // Inline calls to small immutable functions. Inlined calls don't invoke
+    // hooks, so this may be disabled for debugging.
+    bool inline_functions = true;
+    // (0x0008)
+
+    // Bind members of the standard library, such as `std.string.find`, to
+    // their values at compile time. This takes effect at `optimization_level`
+    // 2 or higher. Bound values are taken from the global context when the
+    // script is compiled, and don't reflect later changes to `std` by the host.
+    bool bind_library_members = true;
+    // (0x0009)
   };
 
 using Compiler_Options = Compiler_Options_v<(api_version_latest >> 16)>;
@@ -100,6 +100,10 @@ class Reference_Dictionary
     bool
     erase(const phcow_string& key, Reference* refp_opt)
       noexcept;
+
+    void
+    collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+      const;
   };
 
 inline
@@ -133,6 +133,10 @@ class Reference_Stack
           destroy(this->m_bptr + this->m_size);
         }
       }
+
+    void
+    collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+      const;
   };
 
 inline
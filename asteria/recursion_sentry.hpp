@@ -9,6 +9,10 @@ namespace asteria {
 
 class Recursion_Sentry
   {
+  public:
+    // The maximum usage of stack is `1 << nbits_limit` bytes.
+    static constexpr int nbits_limit = 20;  // 1 MiB
+
   private:
     const void* m_base;
 
@@ -51,7 +55,6 @@ class Recursion_Sentry
       const
       {
         ptrdiff_t usage = (char*) this->m_base - (char*) this;
-        constexpr int nbits_limit = 20;  // 1 MiB
         constexpr int nbits_pointer = ::std::numeric_limits<ptrdiff_t>::digits;
 
         if(ASTERIA_UNEXPECT(usage >> nbits_limit != usage >> nbits_pointer))
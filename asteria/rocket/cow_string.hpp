@@ -26,6 +26,8 @@ namespace asteria {
 //    null-terminated character arrays allocated externally.
 // 7. `data()` returns a null pointer if the string is empty.
 // 8. `erase()` and `substr()` cannot be called without arguments.
+// 9. Short strings are stored inline, so pointers and iterators into them
+//    are invalidated when the string is moved or swapped.
 template<typename charT>
 class basic_shallow_string;
 
@@ -60,6 +62,15 @@ class basic_shallow_string
         m_ptr(ptr), m_len(details_xstring::maybe_constexpr::ystrlen(ptr))
       { }
 
+    // N.B. This is a non-standard extension. The string may contain null
+    // characters, but it must be followed by one.
+    ASTERIA_CONSTEXPR_INLINE
+    basic_shallow_string(const charT* ptr, size_t len)
+      noexcept
+      :
+        m_ptr(ptr), m_len((ASTERIA_ASSERT(ptr[len] == charT()), len))
+      { }
+
     template<size_t N>
     ASTERIA_CONSTEXPR_INLINE
     basic_shallow_string(const charT (*ps)[N])
@@ -119,6 +130,13 @@ sref(const charT* ptr)
   noexcept
   { return basic_shallow_string<charT>(ptr);  }
 
+template<typename charT>
+constexpr
+basic_shallow_string<charT>
+sref(const charT* ptr, size_t len)
+  noexcept
+  { return basic_shallow_string<charT>(ptr, len);  }
+
 template<typename charT, typename allocT>
 class basic_cow_string
   {
@@ -152,7 +170,15 @@ class basic_cow_string
     static_assert(s_zstr.m_len == 0);
 
     using storage_handle = details_cow_string::storage_handle<allocator_type>;
-    shallow_type m_ref;
+    static constexpr size_type sso_capacity = sizeof(shallow_type) / sizeof(value_type) - 1;
+
+    // If `m_sth` denotes an inline string, characters are stored in `m_sso`,
+    // with a null terminator. Otherwise, `m_ref` points to either external or
+    // dynamic storage.
+    union {
+      shallow_type m_ref;
+      value_type m_sso[sso_capacity + 1];
+    };
     storage_handle m_sth;
 
   public:
@@ -204,28 +230,41 @@ class basic_cow_string
     basic_cow_string(const basic_cow_string& other)
       noexcept
       :
-        m_ref(other.m_ref),
         m_sth(allocator_traits<allocator_type>::select_on_container_copy_construction(
                                                     other.m_sth.as_allocator()))
-      { this->m_sth.share_with(other.m_sth);  }
+      {
+        this->do_copy_representation(other);
+        this->m_sth.share_with(other.m_sth);
+      }
 
     basic_cow_string(const basic_cow_string& other, const allocator_type& alloc)
       noexcept
       :
-        m_ref(other.m_ref), m_sth(alloc)
-      { this->m_sth.share_with(other.m_sth);  }
+        m_sth(alloc)
+      {
+        this->do_copy_representation(other);
+        this->m_sth.share_with(other.m_sth);
+      }
 
     basic_cow_string(basic_cow_string&& other)
       noexcept
       :
-        m_ref(noadl::exchange(other.m_ref, s_zstr)), m_sth(move(other.m_sth.as_allocator()))
-      { this->m_sth.exchange_with(other.m_sth);  }
+        m_sth(move(other.m_sth.as_allocator()))
+      {
+        this->do_copy_representation(other);
+        this->m_sth.exchange_with(other.m_sth);
+        other.m_ref = s_zstr;
+      }
 
     basic_cow_string(basic_cow_string&& other, const allocator_type& alloc)
       noexcept
       :
-        m_ref(noadl::exchange(other.m_ref, s_zstr)), m_sth(alloc)
-      { this->m_sth.exchange_with(other.m_sth);  }
+        m_sth(alloc)
+      {
+        this->do_copy_representation(other);
+        this->m_sth.exchange_with(other.m_sth);
+        other.m_ref = s_zstr;
+      }
 
     basic_cow_string(initializer_list<value_type> init, const allocator_type& alloc = allocator_type())
       :
@@ -265,6 +304,7 @@ class basic_cow_string
     operator=(shallow_type sh)
       & noexcept
       {
+        this->do_leave_inline();
         this->m_ref = sh;
         return *this;
       }
@@ -274,6 +314,7 @@ class basic_cow_string
     operator=(const charT (*ps)[N])
       & noexcept
       {
+        this->do_leave_inline();
         this->m_ref = shallow_type(ps);
         return *this;
       }
@@ -282,9 +323,12 @@ class basic_cow_string
     operator=(const basic_cow_string& other)
       & noexcept
       {
+        if(&other == this)
+          return *this;
+
         noadl::propagate_allocator_on_copy(this->m_sth.as_allocator(), other.m_sth.as_allocator());
         this->m_sth.share_with(other.m_sth);
-        this->m_ref = other.m_ref;
+        this->do_copy_representation(other);
         return *this;
       }
 
@@ -292,9 +336,15 @@ class basic_cow_string
     operator=(basic_cow_string&& other)
       & noexcept
       {
+        // An inline string would be moved out of itself and then cleared.
+        if(&other == this)
+          return *this;
+
         noadl::propagate_allocator_on_move(this->m_sth.as_allocator(), other.m_sth.as_allocator());
         this->m_sth.exchange_with(other.m_sth);
-        this->m_ref = noadl::exchange(other.m_ref, s_zstr);
+        this->do_copy_representation(other);
+        other.m_ref = s_zstr;
+        other.do_leave_inline();
         return *this;
       }
 
@@ -313,12 +363,24 @@ class basic_cow_string
       {
         noadl::propagate_allocator_on_swap(this->m_sth.as_allocator(), other.m_sth.as_allocator());
         this->m_sth.exchange_with(other.m_sth);
-        ::std::swap(this->m_ref.m_ptr, other.m_ref.m_ptr);
-        ::std::swap(this->m_ref.m_len, other.m_ref.m_len);
+        value_type temp[sso_capacity + 1];
+        ::memcpy(temp, this->m_sso, sizeof(temp));
+        this->do_copy_representation(other);
+        ::memcpy(other.m_sso, temp, sizeof(temp));
         return *this;
       }
 
   private:
+    // Copies either the reference or inline characters, whichever is in use.
+    // The union is copied as bytes, so its inactive member is never read.
+    void
+    do_copy_representation(const basic_cow_string& other)
+      noexcept
+      {
+        static_assert(sizeof(this->m_sso) == sizeof(this->m_ref));
+        ::memcpy(this->m_sso, other.m_sso, sizeof(this->m_sso));
+      }
+
     basic_cow_string&
     do_deallocate()
       noexcept
@@ -328,13 +390,51 @@ class basic_cow_string
         return *this;
       }
 
+    void
+    do_leave_inline()
+      noexcept
+      {
+        if(this->m_sth.is_inline())
+          this->m_sth.deallocate();
+      }
+
     void
     do_set_data_and_size(value_type* ptr, size_type n)
       noexcept
       {
         ptr[n] = value_type();
-        this->m_ref.m_ptr = ptr;
-        this->m_ref.m_len = n;
+        if(ptr == this->m_sso)
+          this->m_sth.set_inline_size(n);
+        else
+          this->m_ref = shallow_type(ptr, n);
+      }
+
+    // Gets a pointer to characters that may be modified in place. If they are
+    // neither inline nor in unique dynamic storage, a null pointer is returned.
+    value_type*
+    do_mut_data_opt()
+      noexcept
+      {
+        if(this->m_sth.is_inline())
+          return this->m_sso;
+
+        // The string may have been assigned external characters after the
+        // storage was allocated. If it is not empty, they have to be copied.
+        auto ptr = this->m_sth.mut_data_opt();
+        if(ptr && (ptr != this->m_ref.m_ptr) && (this->m_ref.m_len != 0))
+          return nullptr;
+        return ptr;
+      }
+
+    // Stores characters inline. `s` shall not point into `m_sso`.
+    basic_cow_string&
+    do_assign_inline(const value_type* s, size_type n)
+      noexcept
+      {
+        ASTERIA_ASSERT(n <= sso_capacity);
+        ::memcpy(this->m_sso, s, n * sizeof(value_type));
+        this->do_set_data_and_size(this->m_sso, n);
+        return *this;
       }
 
     [[noreturn]] ASTERIA_NEVER_INLINE
@@ -357,7 +457,6 @@ class basic_cow_string
 
     // This function ensures `tpos` is within range and returns the number of
     // elements that start there.
-    constexpr
     size_type
     do_clamp_substr(size_type tpos, size_type tn)
       const
@@ -373,9 +472,11 @@ class basic_cow_string
     do_swizzle_unchecked(size_type tpos, size_type tlen, size_type old_size)
       {
         auto ptr = this->mut_data();
-        noadl::rotate(ptr, tpos, tpos + tlen, this->m_ref.m_len + 1);  // with null terminator
-        this->m_ref.m_len -= tlen;
-        noadl::rotate(ptr, tpos, old_size - tlen, this->m_ref.m_len);
+        size_type len = this->size();
+        noadl::rotate(ptr, tpos, tpos + tlen, len + 1);  // with null terminator
+        len -= tlen;
+        this->do_set_data_and_size(ptr, len);
+        noadl::rotate(ptr, tpos, old_size - tlen, len);
         return ptr + tpos;
       }
 
@@ -450,26 +551,26 @@ class basic_cow_string
       { return ::std::move_iterator<reverse_iterator>(this->mut_rend());  }
 
     // 24.3.2.4, capacity
-    constexpr
     bool
     empty()
       const noexcept
-      { return this->m_ref.m_len == 0;  }
+      { return this->size() == 0;  }
 
-    constexpr
     size_type
     size()
       const noexcept
-      { return this->m_ref.m_len;  }
+      {
+        if(this->m_sth.is_inline())
+          return this->m_sth.inline_size();
+        return this->m_ref.m_len;
+      }
 
-    constexpr
     size_type
     length()
       const noexcept
-      { return this->m_ref.m_len;  }
+      { return this->size();  }
 
     // N.B. This is a non-standard extension.
-    constexpr
     difference_type
     ssize()
       const noexcept
@@ -490,11 +591,14 @@ class basic_cow_string
                  : this->pop_back(this->size() - n);
       }
 
-    constexpr
     size_type
     capacity()
       const noexcept
-      { return this->m_sth.capacity();  }
+      {
+        if(this->m_sth.is_inline())
+          return sso_capacity;
+        return this->m_sth.capacity();
+      }
 
     // N.B. The return type is a non-standard extension.
     basic_cow_string&
@@ -504,17 +608,22 @@ class basic_cow_string
         if(res_arg == 0)
           return this->shrink_to_fit();
 
+        // Inline strings need no more room.
+        size_type len = this->size();
+        if(this->m_sth.is_inline() && (res_arg <= sso_capacity))
+          return *this;
+
         // Calculate the minimum capacity to reserve. This must include all existent characters.
         // Don't reallocate if the storage is unique and there is enough room.
-        size_type rcap = this->m_sth.round_up_capacity(noadl::max(this->size(), res_arg));
-        if(this->unique() && (this->capacity() >= rcap))
+        size_type rcap = this->m_sth.round_up_capacity(noadl::max(len, res_arg));
+        if(this->do_mut_data_opt() && (this->capacity() >= rcap))
           return *this;
 
         // Allocate new storage.
         storage_handle sth(this->m_sth.as_allocator());
-        auto ptr = sth.reallocate_more(this->data(), this->size(), rcap - this->size());
+        auto ptr = sth.reallocate_more(this->data(), len, rcap - len);
         this->m_sth.exchange_with(sth);
-        this->m_ref.m_ptr = ptr;
+        this->do_set_data_and_size(ptr, len);
         return *this;
       }
 
@@ -527,16 +636,24 @@ class basic_cow_string
           return this->do_deallocate();
 
         // Calculate the minimum capacity to reserve. This must include all existent characters.
-        // Don't reallocate if the storage is shared or tight.
-        size_type rcap = this->m_sth.round_up_capacity(this->size());
-        if(!this->unique() || (this->capacity() <= rcap))
+        // Don't reallocate if the storage is shared, inline or tight.
+        size_type len = this->size();
+        size_type rcap = this->m_sth.round_up_capacity(len);
+        if(this->m_sth.is_inline() || !this->unique() || (this->capacity() <= rcap))
           return *this;
 
+        // Short strings are moved inline.
+        if(len <= sso_capacity) {
+          value_type temp[sso_capacity + 1];
+          ::memcpy(temp, this->data(), len * sizeof(value_type));
+          return this->do_assign_inline(temp, len);
+        }
+
         // Allocate new storage.
         storage_handle sth(this->m_sth.as_allocator());
-        auto ptr = sth.reallocate_more(this->data(), this->size(), 0);
+        auto ptr = sth.reallocate_more(this->data(), len, 0);
         this->m_sth.exchange_with(sth);
-        this->m_ref.m_ptr = ptr;
+        this->do_set_data_and_size(ptr, len);
         return *this;
       }
 
@@ -545,7 +662,10 @@ class basic_cow_string
     clear()
       noexcept
       {
-        this->m_ref = s_zstr;
+        if(this->m_sth.is_inline())
+          this->do_set_data_and_size(this->m_sso, 0);
+        else
+          this->m_ref = s_zstr;
         return *this;
       }
 
@@ -579,7 +699,6 @@ class basic_cow_string
                  ? (this->data() + pos) : nullptr;
       }
 
-    constexpr
     const_reference
     operator[](size_type pos)
       const noexcept
@@ -589,7 +708,6 @@ class basic_cow_string
         return this->c_str()[pos];
       }
 
-    constexpr
     const_reference
     front()
       const noexcept
@@ -597,7 +715,6 @@ class basic_cow_string
         return this->c_str()[0];
       }
 
-    constexpr
     const_reference
     back()
       const noexcept
@@ -661,20 +778,28 @@ class basic_cow_string
           return *this;
 
         // Check whether the storage is unique and there is enough space.
-        auto ptr = this->m_sth.mut_data_opt();
+        auto ptr = this->do_mut_data_opt();
         size_type cap = this->capacity();
         size_type len = this->size();
 
-        if(ASTERIA_EXPECT(ptr && (n <= cap - len))) {
+        if(ASTERIA_EXPECT(ptr && (len <= cap) && (n <= cap - len))) {
           ::memmove(ptr + len, s, n * sizeof(value_type));
           len += n;
           this->do_set_data_and_size(ptr, len);
           return *this;
         }
 
+        if(ASTERIA_EXPECT(n <= sso_capacity - noadl::min(len, sso_capacity))) {
+          // Store the result inline. `s` may point into this string.
+          value_type temp[sso_capacity + 1];
+          ::memcpy(temp, this->data(), len * sizeof(value_type));
+          ::memcpy(temp + len, s, n * sizeof(value_type));
+          return this->do_assign_inline(temp, len + n);
+        }
+
         // Allocate new storage.
         storage_handle sth(this->m_sth.as_allocator());
-        ptr = sth.reallocate_more(this->m_ref.m_ptr, len, n | cap / 2);
+        ptr = sth.reallocate_more(this->data(), len, n | cap / 2);
         ::memcpy(ptr + len, s, n * sizeof(value_type));
         len += n;
         this->m_sth.exchange_with(sth);
@@ -689,20 +814,28 @@ class basic_cow_string
           return *this;
 
         // Check whether the storage is unique and there is enough space.
-        auto ptr = this->m_sth.mut_data_opt();
+        auto ptr = this->do_mut_data_opt();
         size_type cap = this->capacity();
         size_type len = this->size();
 
-        if(ASTERIA_EXPECT(ptr && (n <= cap - len))) {
+        if(ASTERIA_EXPECT(ptr && (len <= cap) && (n <= cap - len))) {
           noadl::xmempset(ptr + len, c, n);
           len += n;
           this->do_set_data_and_size(ptr, len);
           return *this;
         }
 
+        if(ASTERIA_EXPECT(n <= sso_capacity - noadl::min(len, sso_capacity))) {
+          // Store the result inline.
+          value_type temp[sso_capacity + 1];
+          ::memcpy(temp, this->data(), len * sizeof(value_type));
+          noadl::xmempset(temp + len, c, n);
+          return this->do_assign_inline(temp, len + n);
+        }
+
         // Allocate new storage.
         storage_handle sth(this->m_sth.as_allocator());
-        ptr = sth.reallocate_more(this->m_ref.m_ptr, len, n | cap / 2);
+        ptr = sth.reallocate_more(this->data(), len, n | cap / 2);
         noadl::xmempset(ptr + len, c, n);
         len += n;
         this->m_sth.exchange_with(sth);
@@ -722,28 +855,37 @@ class basic_cow_string
         size_type n = static_cast<size_type>(dist);
 
         // Check whether the storage is unique and there is enough space.
-        auto ptr = this->m_sth.mut_data_opt();
+        auto ptr = this->do_mut_data_opt();
         size_type cap = this->capacity();
         size_type len = this->size();
 
-        if(ASTERIA_EXPECT(dist && (dist == n) && ptr && (n <= cap - len))) {
+        if(ASTERIA_EXPECT(dist && (dist == n) && ptr && (len <= cap) && (n <= cap - len))) {
           for(auto it = move(first);  it != last;  ++it)
             ptr[len++] = *it;
           this->do_set_data_and_size(ptr, len);
           return *this;
         }
 
+        if(ASTERIA_EXPECT(dist && (dist == n) && (n <= sso_capacity - noadl::min(len, sso_capacity)))) {
+          // Store the result inline.
+          value_type temp[sso_capacity + 1];
+          ::memcpy(temp, this->data(), len * sizeof(value_type));
+          for(auto it = move(first);  it != last;  ++it)
+            temp[len++] = *it;
+          return this->do_assign_inline(temp, len);
+        }
+
         // Allocate new storage.
         storage_handle sth(this->m_sth.as_allocator());
         if(ASTERIA_EXPECT(dist && (dist == n))) {
           // The length is known.
-          ptr = sth.reallocate_more(this->m_ref.m_ptr, len, n | cap / 2);
+          ptr = sth.reallocate_more(this->data(), len, n | cap / 2);
           for(auto it = move(first);  it != last;  ++it)
             ptr[len++] = *it;
         }
         else {
           // The length is not known.
-          ptr = sth.reallocate_more(this->m_ref.m_ptr, len, 17 | cap / 2);
+          ptr = sth.reallocate_more(this->data(), len, 17 | cap / 2);
           cap = sth.capacity();
           for(auto it = move(first);  it != last;  ++it) {
             if(ASTERIA_UNEXPECT(len >= cap)) {
@@ -1062,15 +1204,23 @@ class basic_cow_string
           return *this;
 
         // If the storage is unique, modify it in place.
-        auto ptr = this->m_sth.mut_data_opt();
+        size_type len = this->size() - n;
+        auto ptr = this->do_mut_data_opt();
         if(ASTERIA_EXPECT(ptr)) {
-          this->do_set_data_and_size(ptr, this->size() - n);
+          this->do_set_data_and_size(ptr, len);
           return *this;
         }
 
+        if(ASTERIA_EXPECT(len <= sso_capacity)) {
+          // Store the result inline.
+          value_type temp[sso_capacity + 1];
+          ::memcpy(temp, this->data(), len * sizeof(value_type));
+          return this->do_assign_inline(temp, len);
+        }
+
         // Reallocate the storage.
-        ptr = this->m_sth.reallocate_more(this->data(), this->size() - n, 0);
-        this->do_set_data_and_size(ptr, this->size() - n);
+        ptr = this->m_sth.reallocate_more(this->data(), len, 0);
+        this->do_set_data_and_size(ptr, len);
         return *this;
       }
 
@@ -1082,7 +1232,13 @@ class basic_cow_string
         size_type tlen = this->do_clamp_substr(tpos, tn);
         basic_cow_string res(this->m_sth.as_allocator());
 
-        if(tpos + tlen == this->m_ref.m_len) {
+        if(tlen <= sso_capacity) {
+          // Copy short strings, which is cheaper than sharing.
+          res.do_assign_inline(this->data() + tpos, tlen);
+          return res;
+        }
+
+        if(tpos + tlen == this->size()) {
           // Reuse the last part of existing dynamic storage.
           res.m_sth.share_with(this->m_sth);
           res.m_ref.m_ptr = this->m_ref.m_ptr + tpos;
@@ -1091,7 +1247,7 @@ class basic_cow_string
         }
 
         // Duplicate the subrange.
-        auto ptr = res.m_sth.reallocate_more(this->m_ref.m_ptr, 0, tlen);
+        auto ptr = res.m_sth.reallocate_more(this->data(), 0, tlen);
         ::memcpy(ptr, this->data() + tpos, tlen * sizeof(value_type));
         res.do_set_data_and_size(ptr, tlen);
         return res;
@@ -1152,29 +1308,32 @@ class basic_cow_string
       }
 
     // 24.3.2.7, string operations
-    constexpr
     const value_type*
     data()
       const noexcept
-      { return this->m_ref.m_ptr;  }
+      {
+        if(this->m_sth.is_inline())
+          return this->m_sso;
+        return this->m_ref.m_ptr;
+      }
 
-    constexpr
     const value_type*
     c_str()
       const noexcept
-      { return this->m_ref.m_ptr;  }
+      { return this->data();  }
 
     // N.B. This is a non-standard extension.
     const value_type*
     safe_c_str()
       const
       {
-        size_type clen = noadl::xstrlen(this->m_ref.m_ptr);
-        if(clen != this->m_ref.m_len)
+        auto ptr = this->data();
+        size_type clen = noadl::xstrlen(ptr);
+        if(clen != this->size())
           noadl::sprintf_and_throw<domain_error>(
               "basic_cow_string: embedded null character detected at `%lld`",
               static_cast<long long>(clen));
-        return this->m_ref.m_ptr;
+        return ptr;
       }
 
     // Get a pointer to mutable data. This function may throw `std::bad_alloc`.
@@ -1182,12 +1341,24 @@ class basic_cow_string
     value_type*
     mut_data()
       {
+        if(this->m_sth.is_inline())
+          return this->m_sso;
+
         auto ptr = this->m_sth.mut_data_opt();
         if(ASTERIA_EXPECT(ptr == this->m_ref.m_ptr))
           return ptr;
 
+        // Copy short strings inline. The length is left intact.
+        size_type len = this->size();
+        if(len <= sso_capacity) {
+          value_type temp[sso_capacity + 1];
+          ::memcpy(temp, this->data(), len * sizeof(value_type));
+          this->do_assign_inline(temp, len);
+          return this->m_sso;
+        }
+
         // Reallocate the storage. The length is left intact.
-        ptr = this->m_sth.reallocate_more(this->data(), this->size(), 0);
+        ptr = this->m_sth.reallocate_more(this->data(), len, 0);
         this->m_ref.m_ptr = ptr;
         return ptr;
       }
@@ -1205,7 +1376,6 @@ class basic_cow_string
       { return this->m_sth.as_allocator();  }
 
     // searching functions
-    constexpr
     size_type
     find(size_type from, const basic_cow_string& other)
       const noexcept
@@ -1213,7 +1383,6 @@ class basic_cow_string
         return this->find(from, other.data(), other.size());
       }
 
-    constexpr
     size_type
     find(const basic_cow_string& other)
       const noexcept
@@ -1221,7 +1390,6 @@ class basic_cow_string
         return this->find(size_type(0), other);
       }
 
-    constexpr
     size_type
     find(size_type from, const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1229,7 +1397,6 @@ class basic_cow_string
         return this->find(from, other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     size_type
     find(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1237,7 +1404,6 @@ class basic_cow_string
         return this->find(size_type(0), other, pos, n);
       }
 
-    constexpr
     size_type
     find(size_type from, const value_type* s)
       const noexcept
@@ -1245,7 +1411,6 @@ class basic_cow_string
         return this->find(from, s, noadl::xstrlen(s));
       }
 
-    constexpr
     size_type
     find(const value_type* s)
       const noexcept
@@ -1253,7 +1418,6 @@ class basic_cow_string
         return this->find(size_type(0), s);
       }
 
-    constexpr
     size_type
     find(size_type from, const value_type* s, size_type n)
       const noexcept
@@ -1283,7 +1447,6 @@ class basic_cow_string
                         text_begin, text_end, pattern_begin, pattern_end, npos);
       }
 
-    constexpr
     size_type
     find(const value_type* s, size_type n)
       const noexcept
@@ -1291,7 +1454,6 @@ class basic_cow_string
         return this->find(size_type(0), s, n);
       }
 
-    constexpr
     size_type
     find(size_type from, value_type c)
       const noexcept
@@ -1299,7 +1461,6 @@ class basic_cow_string
         return this->find_of(from, c);
       }
 
-    constexpr
     size_type
     find(value_type c)
       const noexcept
@@ -1307,7 +1468,6 @@ class basic_cow_string
         return this->find(size_type(0), c);
       }
 
-    constexpr
     size_type
     rfind(size_type to, const basic_cow_string& other)
       const noexcept
@@ -1315,7 +1475,6 @@ class basic_cow_string
         return this->rfind(to, other.data(), other.size());
       }
 
-    constexpr
     size_type
     rfind(const basic_cow_string& other)
       const noexcept
@@ -1323,7 +1482,6 @@ class basic_cow_string
         return this->rfind(npos, other);
       }
 
-    constexpr
     size_type
     rfind(size_type to, const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1331,7 +1489,6 @@ class basic_cow_string
         return this->rfind(to, other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     size_type
     rfind(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1339,7 +1496,6 @@ class basic_cow_string
         return this->rfind(npos, other, pos, n);
       }
 
-    constexpr
     size_type
     rfind(size_type to, const value_type* s)
       const noexcept
@@ -1347,7 +1503,6 @@ class basic_cow_string
         return this->rfind(to, s, noadl::xstrlen(s));
       }
 
-    constexpr
     size_type
     rfind(const value_type* s)
       const noexcept
@@ -1355,7 +1510,6 @@ class basic_cow_string
         return this->rfind(npos, s);
       }
 
-    constexpr
     size_type
     rfind(size_type to, const value_type* s, size_type n)
       const noexcept
@@ -1383,7 +1537,6 @@ class basic_cow_string
                    text_rbegin, text_rend, pattern_rbegin, pattern_rend, d - npos));
       }
 
-    constexpr
     size_type
     rfind(const value_type* s, size_type n)
       const noexcept
@@ -1391,7 +1544,6 @@ class basic_cow_string
         return this->rfind(npos, s, n);
       }
 
-    constexpr
     size_type
     rfind(size_type to, value_type c)
       const noexcept
@@ -1399,7 +1551,6 @@ class basic_cow_string
         return this->rfind_of(to, c);
       }
 
-    constexpr
     size_type
     rfind(value_type c)
       const noexcept
@@ -1407,7 +1558,6 @@ class basic_cow_string
         return this->rfind(npos, c);
       }
 
-    constexpr
     size_type
     find_of(size_type from, const basic_cow_string& other)
       const noexcept
@@ -1415,7 +1565,6 @@ class basic_cow_string
         return this->find_of(from, other.data(), other.size());
       }
 
-    constexpr
     size_type
     find_of(const basic_cow_string& other)
       const noexcept
@@ -1423,7 +1572,6 @@ class basic_cow_string
         return this->find_of(size_type(0), other);
       }
 
-    constexpr
     size_type
     find_of(size_type from, const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1431,7 +1579,6 @@ class basic_cow_string
         return this->find_of(from, other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     size_type
     find_of(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1439,7 +1586,6 @@ class basic_cow_string
         return this->find_of(size_type(0), other, pos, n);
       }
 
-    constexpr
     size_type
     find_of(size_type from, const value_type* s)
       const noexcept
@@ -1447,7 +1593,6 @@ class basic_cow_string
         return this->find_of(from, s, noadl::xstrlen(s));
       }
 
-    constexpr
     size_type
     find_of(const value_type* s)
       const noexcept
@@ -1455,7 +1600,6 @@ class basic_cow_string
         return this->find_of(size_type(0), s);
       }
 
-    constexpr
     size_type
     find_of(size_type from, const value_type* s, size_type n)
       const noexcept
@@ -1489,7 +1633,6 @@ class basic_cow_string
         }
       }
 
-    constexpr
     size_type
     find_of(const value_type* s, size_type n)
       const noexcept
@@ -1497,7 +1640,6 @@ class basic_cow_string
         return this->find_of(size_type(0), s, n);
       }
 
-    constexpr
     size_type
     find_of(size_type from, value_type c)
       const noexcept
@@ -1514,7 +1656,6 @@ class basic_cow_string
         return cur;
       }
 
-    constexpr
     size_type
     find_of(value_type c)
       const noexcept
@@ -1522,7 +1663,6 @@ class basic_cow_string
         return this->find_of(size_type(0), c);
       }
 
-    constexpr
     size_type
     rfind_of(size_type to, const basic_cow_string& other)
       const noexcept
@@ -1530,7 +1670,6 @@ class basic_cow_string
         return this->rfind_of(to, other.data(), other.size());
       }
 
-    constexpr
     size_type
     rfind_of(const basic_cow_string& other)
       const noexcept
@@ -1538,7 +1677,6 @@ class basic_cow_string
         return this->rfind_of(npos, other);
       }
 
-    constexpr
     size_type
     rfind_of(size_type to, const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1546,7 +1684,6 @@ class basic_cow_string
         return this->rfind_of(to, other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     size_type
     rfind_of(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1554,7 +1691,6 @@ class basic_cow_string
         return this->rfind_of(npos, other, pos, n);
       }
 
-    constexpr
     size_type
     rfind_of(size_type to, const value_type* s)
       const noexcept
@@ -1562,7 +1698,6 @@ class basic_cow_string
         return this->rfind_of(to, s, noadl::xstrlen(s));
       }
 
-    constexpr
     size_type
     rfind_of(const value_type* s)
       const noexcept
@@ -1570,7 +1705,6 @@ class basic_cow_string
         return this->rfind_of(npos, s);
       }
 
-    constexpr
     size_type
     rfind_of(size_type to, const value_type* s, size_type n)
       const noexcept
@@ -1604,7 +1738,6 @@ class basic_cow_string
         }
       }
 
-    constexpr
     size_type
     rfind_of(const value_type* s, size_type n)
       const noexcept
@@ -1612,7 +1745,6 @@ class basic_cow_string
         return this->rfind_of(npos, s, n);
       }
 
-    constexpr
     size_type
     rfind_of(size_type to, value_type c)
       const noexcept
@@ -1627,7 +1759,6 @@ class basic_cow_string
         return npos;
       }
 
-    constexpr
     size_type
     rfind_of(value_type c)
       const noexcept
@@ -1635,7 +1766,6 @@ class basic_cow_string
         return this->rfind_of(npos, c);
       }
 
-    constexpr
     size_type
     find_not_of(size_type from, const basic_cow_string& other)
       const noexcept
@@ -1643,7 +1773,6 @@ class basic_cow_string
         return this->find_not_of(from, other.data(), other.size());
       }
 
-    constexpr
     size_type
     find_not_of(const basic_cow_string& other)
       const noexcept
@@ -1651,7 +1780,6 @@ class basic_cow_string
         return this->find_not_of(size_type(0), other);
       }
 
-    constexpr
     size_type
     find_not_of(size_type from, const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1659,7 +1787,6 @@ class basic_cow_string
         return this->find_not_of(from, other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     size_type
     find_not_of(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1667,7 +1794,6 @@ class basic_cow_string
         return this->find_not_of(size_type(0), other, pos, n);
       }
 
-    constexpr
     size_type
     find_not_of(size_type from, const value_type* s)
       const noexcept
@@ -1675,7 +1801,6 @@ class basic_cow_string
         return this->find_not_of(from, s, noadl::xstrlen(s));
       }
 
-    constexpr
     size_type
     find_not_of(const value_type* s)
       const noexcept
@@ -1683,7 +1808,6 @@ class basic_cow_string
         return this->find_not_of(size_type(0), s);
       }
 
-    constexpr
     size_type
     find_not_of(size_type from, const value_type* s, size_type n)
       const noexcept
@@ -1717,7 +1841,6 @@ class basic_cow_string
         }
       }
 
-    constexpr
     size_type
     find_not_of(const value_type* s, size_type n)
       const noexcept
@@ -1725,7 +1848,6 @@ class basic_cow_string
         return this->find_not_of(size_type(0), s, n);
       }
 
-    constexpr
     size_type
     find_not_of(size_type from, value_type c)
       const noexcept
@@ -1740,7 +1862,6 @@ class basic_cow_string
         return npos;
       }
 
-    constexpr
     size_type
     find_not_of(value_type c)
       const noexcept
@@ -1748,7 +1869,6 @@ class basic_cow_string
         return this->find_not_of(size_type(0), c);
       }
 
-    constexpr
     size_type
     rfind_not_of(size_type to, const basic_cow_string& other)
       const noexcept
@@ -1756,7 +1876,6 @@ class basic_cow_string
         return this->rfind_not_of(to, other.data(), other.size());
       }
 
-    constexpr
     size_type
     rfind_not_of(const basic_cow_string& other)
       const noexcept
@@ -1764,7 +1883,6 @@ class basic_cow_string
         return this->rfind_not_of(npos, other);
       }
 
-    constexpr
     size_type
     rfind_not_of(size_type to, const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1772,7 +1890,6 @@ class basic_cow_string
         return this->rfind_not_of(to, other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     size_type
     rfind_not_of(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1780,7 +1897,6 @@ class basic_cow_string
         return this->rfind_not_of(npos, other, pos, n);
       }
 
-    constexpr
     size_type
     rfind_not_of(size_type to, const value_type* s)
       const noexcept
@@ -1788,7 +1904,6 @@ class basic_cow_string
         return this->rfind_not_of(to, s, noadl::xstrlen(s));
       }
 
-    constexpr
     size_type
     rfind_not_of(const value_type* s)
       const noexcept
@@ -1796,7 +1911,6 @@ class basic_cow_string
         return this->rfind_not_of(npos, s);
       }
 
-    constexpr
     size_type
     rfind_not_of(size_type to, const value_type* s, size_type n)
       const noexcept
@@ -1830,7 +1944,6 @@ class basic_cow_string
         }
       }
 
-    constexpr
     size_type
     rfind_not_of(const value_type* s, size_type n)
       const noexcept
@@ -1838,7 +1951,6 @@ class basic_cow_string
         return this->rfind_not_of(npos, s, n);
       }
 
-    constexpr
     size_type
     rfind_not_of(size_type to, value_type c)
       const noexcept
@@ -1853,7 +1965,6 @@ class basic_cow_string
         return npos;
       }
 
-    constexpr
     size_type
     rfind_not_of(value_type c)
       const noexcept
@@ -1861,7 +1972,6 @@ class basic_cow_string
         return this->rfind_not_of(npos, c);
       }
 
-    constexpr
     bool
     equals(const basic_cow_string& other)
       const noexcept
@@ -1869,7 +1979,6 @@ class basic_cow_string
         return this->equals(other.data(), other.size());
       }
 
-    constexpr
     bool
     equals(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1877,7 +1986,6 @@ class basic_cow_string
         return this->equals(other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     bool
     equals(const value_type* s)
       const noexcept
@@ -1885,7 +1993,6 @@ class basic_cow_string
         return this->equals(s, noadl::xstrlen(s));
       }
 
-    constexpr
     bool
     equals(const value_type* s, size_type n)
       const noexcept
@@ -1894,7 +2001,6 @@ class basic_cow_string
                && ((this->data() == s) || (noadl::xmemcmp(this->data(), s, n) == 0));
       }
 
-    constexpr
     bool
     substr_equals(size_type tpos, size_type tn, const basic_cow_string& other, size_type pos = 0, size_type n = npos)
       const
@@ -1902,7 +2008,6 @@ class basic_cow_string
         return this->substr_equals(tpos, tn, other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     bool
     substr_equals(size_type tpos, const basic_cow_string& other, size_type pos = 0, size_type n = npos)
       const
@@ -1910,7 +2015,6 @@ class basic_cow_string
         return this->substr_equals(tpos, npos, other, pos, n);
       }
 
-    constexpr
     bool
     substr_equals(size_type tpos, size_type tn, const value_type* s)
       const
@@ -1918,7 +2022,6 @@ class basic_cow_string
         return this->substr_equals(tpos, tn, s, noadl::xstrlen(s));
       }
 
-    constexpr
     bool
     substr_equals(size_type tpos, const value_type* s)
       const
@@ -1926,7 +2029,6 @@ class basic_cow_string
         return this->substr_equals(tpos, npos, s);
       }
 
-    constexpr
     bool
     substr_equals(size_type tpos, size_type tn, const value_type* s, size_type n)
       const
@@ -1935,7 +2037,6 @@ class basic_cow_string
                && (noadl::xmemcmp(this->data() + tpos, s, n) == 0);
       }
 
-    constexpr
     bool
     substr_equals(size_type tpos, const value_type* s, size_type n)
       const
@@ -1943,7 +2044,6 @@ class basic_cow_string
         return this->substr_equals(tpos, npos, s, n);
       }
 
-    constexpr
     int
     compare(const basic_cow_string& other)
       const noexcept
@@ -1951,7 +2051,6 @@ class basic_cow_string
         return this->compare(other.data(), other.size());
       }
 
-    constexpr
     int
     compare(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -1959,7 +2058,6 @@ class basic_cow_string
         return this->compare(other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     int
     compare(const value_type* s)
       const noexcept
@@ -1967,7 +2065,6 @@ class basic_cow_string
         return this->compare(s, noadl::xstrlen(s));
       }
 
-    constexpr
     int
     compare(const value_type* s, size_type n)
       const noexcept
@@ -1975,7 +2072,6 @@ class basic_cow_string
         return noadl::xmemcmp(this->data(), this->size(), s, n);
       }
 
-    constexpr
     int
     substr_compare(size_type tpos, size_type tn, const basic_cow_string& other, size_type pos = 0, size_type n = npos)
       const
@@ -1983,7 +2079,6 @@ class basic_cow_string
         return this->substr_compare(tpos, tn, other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     int
     substr_compare(size_type tpos, const basic_cow_string& other, size_type pos = 0, size_type n = npos)
       const
@@ -1991,7 +2086,6 @@ class basic_cow_string
         return this->substr_compare(tpos, npos, other, pos, n);
       }
 
-    constexpr
     int
     substr_compare(size_type tpos, size_type tn, const value_type* s)
       const
@@ -1999,7 +2093,6 @@ class basic_cow_string
         return this->substr_compare(tpos, tn, s, noadl::xstrlen(s));
       }
 
-    constexpr
     int
     substr_compare(size_type tpos, const value_type* s)
       const
@@ -2007,7 +2100,6 @@ class basic_cow_string
         return this->substr_compare(tpos, npos, s);
       }
 
-    constexpr
     int
     substr_compare(size_type tpos, size_type tn, const value_type* s, size_type n)
       const
@@ -2015,7 +2107,6 @@ class basic_cow_string
         return noadl::xmemcmp(this->data() + tpos, this->do_clamp_substr(tpos, tn), s, n);
       }
 
-    constexpr
     int
     substr_compare(size_type tpos, const value_type* s, size_type n)
       const
@@ -2024,7 +2115,6 @@ class basic_cow_string
       }
 
     // N.B. These are extensions but might be standardized in C++20.
-    constexpr
     bool
     starts_with(const basic_cow_string& other)
       const noexcept
@@ -2032,7 +2122,6 @@ class basic_cow_string
         return this->starts_with(other.data(), other.size());
       }
 
-    constexpr
     bool
     starts_with(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -2040,7 +2129,6 @@ class basic_cow_string
         return this->starts_with(other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     bool
     starts_with(const value_type* s)
       const noexcept
@@ -2048,7 +2136,6 @@ class basic_cow_string
         return this->starts_with(s, noadl::xstrlen(s));
       }
 
-    constexpr
     bool
     starts_with(const value_type* s, size_type n)
       const noexcept
@@ -2057,7 +2144,6 @@ class basic_cow_string
                && (noadl::xmemcmp(this->data(), s, n) == 0);
       }
 
-    constexpr
     bool
     ends_with(const basic_cow_string& other)
       const noexcept
@@ -2065,7 +2151,6 @@ class basic_cow_string
         return this->ends_with(other.data(), other.size());
       }
 
-    constexpr
     bool
     ends_with(const basic_cow_string& other, size_type pos, size_type n = npos)
       const
@@ -2073,7 +2158,6 @@ class basic_cow_string
         return this->ends_with(other.data() + pos, other.do_clamp_substr(pos, n));
       }
 
-    constexpr
     bool
     ends_with(const value_type* s)
       const noexcept
@@ -2081,7 +2165,6 @@ class basic_cow_string
         return this->ends_with(s, noadl::xstrlen(s));
       }
 
-    constexpr
     bool
     ends_with(const value_type* s, size_type n)
       const noexcept
@@ -2125,7 +2208,7 @@ struct basic_cow_string<charT, allocT>::hasher
     uint32_t
     operator()(const basic_cow_string& str)
       const noexcept
-      { return (*this) (str.m_ref.m_ptr, str.m_ref.m_len);  }
+      { return (*this) (str.data(), str.size());  }
   };
 
 template<typename charT, typename allocT>
@@ -2287,210 +2370,180 @@ operator+(charT lhs, basic_cow_string<charT, allocT>&& rhs)
   }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator==(const basic_cow_string<charT, allocT>& lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return lhs.equals(rhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator==(const basic_cow_string<charT, allocT>& lhs, basic_shallow_string<ASTERIA_UNDEDUCED(charT)> rhs)
   noexcept
   { return lhs.equals(rhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator==(const basic_cow_string<charT, allocT>& lhs, const charT* rhs)
   noexcept
   { return lhs.equals(rhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator==(basic_shallow_string<ASTERIA_UNDEDUCED(charT)> lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.equals(lhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator==(const charT* lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.equals(lhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator!=(const basic_cow_string<charT, allocT>& lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return not lhs.equals(rhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator!=(const basic_cow_string<charT, allocT>& lhs, basic_shallow_string<ASTERIA_UNDEDUCED(charT)> rhs)
   noexcept
   { return not lhs.equals(rhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator!=(const basic_cow_string<charT, allocT>& lhs, const charT* rhs)
   noexcept
   { return not lhs.equals(rhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator!=(basic_shallow_string<ASTERIA_UNDEDUCED(charT)> lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return not rhs.equals(lhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator!=(const charT* lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return not rhs.equals(lhs);  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<(const basic_cow_string<charT, allocT>& lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return lhs.compare(rhs) < 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<(const basic_cow_string<charT, allocT>& lhs, basic_shallow_string<ASTERIA_UNDEDUCED(charT)> rhs)
   noexcept
   { return lhs.compare(rhs) < 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<(const basic_cow_string<charT, allocT>& lhs, const charT* rhs)
   noexcept
   { return lhs.compare(rhs) < 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<(basic_shallow_string<ASTERIA_UNDEDUCED(charT)> lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.compare(lhs) > 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<(const charT* lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.compare(lhs) > 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<=(const basic_cow_string<charT, allocT>& lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return lhs.compare(rhs) <= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<=(const basic_cow_string<charT, allocT>& lhs, basic_shallow_string<ASTERIA_UNDEDUCED(charT)> rhs)
   noexcept
   { return lhs.compare(rhs) <= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<=(const basic_cow_string<charT, allocT>& lhs, const charT* rhs)
   noexcept
   { return lhs.compare(rhs) <= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<=(basic_shallow_string<ASTERIA_UNDEDUCED(charT)> lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.compare(lhs) >= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator<=(const charT* lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.compare(lhs) >= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>(const basic_cow_string<charT, allocT>& lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return lhs.compare(rhs) > 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>(const basic_cow_string<charT, allocT>& lhs, basic_shallow_string<ASTERIA_UNDEDUCED(charT)> rhs)
   noexcept
   { return lhs.compare(rhs) > 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>(const basic_cow_string<charT, allocT>& lhs, const charT* rhs)
   noexcept
   { return lhs.compare(rhs) > 0; }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>(basic_shallow_string<ASTERIA_UNDEDUCED(charT)> lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.compare(lhs) < 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>(const charT* lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.compare(lhs) < 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>=(const basic_cow_string<charT, allocT>& lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return lhs.compare(rhs) >= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>=(const basic_cow_string<charT, allocT>& lhs, basic_shallow_string<ASTERIA_UNDEDUCED(charT)> rhs)
   noexcept
   { return lhs.compare(rhs) >= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>=(const basic_cow_string<charT, allocT>& lhs, const charT* rhs)
   noexcept
   { return lhs.compare(rhs) >= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>=(basic_shallow_string<ASTERIA_UNDEDUCED(charT)> lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
   { return rhs.compare(lhs) <= 0;  }
 
 template<typename charT, typename allocT>
-constexpr
 bool
 operator>=(const charT* lhs, const basic_cow_string<charT, allocT>& rhs)
   noexcept
@@ -82,7 +82,12 @@ class storage_handle
     using storage_allocator = typename allocator_traits<allocator_type>::template rebind_alloc<storage>;
     using storage_pointer   = typename allocator_traits<storage_allocator>::pointer;
 
+    static_assert(is_pointer<storage_pointer>::value, "fancy pointers not supported");
+
   private:
+    // If the string is stored inline, this is not a pointer, but its length
+    // shifted left by one bit, with the lowest bit set. Storage is aligned, so
+    // this never equals a valid pointer.
     storage_pointer m_qstor = nullptr;
 
   public:
@@ -117,6 +122,22 @@ class storage_handle
     storage_handle& operator=(const storage_handle&) = delete;
 
   private:
+    static
+    bool
+    do_is_inline(storage_pointer qstor)
+      noexcept
+      { return reinterpret_cast<uintptr_t>(qstor) & 1;  }
+
+    storage_pointer
+    do_get_storage_opt()
+      const noexcept
+      {
+        auto qstor = this->m_qstor;
+        if(do_is_inline(qstor))
+          return nullptr;
+        return qstor;
+      }
+
 #ifdef __cpp_constexpr_dynamic_alloc
     constexpr
 #endif
@@ -130,7 +151,7 @@ class storage_handle
           return;
 
         auto qstor = noadl::exchange(this->m_qstor, qstor_new);
-        if((qstor != nullptr) && (qstor->nref.decrement() == 0))
+        if((qstor != nullptr) && !do_is_inline(qstor) && (qstor->nref.decrement() == 0))
           this->do_destroy_storage(qstor);
       }
 
@@ -157,14 +178,34 @@ class storage_handle
       noexcept
       { return static_cast<allocator_base&>(*this);  }
 
+    bool
+    is_inline()
+      const noexcept
+      { return do_is_inline(this->m_qstor);  }
+
+    size_type
+    inline_size()
+      const noexcept
+      {
+        ASTERIA_ASSERT(this->is_inline());
+        return static_cast<size_type>(reinterpret_cast<uintptr_t>(this->m_qstor) >> 1);
+      }
+
+    void
+    set_inline_size(size_type len)
+      noexcept
+      {
+        this->do_reset(reinterpret_cast<storage_pointer>(static_cast<uintptr_t>(len) << 1 | 1));
+      }
+
     ASTERIA_PURE
     bool
     unique()
       const noexcept
       {
-        auto qstor = this->m_qstor;
+        auto qstor = this->do_get_storage_opt();
         if(!qstor)
-          return false;
+          return this->is_inline();
         return qstor->nref.unique();
       }
 
@@ -172,9 +213,9 @@ class storage_handle
     use_count()
       const noexcept
       {
-        auto qstor = this->m_qstor;
+        auto qstor = this->do_get_storage_opt();
         if(!qstor)
-          return 0;
+          return this->is_inline();
         return qstor->nref.get();
       }
 
@@ -183,7 +224,7 @@ class storage_handle
     capacity()
       const noexcept
       {
-        auto qstor = this->m_qstor;
+        auto qstor = this->do_get_storage_opt();
         if(!qstor)
           return 0;
         return storage::max_nchar_for_nblk(qstor->nblk);
@@ -226,7 +267,7 @@ class storage_handle
     data_opt()
       const noexcept
       {
-        auto qstor = this->m_qstor;
+        auto qstor = this->do_get_storage_opt();
         if(!qstor)
           return nullptr;
         return qstor->data;
@@ -236,7 +277,7 @@ class storage_handle
     mut_data_opt()
       noexcept
       {
-        auto qstor = this->m_qstor;
+        auto qstor = this->do_get_storage_opt();
         if(!qstor)
           return nullptr;
         if(!qstor->nref.unique())
@@ -284,7 +325,7 @@ class storage_handle
       noexcept
       {
         auto qstor = other.m_qstor;
-        if(qstor)
+        if(qstor && !do_is_inline(qstor))
           qstor->nref.increment();
         this->do_reset(qstor);
       }
@@ -160,9 +160,11 @@ class basic_prehashed_string
       noexcept(noexcept(declval<const key_equal&>()(
             declval<const string_type&>(), declval<const string_type&>())))
       {
+        // Interned strings share storage, so they can be compared by address.
         return (this->m_sth.str().size() == other.m_sth.str().size())
-               && (this->m_sth.hval() == other.m_sth.hval())
-               && this->m_sth.as_key_equal() (this->m_sth.str(), other.m_sth.str());
+               && ((this->m_sth.str().data() == other.m_sth.str().data())
+                   || ((this->m_sth.hval() == other.m_sth.hval())
+                       && this->m_sth.as_key_equal() (this->m_sth.str(), other.m_sth.str())));
       }
 
     template<typename otherT>
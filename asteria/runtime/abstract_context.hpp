@@ -17,6 +17,10 @@ class Abstract_Context
     // this context.
     mutable Reference_Dictionary m_named_refs;
 
+    // This stores local references whose slots have been assigned at compile
+    // time. They can be accessed by index without hashing.
+    cow_bivector<phcow_string, Reference> m_slotted_refs;
+
   protected:
     Abstract_Context()
       noexcept = default;
@@ -47,11 +51,35 @@ class Abstract_Context
         return hint_opt ? *hint_opt : this->m_named_refs.insert(name, nullptr);
       }
 
+    // These allow storage of references to be reused.
+    Reference_Dictionary&
+    do_mut_named_reference_storage()
+      noexcept
+      { return this->m_named_refs;  }
+
+    cow_bivector<phcow_string, Reference>&
+    do_mut_slotted_reference_storage()
+      noexcept
+      { return this->m_slotted_refs;  }
+
     void
     do_clear_named_references()
       noexcept
       {
         this->m_named_refs.clear();
+        this->m_slotted_refs.clear();
+      }
+
+    // Slotted references can also be found by name, which is slow but should
+    // be rare.
+    uint32_t
+    do_find_slot(const phcow_string& name)
+      const noexcept
+      {
+        for(uint32_t k = 0;  k != this->m_slotted_refs.size();  ++k)
+          if(this->m_slotted_refs[k].first == name)
+            return k;
+        return UINT32_MAX;
       }
 
   public:
@@ -70,6 +98,12 @@ class Abstract_Context
       const
       {
         auto qref = this->m_named_refs.find_opt(name);
+        if(!qref && !this->m_slotted_refs.empty()) {
+          uint32_t slot = this->do_find_slot(name);
+          if(slot != UINT32_MAX)
+            qref = &(this->m_slotted_refs[slot].second);
+        }
+
         if(!qref && name.rdstr().starts_with("__")) {
           // Create a lazy reference. Built-in references such as `__func`
           // are only created when they are mentioned.
@@ -82,6 +116,12 @@ class Abstract_Context
     mut_named_reference_opt(const phcow_string& name)
       {
         auto qref = this->m_named_refs.mut_find_opt(name);
+        if(!qref && !this->m_slotted_refs.empty()) {
+          uint32_t slot = this->do_find_slot(name);
+          if(slot != UINT32_MAX)
+            qref = &(this->m_slotted_refs.mut(slot).second);
+        }
+
         if(!qref && name.rdstr().starts_with("__")) {
           // Create a lazy reference. Built-in references such as `__func`
           // are only created when they are mentioned.
@@ -105,12 +145,44 @@ class Abstract_Context
         return ref;
       }
 
+    const Reference*
+    get_slotted_reference_opt(uint32_t slot)
+      const noexcept
+      {
+        if(slot >= this->m_slotted_refs.size())
+          return nullptr;
+        return &(this->m_slotted_refs[slot].second);
+      }
+
+    Reference*
+    mut_slotted_reference_opt(uint32_t slot)
+      {
+        if(slot >= this->m_slotted_refs.size())
+          return nullptr;
+        return &(this->m_slotted_refs.mut(slot).second);
+      }
+
+    Reference&
+    insert_slotted_reference(uint32_t slot, const phcow_string& name)
+      {
+        if(slot >= this->m_slotted_refs.size())
+          this->m_slotted_refs.append(slot + 1 - this->m_slotted_refs.size());
+
+        auto& r = this->m_slotted_refs.mut(slot);
+        r.first = name;
+        return r.second;
+      }
+
     bool
     erase_named_reference(const phcow_string& name, Reference* refp_opt)
       noexcept
       {
         return this->m_named_refs.erase(name, refp_opt);
       }
+
+    void
+    collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+      const;
   };
 
 }  // namespace asteria
@@ -11,6 +11,16 @@ struct Abstract_Hooks
   :
     public rcfwd<Abstract_Hooks>
   {
+    // This returns a bitwise OR of `Hook_Mask` values, which denote hooks that
+    // shall be called. Hooks that are not enabled cost a single load and a
+    // branch. The result is copied by `Global_Context::set_hooks()`, so if it
+    // changes later, `Global_Context::refresh_hook_mask()` must be called. The
+    // default implementation enables all hooks.
+    virtual
+    uint32_t
+    get_hook_mask()
+      const noexcept;
+
     // This hook is called before every statement, expression, iteration of a loop,
     // etc. Be advised that traps require code generation support, which must be
     // enabled by setting `verbose_single_step_traps` in `Compiler_Options` before
@@ -19,6 +29,14 @@ struct Abstract_Hooks
     void
     on_trap(const Source_Location& sloc, Executive_Context& ctx);
 
+    // This hook is called at a safepoint after `request_interrupt()` has been
+    // called on the global context. Safepoints are iterations of loops and
+    // entries of functions. The default implementation throws an exception,
+    // which stops the script; an overriding function may return to resume.
+    virtual
+    void
+    on_interrupt(Executive_Context& ctx);
+
     // This hook is called after a variable or function is declared, and before
     // its initializer is evaluated.
     virtual
@@ -59,6 +77,55 @@ struct Abstract_Hooks
     virtual
     void
     on_function_leave(const Instantiated_Function& func, Executive_Context& fctx);
+
+    // These map a hook to its `Hook_Mask` value, so `Global_Context::call_hook()`
+    // can check it without a virtual call. Hooks are told apart by signature,
+    // except `on_function_enter()` and `on_function_leave()`. As they are called
+    // with constant arguments, the result is known at compile time.
+    static
+    uint32_t
+    hook_mask_of(void (Abstract_Hooks::*)(const Source_Location&, Executive_Context&))
+      noexcept
+      { return hook_mask_trap;  }
+
+    static
+    uint32_t
+    hook_mask_of(void (Abstract_Hooks::*)(Executive_Context&))
+      noexcept
+      { return hook_mask_interrupt;  }
+
+    static
+    uint32_t
+    hook_mask_of(void (Abstract_Hooks::*)(const Source_Location&, const phcow_string&))
+      noexcept
+      { return hook_mask_declare;  }
+
+    static
+    uint32_t
+    hook_mask_of(void (Abstract_Hooks::*)(const Source_Location&, const cow_function&))
+      noexcept
+      { return hook_mask_call;  }
+
+    static
+    uint32_t
+    hook_mask_of(void (Abstract_Hooks::*)(const Source_Location&, PTC_Aware))
+      noexcept
+      { return hook_mask_return;  }
+
+    static
+    uint32_t
+    hook_mask_of(void (Abstract_Hooks::*)(const Source_Location&, Value&))
+      noexcept
+      { return hook_mask_throw;  }
+
+    static
+    uint32_t
+    hook_mask_of(void (Abstract_Hooks::* mfn)(const Instantiated_Function&, Executive_Context&))
+      noexcept
+      {
+        return (mfn == &Abstract_Hooks::on_function_enter) ? hook_mask_function_enter
+                                                           : hook_mask_function_leave;
+      }
   };
 
 }  // namespace asteria
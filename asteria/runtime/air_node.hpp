@@ -26,6 +26,8 @@ class AIR_Node
       {
         Source_Location sloc;
         phcow_string name;
+        uint32_t slot;
+        bool untracked;  // not managed by the garbage collector
       };
 
     struct S_initialize_variable
@@ -39,6 +41,8 @@ class AIR_Node
         bool negative;
         cow_vector<AIR_Node> code_true;
         cow_vector<AIR_Node> code_false;
+        bool scopeless_true;  // declares no names; executed in the enclosing scope
+        bool scopeless_false;
       };
 
     struct switch_clause
@@ -54,11 +58,13 @@ class AIR_Node
     struct S_switch_statement
       {
         cow_vector<switch_clause> clauses;
+        bool scopeless;  // no clause declares names; executed in the enclosing scope
       };
 
     struct S_do_while_statement
       {
         cow_vector<AIR_Node> code_body;
+        bool scopeless_body;
         bool negative;
         cow_vector<AIR_Node> code_cond;
         cow_vector<AIR_Node> code_complete;
@@ -69,6 +75,7 @@ class AIR_Node
         bool negative;
         cow_vector<AIR_Node> code_cond;
         cow_vector<AIR_Node> code_body;
+        bool scopeless_body;
         cow_vector<AIR_Node> code_complete;
       };
 
@@ -79,6 +86,7 @@ class AIR_Node
         Source_Location sloc_init;
         cow_vector<AIR_Node> code_init;
         cow_vector<AIR_Node> code_body;
+        bool scopeless_body;
         cow_vector<AIR_Node> code_complete;
       };
 
@@ -88,6 +96,7 @@ class AIR_Node
         cow_vector<AIR_Node> code_cond;
         cow_vector<AIR_Node> code_step;
         cow_vector<AIR_Node> code_body;
+        bool scopeless_body;
         cow_vector<AIR_Node> code_complete;
       };
 
@@ -133,6 +142,7 @@ class AIR_Node
         Source_Location sloc;
         uint16_t depth;
         phcow_string name;
+        uint32_t slot;  // `UINT32_MAX` if not slotted
       };
 
     struct S_push_bound_reference
@@ -146,6 +156,7 @@ class AIR_Node
         Source_Location sloc;
         cow_string func;
         cow_vector<phcow_string> params;
+        bool generator;
         cow_vector<AIR_Node> code_body;
       };
 
@@ -202,6 +213,8 @@ class AIR_Node
         Source_Location sloc;
         bool immutable;
         phcow_string name;
+        uint32_t slot;
+        bool untracked;  // not managed by the garbage collector
       };
 
     struct S_single_step_trap
@@ -231,12 +244,14 @@ class AIR_Node
     struct S_declare_reference
       {
         phcow_string name;
+        uint32_t slot;
       };
 
     struct S_initialize_reference
       {
         Source_Location sloc;
         phcow_string name;
+        uint32_t slot;
       };
 
     struct S_catch_expression
@@ -300,6 +315,62 @@ class AIR_Node
         bool negative;
       };
 
+    struct S_push_captured_reference
+      {
+        Source_Location sloc;
+        uint16_t depth;  // to the function context
+        uint32_t index;
+      };
+
+    struct S_apply_operator_local_bi32
+      {
+        Source_Location sloc;
+        uint16_t depth;
+        phcow_string name;
+        uint32_t slot;
+        Xop xop;
+        bool assign;
+        int32_t irhs;
+      };
+
+    struct S_branch_compare_bi32
+      {
+        Source_Location sloc;
+        Xop xop;
+        int32_t irhs;
+        cow_vector<AIR_Node> code_true;
+        cow_vector<AIR_Node> code_false;
+      };
+
+    struct S_push_global_member
+      {
+        Source_Location sloc;
+        phcow_string name;
+        cow_vector<phcow_string> keys;
+      };
+
+    struct S_counted_for_statement
+      {
+        cow_vector<AIR_Node> code_init;
+        int64_t count;
+        cow_vector<AIR_Node> code_body;
+        bool scopeless_body;
+        cow_vector<AIR_Node> code_complete;
+      };
+
+    struct S_inline_call
+      {
+        Source_Location sloc;
+        Source_Location sloc_func;  // where the callee was defined
+        cow_string func;
+        cow_vector<AIR_Node> code_body;
+      };
+
+    struct S_yield_statement
+      {
+        Source_Location sloc;
+      };
+
     enum Index : uint8_t
       {
         index_clear_stack            =  0,
@@ -345,6 +416,13 @@ class AIR_Node
         index_apply_operator_bi32    = 40,
         index_return_statement_bi32  = 41,
         index_check_null             = 42,
+        index_push_captured_reference = 43,
+        index_apply_operator_local_bi32 = 44,
+        index_branch_compare_bi32     = 45,
+        index_push_global_member      = 46,
+        index_counted_for_statement   = 47,
+        index_inline_call             = 48,
+        index_yield_statement         = 49,
       };
 
   private:
@@ -393,6 +471,13 @@ class AIR_Node
         , S_apply_operator_bi32    // 40,
         , S_return_statement_bi32  // 41,
         , S_check_null             // 42,
+        , S_push_captured_reference  // 43,
+        , S_apply_operator_local_bi32  // 44,
+        , S_branch_compare_bi32    // 45,
+        , S_push_global_member     // 46,
+        , S_counted_for_statement  // 47,
+        , S_inline_call            // 48,
+        , S_yield_statement        // 49,
       );
 
   public:
@@ -423,6 +508,30 @@ class AIR_Node
         return *this;
       }
 
+  public:
+    // Gets the name of a kind of node, for diagnostic purposes.
+    static
+    const char*
+    describe_index(Index index)
+      noexcept;
+
+    // These are accessors of the node itself, for use by the optimizer.
+    Index
+    index()
+      const noexcept
+      { return static_cast<Index>(this->m_stor.index());  }
+
+    template<typename xNode>
+    const xNode&
+    as()
+      const
+      { return this->m_stor.as<xNode>();  }
+
+    template<typename xNode>
+    xNode&
+    mut()
+      { return this->m_stor.mut<xNode>();  }
+
   public:
     // Gets the constant value, if any.
     opt<Value>
@@ -441,6 +550,15 @@ class AIR_Node
     rebind_opt(const Abstract_Context& ctx)
       const;
 
+    // If this node denotes a local reference outside the function being defined,
+    // replace it with a reference to be captured when the function is created,
+    // and append the original node to `captures`, with its depth adjusted so it
+    // can be rebound in the context where the function is defined. `level` is the
+    // number of scopes between this node and the body of the function.
+    opt<AIR_Node>
+    capture_opt(cow_vector<AIR_Node>& captures, uint32_t level)
+      const;
+
     // This is necessary because the body of a closure shall not have been
     // solidified.
     void
@@ -13,6 +13,7 @@ class AIR_Optimizer
     Compiler_Options m_opts;
     cow_vector<phcow_string> m_params;
     cow_vector<AIR_Node> m_code;
+    bool m_generator = false;
 
   public:
     explicit constexpr
@@ -59,6 +60,13 @@ class AIR_Optimizer
       noexcept
       { return this->m_code;  }
 
+    // A function whose body contains `yield` is a generator. This is decided
+    // before optimization, so it doesn't depend on the optimization level.
+    bool
+    is_generator()
+      const noexcept
+      { return this->m_generator;  }
+
     void
     clear()
       noexcept;
@@ -73,7 +81,20 @@ class AIR_Optimizer
     // `ctx_opt` is the parent context of this closure.
     void
     rebind(const Abstract_Context* ctx_opt, const cow_vector<phcow_string>& params,
-           const cow_vector<AIR_Node>& code);
+           bool generator, const cow_vector<AIR_Node>& code);
+
+    // Count pairs of adjacent nodes, including those in nested blocks and
+    // closures. Keys are names of both nodes, separated by a space. This helps
+    // find sequences of nodes that are worth fusing.
+    void
+    count_node_pairs(cow_dictionary<uint64_t>& counts)
+      const;
+
+    // Create a function whose body has been solidified. If the code contains
+    // captured references, this is a prototype, from which closures can be
+    // created without solidifying the body again.
+    refcnt_ptr<const Instantiated_Function>
+    create_prototype(const Source_Location& sloc, const cow_string& name);
 
     // Create a closure value that can be assigned to a variable.
     cow_function
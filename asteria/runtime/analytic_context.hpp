@@ -14,6 +14,7 @@ class Analytic_Context
   {
   private:
     const Abstract_Context* m_parent_opt;
+    cow_dictionary<uint32_t> m_slots;
 
   public:
     // A plain context must have a parent context.
@@ -49,6 +50,18 @@ class Analytic_Context
     get_parent_opt()
       const noexcept
       { return this->m_parent_opt;  }
+
+    // Assigns a slot to a local reference, which will be stored in a flat
+    // array in the executive context. If the name has already been assigned a
+    // slot, the existing one is returned.
+    uint32_t
+    insert_slot(const phcow_string& name);
+
+    // Gets the slot of a local reference, or `UINT32_MAX` if it has not been
+    // assigned one.
+    uint32_t
+    find_slot(const phcow_string& name)
+      const noexcept;
   };
 
 }  // namespace asteria
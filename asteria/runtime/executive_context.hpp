@@ -26,6 +26,7 @@ class Executive_Context
     cow_bivector<Source_Location, AVM_Rod> m_defer;
     const Instantiated_Function* m_func = nullptr;
     cow_vector<Reference> m_lazy_args;
+    Reference_Stack* m_pooled_stack_opt = nullptr;  // returned to the pool
 
   public:
     // A plain context must have a parent context.
@@ -85,6 +86,11 @@ class Executive_Context
       const noexcept
       { return this->m_parent_opt;  }
 
+    const Instantiated_Function*
+    func_opt()
+      const noexcept
+      { return this->m_func;  }
+
     Global_Context&
     global()
       const noexcept
@@ -121,6 +127,16 @@ class Executive_Context
       noexcept
       { return this->m_defer;  }
 
+    // Discards all references and deferred expressions, so a plain context can
+    // be reused as if it was created anew. This shall be called after exiting.
+    void
+    reset_plain()
+      noexcept
+      {
+        this->do_clear_named_references();
+        this->m_defer.clear();
+      }
+
     // These functions must be called before exiting a scope.
     // Note that these functions may throw arbitrary exceptions, which
     // is why RAII is inapplicable.
@@ -137,6 +153,12 @@ class Executive_Context
         if(!this->m_defer.empty())
           this->do_on_scope_exit_exceptional_slow(except);
       }
+
+    // Collects variables in this context, but not those on its stacks, which
+    // are shared with other contexts of the same function.
+    void
+    collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+      const;
   };
 
 }  // namespace asteria
@@ -0,0 +1,92 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_GENERATOR_
+#define ASTERIA_RUNTIME_GENERATOR_
+
+#include "../fwd.hpp"
+#include "reference.hpp"
+#include "instantiated_function.hpp"
+#include "../llds/reference_stack.hpp"
+namespace asteria {
+
+// A generator is returned by a call to a function that contains `yield`. Its
+// body is executed on a stack segment of its own, so a suspended call keeps
+// its contexts and stacks until it is resumed or cancelled. A suspended call
+// is kept alive by the global context where it was started, which cancels it
+// when it is no longer referenced elsewhere, or before being destroyed. The
+// destructor never unwinds a function body.
+class Generator
+  :
+    public Abstract_Function
+  {
+  private:
+    struct Coroutine;
+
+    refcnt_ptr<const Instantiated_Function> m_func;
+    unique_ptr<Coroutine> m_co;
+
+  public:
+    Generator(const refcnt_ptr<const Instantiated_Function>& xfunc, Reference&& xself,
+              Reference_Stack&& xstack);
+
+  private:
+    void
+    do_finish(Global_Context& global)
+      const noexcept;
+
+    void
+    do_cancel()
+      const noexcept;
+
+  public:
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) & = delete;
+    ~Generator();
+
+    const Instantiated_Function&
+    function()
+      const noexcept
+      { return *(this->m_func);  }
+
+    // Checks whether the function body has completed, either normally or by
+    // an exception.
+    bool
+    finished()
+      const noexcept;
+
+    // Executes the function body until the next `yield` statement, and stores
+    // its value into `value`. If the function body completes, `false` is
+    // returned, and exceptions are propagated to the caller.
+    bool
+    resume(Value& value, Global_Context& global)
+      const;
+
+    // Unwinds the function body of a suspended generator, and discards its
+    // result. Deferred expressions are executed, but scripts can't catch the
+    // exception that unwinds it. The generator becomes finished.
+    void
+    cancel()
+      const noexcept;
+
+    // Suspends the generator that is being resumed, which is called by `yield`
+    // statements. `ctx` is the innermost context of the function body.
+    static
+    void
+    yield(const Executive_Context& ctx, Value&& value);
+
+    tinyfmt&
+    describe(tinyfmt& fmt)
+      const override;
+
+    void
+    collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+      const override;
+
+    void
+    invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stack)
+      const override;
+  };
+
+}  // namespace asteria
+#endif
@@ -6,6 +6,8 @@
 
 #include "../fwd.hpp"
 #include "abstract_context.hpp"
+#include "ptc_arguments.hpp"
+#include "../llds/reference_stack.hpp"
 #include "../recursion_sentry.hpp"
 namespace asteria {
 
@@ -16,15 +18,77 @@ class Global_Context
   private:
     Recursion_Sentry m_sentry;
     rcfwd_ptr<Abstract_Hooks> m_qhooks;
+    uint32_t m_hook_mask = hook_mask_none;
     rcfwd_ptr<Garbage_Collector> m_gcoll;
     rcfwd_ptr<Random_Engine> m_prng;
     rcfwd_ptr<Module_Loader> m_ldrlk;
 
+    // Storage of finished function calls, which is reused by new calls.
+    struct Frame_Storage
+      {
+        Reference_Dictionary named_refs;
+        cow_bivector<phcow_string, Reference> slotted_refs;
+        Reference_Stack alt_stack;
+      };
+
+    cow_vector<Frame_Storage> m_frame_pool;
+    size_t m_frame_hits = 0;
+    size_t m_frame_misses = 0;
+
+    // Arguments of finished proper tail calls, which are reused by new calls.
+    cow_vector<refcnt_ptr<PTC_Arguments>> m_ptc_pool;
+    size_t m_ptc_hits = 0;
+    size_t m_ptc_misses = 0;
+
+    // Requests that are checked at safepoints, which are iterations of loops
+    // and entries of functions. Only the flag word is read on the fast path.
+    static constexpr uint32_t safepoint_interrupt  = 0x0001;
+    static constexpr uint32_t safepoint_deadline   = 0x0002;
+    static constexpr uint32_t safepoint_fuel       = 0x0004;
+
+    atomic_relaxed<uint32_t> m_safepoint_flags;
+    int64_t m_deadline = 0;
+    uint32_t m_deadline_countdown = 0;
+    uint64_t m_fuel = 0;
+
+    // Stack segments for deep recursion. Segments that are not in use are
+    // kept for reuse.
+    cow_vector<void*> m_stack_pool;
+    uint32_t m_stack_segments = 0;
+    uint32_t m_max_stack_segments = 0;
+
+    // Generators that have been started but not finished, and stacks for them.
+    // A suspended generator is kept alive here, so it is never unwound by its
+    // destructor, or by the garbage collector.
+    cow_vector<refcnt_ptr<const Generator>> m_generators;
+    cow_vector<void*> m_generator_stack_pool;
+
+    // Pointers to global references that have been found by name. A pointer
+    // remains valid as long as the generation hasn't changed, which happens
+    // whenever a global reference is inserted or erased.
+    struct Global_Cache_Entry
+      {
+        phcow_string name;
+        uint64_t gen = 0;
+        const Reference* qref = nullptr;
+      };
+
+    uint64_t m_generation = 1;
+    mutable Global_Cache_Entry m_global_cache[64];
+
   public:
     // Creates a global context, with the standard library initialized according
     // to `api_version_req`.
     explicit Global_Context(API_Version api_version_req = api_version_latest);
 
+  private:
+    void
+    do_set_safepoint_flags(uint32_t set, uint32_t clear)
+      noexcept;
+
+    void
+    do_check_safepoint_slow(Executive_Context& ctx);
+
   protected:
     bool
     do_is_analytic()
@@ -41,6 +105,50 @@ class Global_Context
     Global_Context& operator=(const Global_Context&) & = delete;
     ~Global_Context();
 
+    // These functions insert or erase global references. They shall not be
+    // called via `Abstract_Context`, which would leave stale pointers in the
+    // cache of global references.
+    Reference&
+    insert_named_reference(const phcow_string& name)
+      {
+        this->m_generation ++;
+        return this->Abstract_Context::insert_named_reference(name);
+      }
+
+    bool
+    erase_named_reference(const phcow_string& name, Reference* refp_opt)
+      noexcept
+      {
+        this->m_generation ++;
+        return this->Abstract_Context::erase_named_reference(name, refp_opt);
+      }
+
+    // A pointer to a global reference remains valid as long as the generation
+    // doesn't change.
+    uint64_t
+    get_generation()
+      const noexcept
+      { return this->m_generation;  }
+
+    // This is the same as `get_named_reference_opt()`, except that the result
+    // is cached.
+    const Reference*
+    get_named_reference_cached_opt(const phcow_string& name)
+      const
+      {
+        auto& entry = this->m_global_cache[name.rdhash() % size(this->m_global_cache)];
+        if(ASTERIA_EXPECT((entry.gen == this->m_generation) && (entry.name == name)))
+          return entry.qref;
+
+        auto qref = this->get_named_reference_opt(name);
+        if(qref) {
+          entry.name = name;
+          entry.gen = this->m_generation;
+          entry.qref = qref;
+        }
+        return qref;
+      }
+
     // This provides stack overflow protection.
     Recursion_Sentry
     copy_recursion_sentry()
@@ -57,6 +165,250 @@ class Global_Context
       noexcept
       { this->m_sentry.set_base(base);  }
 
+    // These functions allow deep recursion. If a script function is called
+    // when the current stack is nearly full, it continues on a new stack
+    // segment instead of failing with a stack overflow. At most `count`
+    // segments may be in use at a time. The default value of zero disables
+    // this feature.
+    uint32_t
+    get_max_stack_segments()
+      const noexcept
+      { return this->m_max_stack_segments;  }
+
+    void
+    set_max_stack_segments(uint32_t count)
+      noexcept
+      { this->m_max_stack_segments = count;  }
+
+    uint32_t
+    count_stack_segments()
+      const noexcept
+      { return this->m_stack_segments;  }
+
+    size_t
+    count_pooled_stack_segments()
+      const noexcept
+      { return this->m_stack_pool.size() + this->m_generator_stack_pool.size();  }
+
+    void
+    clear_pooled_stack_segments()
+      noexcept;
+
+    // This returns whether a call should be made with `call_on_new_stack()`,
+    // which is when more than three quarters of the limit of the recursion
+    // sentry have been used.
+    bool
+    is_stack_nearly_full()
+      const noexcept
+      {
+        if(ASTERIA_EXPECT(this->m_stack_segments >= this->m_max_stack_segments))
+          return false;
+
+        constexpr ptrdiff_t threshold = (ptrdiff_t(1) << Recursion_Sentry::nbits_limit) / 4 * 3;
+        const char* base = static_cast<const char*>(this->m_sentry.get_base());
+        return base - static_cast<const char*>(__builtin_frame_address(0)) > threshold;
+      }
+
+    // These functions manage stack segments, which are also used by generators.
+    // `allocate_stack_segment()` returns a null pointer if no segment can be
+    // allocated. Each segment is `stack_segment_size` bytes, and its lowest
+    // page is a guard page.
+    static constexpr size_t stack_segment_size = 4 << 20;
+
+    void*
+    allocate_stack_segment();
+
+    void
+    release_stack_segment(void* stack)
+      noexcept;
+
+    // These functions manage stacks of generators, which are smaller, as each
+    // suspended generator keeps its stack. `allocate_generator_stack()` returns
+    // a null pointer if no stack can be allocated. Each stack is large enough
+    // for the limit of the recursion sentry, plus some room for the exception
+    // that it throws, and its lowest page is a guard page.
+    static constexpr size_t generator_stack_size =
+        (size_t(1) << Recursion_Sentry::nbits_limit) + (64 << 10);
+
+    void*
+    allocate_generator_stack();
+
+    void
+    release_generator_stack(void* stack)
+      noexcept;
+
+    // These functions are called by generators that are started or finished
+    // in this context.
+    void
+    attach_generator(const refcnt_ptr<const Generator>& gen);
+
+    void
+    detach_generator(const Generator& gen)
+      noexcept;
+
+    size_t
+    count_generators()
+      const noexcept
+      { return this->m_generators.size();  }
+
+    // Cancels suspended generators that are no longer referenced outside this
+    // context, so their `defer` expressions are executed. This is called when
+    // a generator is started, after a script returns, and before this context
+    // is destroyed.
+    void
+    finalize_generators();
+
+    // Calls `fn(param)` on a new stack segment, with a new recursion base.
+    // Exceptions are propagated to the caller. If no segment can be allocated,
+    // or stacks can't be switched on this platform, `fn(param)` is called on
+    // the current stack.
+    void
+    call_on_new_stack(void fn(void*), void* param);
+
+    // These functions manage storage of function calls. `acquire_frame()`
+    // moves pooled storage into the arguments, which shall be empty.
+    // `release_frame()` clears the arguments and moves their storage back
+    // into the pool.
+    void
+    acquire_frame(Reference_Dictionary& named_refs,
+                  cow_bivector<phcow_string, Reference>& slotted_refs,
+                  Reference_Stack& alt_stack);
+
+    void
+    release_frame(Reference_Dictionary& named_refs,
+                  cow_bivector<phcow_string, Reference>& slotted_refs,
+                  Reference_Stack& alt_stack)
+      noexcept;
+
+    size_t
+    count_pooled_frames()
+      const noexcept
+      { return this->m_frame_pool.size();  }
+
+    void
+    clear_pooled_frames()
+      noexcept
+      { this->m_frame_pool.clear();  }
+
+    // These are numbers of calls to `acquire_frame()` which have been served
+    // from the pool and which have not, respectively.
+    size_t
+    get_frame_pool_hits()
+      const noexcept
+      { return this->m_frame_hits;  }
+
+    size_t
+    get_frame_pool_misses()
+      const noexcept
+      { return this->m_frame_misses;  }
+
+    // These functions manage arguments of proper tail calls, in the same way
+    // as frames above. `acquire_ptc_arguments()` swaps the argument stack with
+    // `stack`, so its storage is reused by the caller. `release_ptc_arguments()`
+    // clears the arguments and moves them back into the pool if they are not
+    // shared.
+    refcnt_ptr<PTC_Arguments>
+    acquire_ptc_arguments(const Source_Location& sloc, PTC_Aware ptc,
+                          const cow_function& target, Reference&& self,
+                          Reference_Stack& stack);
+
+    void
+    release_ptc_arguments(refcnt_ptr<PTC_Arguments>&& ptcg)
+      noexcept;
+
+    size_t
+    count_pooled_ptc_arguments()
+      const noexcept
+      { return this->m_ptc_pool.size();  }
+
+    void
+    clear_pooled_ptc_arguments()
+      noexcept
+      { this->m_ptc_pool.clear();  }
+
+    size_t
+    get_ptc_pool_hits()
+      const noexcept
+      { return this->m_ptc_hits;  }
+
+    size_t
+    get_ptc_pool_misses()
+      const noexcept
+      { return this->m_ptc_misses;  }
+
+    // These functions stop running scripts at safepoints, which are iterations
+    // of loops and entries of functions. `request_interrupt()` may be called
+    // from another thread or a signal handler. At the next safepoint, the
+    // `on_interrupt()` hook is called, which may throw an exception to stop
+    // the script; if no hooks have been installed, a `Runtime_Error` with
+    // `is_interrupted()` set is thrown, which scripts can't catch.
+    void
+    request_interrupt()
+      noexcept;
+
+    void
+    cancel_interrupt()
+      noexcept;
+
+    bool
+    is_interrupt_pending()
+      const noexcept;
+
+    // These functions set a time limit in milliseconds from now. After it has
+    // been reached, an exception is thrown at every safepoint, until the limit
+    // is cleared. This is a `Runtime_Error` with `is_timed_out()` set, which
+    // scripts can't catch.
+    void
+    set_time_limit(int64_t msecs)
+      noexcept;
+
+    void
+    clear_time_limit()
+      noexcept;
+
+    // These functions meter execution. Each safepoint consumes one unit of
+    // fuel. After all fuel has been consumed, an exception is thrown at every
+    // safepoint, until more fuel is added or metering is disabled. This is a
+    // `Runtime_Error` with `is_fuel_exhausted()` set, which scripts can't catch.
+    void
+    set_fuel(uint64_t fuel)
+      noexcept;
+
+    void
+    add_fuel(uint64_t fuel)
+      noexcept;
+
+    void
+    clear_fuel()
+      noexcept;
+
+    bool
+    is_fuel_metered()
+      const noexcept
+      { return this->m_safepoint_flags.load() & safepoint_fuel;  }
+
+    uint64_t
+    get_fuel()
+      const noexcept
+      { return this->m_fuel;  }
+
+    // This is called at every safepoint.
+    ASTERIA_ALWAYS_INLINE
+    void
+    check_safepoint(Executive_Context& ctx)
+      {
+        uint32_t flags = this->m_safepoint_flags.load();
+        if(ASTERIA_EXPECT(flags == 0))
+          return;
+
+        if(ASTERIA_EXPECT((flags == safepoint_fuel) && (this->m_fuel != 0))) {
+          this->m_fuel --;
+          return;
+        }
+
+        this->do_check_safepoint_slow(ctx);
+      }
+
     // Get the maximum API version that is supported when this library is built.
     // N.B. This function must not be inlined for this reason.
     ASTERIA_CONST
@@ -71,20 +423,42 @@ class Global_Context
       const noexcept
       { return unerase_pointer_cast<Abstract_Hooks>(this->m_qhooks);  }
 
+    // This is a bitwise OR of `Hook_Mask` values, which is copied from hooks
+    // when they are set, or when `refresh_hook_mask()` is called.
+    uint32_t
+    get_hook_mask()
+      const noexcept
+      { return this->m_hook_mask;  }
+
     template<typename xHooks, typename xMemfn, typename... xArgs>
     ASTERIA_FLATTEN
     void
     call_hook(xMemfn xHooks::* mfn, xArgs&&... args)
       {
-        if(auto hooks = unerase_pointer_cast<xHooks>(this->m_qhooks))
-          (hooks->*mfn) (forward<xArgs>(args)...);
+        if(ASTERIA_EXPECT((this->m_hook_mask & xHooks::hook_mask_of(mfn)) == 0))
+          return;
+
+        auto hooks = unerase_pointer_cast<xHooks>(this->m_qhooks);
+        (hooks->*mfn) (forward<xArgs>(args)...);
       }
 
     ASTERIA_INCOMPLET(Abstract_Hooks)
     void
     set_hooks(refcnt_ptr<Abstract_Hooks> hooks_opt)
       noexcept
-      { this->m_qhooks = move(hooks_opt);  }
+      {
+        this->m_hook_mask = hooks_opt ? hooks_opt->get_hook_mask() : hook_mask_none;
+        this->m_qhooks = move(hooks_opt);
+      }
+
+    ASTERIA_INCOMPLET(Abstract_Hooks)
+    void
+    refresh_hook_mask()
+      noexcept
+      {
+        auto hooks = unerase_pointer_cast<Abstract_Hooks>(this->m_qhooks);
+        this->m_hook_mask = hooks ? hooks->get_hook_mask() : hook_mask_none;
+      }
 
     // These are interfaces for individual global components.
     ASTERIA_INCOMPLET(Garbage_Collector)
@@ -6,6 +6,7 @@
 
 #include "../fwd.hpp"
 #include "../llds/avm_rod.hpp"
+#include "reference.hpp"
 namespace asteria {
 
 class Instantiated_Function
@@ -16,11 +17,20 @@ class Instantiated_Function
     Source_Location m_sloc;
     cow_string m_func;
     cow_vector<phcow_string> m_params;
+    bool m_generator;
     AVM_Rod m_rod;
 
+    // A closure shares the body of its prototype.
+    refcnt_ptr<const Instantiated_Function> m_proto_opt;
+    cow_vector<Reference> m_captures;
+
   public:
     Instantiated_Function(const Source_Location& xsloc, const cow_string& xfunc,
-                          const cow_vector<phcow_string>& xparams, const cow_vector<AIR_Node>& code);
+                          const cow_vector<phcow_string>& xparams, bool xgenerator,
+                          const cow_vector<AIR_Node>& code);
+
+    Instantiated_Function(const refcnt_ptr<const Instantiated_Function>& xproto,
+                          cow_vector<Reference>&& xcaptures);
 
   public:
     Instantiated_Function(const Instantiated_Function&) = delete;
@@ -42,6 +52,18 @@ class Instantiated_Function
       const noexcept
       { return this->m_params;  }
 
+    // A call to a generator function returns a generator, which executes the
+    // body when it is resumed.
+    bool
+    is_generator()
+      const noexcept
+      { return this->m_generator;  }
+
+    const Reference&
+    captured_reference(uint32_t index)
+      const
+      { return this->m_captures.at(index);  }
+
     tinyfmt&
     describe(tinyfmt& fmt)
       const override;
@@ -53,6 +75,12 @@ class Instantiated_Function
     void
     invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stack)
       const override;
+
+    // Executes the function body on the current stack. For a generator, this
+    // is called when it is resumed for the first time.
+    void
+    invoke_body(Reference& self, Global_Context& global, Reference_Stack&& stack)
+      const;
   };
 
 }  // namespace asteria
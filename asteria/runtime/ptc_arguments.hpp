@@ -96,6 +96,29 @@ class PTC_Arguments
     mut_defer()
       noexcept
       { return this->m_defer;  }
+
+    // These functions allow an object to be reused for another call. Storage
+    // of the argument stack is retained.
+    void
+    reload(const Source_Location& sloc, PTC_Aware ptc, const cow_function& target,
+           Reference&& self)
+      {
+        this->m_sloc = sloc;
+        this->m_ptc = ptc;
+        this->m_target = target;
+        this->m_self = move(self);
+      }
+
+    void
+    clear()
+      noexcept
+      {
+        this->m_target.reset();
+        this->m_self.clear();
+        this->m_stack.clear();
+        this->m_caller_opt.reset();
+        this->m_defer.clear();
+      }
   };
 
 }  // namespace asteria
@@ -30,6 +30,10 @@ class Runtime_Error
     tinyfmt_str m_tempf;
 
     tinyfmt_str m_fmt;  // human-readable message
+    bool m_fuel_exhausted = false;
+    bool m_cancelled = false;
+    bool m_timed_out = false;
+    bool m_interrupted = false;
 
   public:
     template<typename xValue>
@@ -62,6 +66,58 @@ class Runtime_Error
         this->do_insert_frame(frame_type_native, nullptr, this->m_value);
       }
 
+    explicit
+    Runtime_Error(Uxtc_fuel)
+      :
+        m_value()
+      {
+        this->m_fmt << "Execution budget exhausted";
+        this->m_value = this->m_fmt.extract_string();
+        this->m_fuel_exhausted = true;
+
+        this->do_backtrace();
+        this->do_insert_frame(frame_type_native, nullptr, this->m_value);
+      }
+
+    explicit
+    Runtime_Error(Uxtc_cancel)
+      :
+        m_value()
+      {
+        this->m_fmt << "Generator cancelled";
+        this->m_value = this->m_fmt.extract_string();
+        this->m_cancelled = true;
+
+        this->do_backtrace();
+        this->do_insert_frame(frame_type_native, nullptr, this->m_value);
+      }
+
+    explicit
+    Runtime_Error(Uxtc_timeout)
+      :
+        m_value()
+      {
+        this->m_fmt << "Time limit exceeded";
+        this->m_value = this->m_fmt.extract_string();
+        this->m_timed_out = true;
+
+        this->do_backtrace();
+        this->do_insert_frame(frame_type_native, nullptr, this->m_value);
+      }
+
+    explicit
+    Runtime_Error(Uxtc_interrupt)
+      :
+        m_value()
+      {
+        this->m_fmt << "Execution interrupted";
+        this->m_value = this->m_fmt.extract_string();
+        this->m_interrupted = true;
+
+        this->do_backtrace();
+        this->do_insert_frame(frame_type_native, nullptr, this->m_value);
+      }
+
   private:
     void
     do_backtrace();
@@ -87,6 +143,43 @@ class Runtime_Error
       const noexcept
       { return this->m_value;  }
 
+    // This is set if the exception was thrown because the global context had
+    // run out of fuel. Scripts can't catch such exceptions.
+    bool
+    is_fuel_exhausted()
+      const noexcept
+      { return this->m_fuel_exhausted;  }
+
+    // This is set if the exception was thrown to unwind a generator that is
+    // being cancelled. Scripts can't catch such exceptions, but deferred
+    // expressions are executed.
+    bool
+    is_cancelled()
+      const noexcept
+      { return this->m_cancelled;  }
+
+    // This is set if the exception was thrown because the time limit of the
+    // global context had been reached. Scripts can't catch such exceptions.
+    bool
+    is_timed_out()
+      const noexcept
+      { return this->m_timed_out;  }
+
+    // This is set if the exception was thrown because an interrupt had been
+    // requested on the global context. Scripts can't catch such exceptions.
+    bool
+    is_interrupted()
+      const noexcept
+      { return this->m_interrupted;  }
+
+    bool
+    is_uncatchable()
+      const noexcept
+      {
+        return this->m_fuel_exhausted || this->m_cancelled || this->m_timed_out
+               || this->m_interrupted;
+      }
+
     size_t
     count_frames()
       const noexcept
@@ -119,8 +119,14 @@ generate_code(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
             auto qref = qctx->get_named_reference_opt(altr.name);
             if(qref) {
               // A reference declared later has been found.
-              // Record the context depth for later lookups.
-              AIR_Node::S_push_local_reference xnode = { altr.sloc, (uint16_t) depth, altr.name };
+              // Record the context depth for later lookups. If the reference has
+              // been assigned a slot, it can be accessed without hashing.
+              uint32_t slot = UINT32_MAX;
+              if(qctx->is_analytic())
+                slot = static_cast<const Analytic_Context*>(qctx)->find_slot(altr.name);
+
+              AIR_Node::S_push_local_reference xnode = { altr.sloc, (uint16_t) depth, altr.name,
+                                                         slot };
               code.emplace_back(move(xnode));
               return;
             }
@@ -161,7 +167,7 @@ generate_code(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
           optmz.reload(&ctx, altr.params, global, altr.body);
 
           AIR_Node::S_define_function xnode = { opts, altr.sloc, altr.unique_name, altr.params,
-                                                optmz.get_code() };
+                                                optmz.is_generator(), optmz.get_code() };
           code.emplace_back(move(xnode));
           return;
         }
@@ -13,17 +13,19 @@
 namespace asteria {
 namespace {
 
-void
+uint32_t
 do_user_declare(Analytic_Context& ctx, cow_vector<phcow_string>* names_opt, const phcow_string& name)
   {
-    if(name.empty())
-      return;
+    if(!name.empty()) {
+      // Inject this name.
+      if(names_opt && !find(*names_opt, name))
+        names_opt->emplace_back(name);
 
-    // Inject this name.
-    if(names_opt && !find(*names_opt, name))
-      names_opt->emplace_back(name);
+      ctx.insert_named_reference(name);
+    }
 
-    ctx.insert_named_reference(name);
+    // Assign a slot in the executive context.
+    return ctx.insert_slot(name);
   }
 
 void
@@ -106,6 +108,21 @@ do_generate_block(const Compiler_Options& opts, const Global_Context& global,
     return code;
   }
 
+cow_vector<AIR_Node>
+do_generate_block(bool& scopeless, const Compiler_Options& opts, const Global_Context& global,
+                  Analytic_Context& ctx, PTC_Aware ptc, const Statement::S_block& block)
+  {
+    // If the block declares no names, it needn't a scope of its own, and is
+    // generated into `ctx` directly. The caller shall execute it likewise.
+    scopeless = all_of(block.stmts, [](const Statement& st) { return st.is_scopeless();  });
+    if(!scopeless)
+      return do_generate_block(opts, global, ctx, ptc, block);
+
+    cow_vector<AIR_Node> code;
+    do_generate_statement_list(code, ctx, nullptr, global, opts, ptc, block.stmts);
+    return code;
+  }
+
 }  // namespace
 
 void
@@ -162,19 +179,20 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           for(const auto& decl : altr.decls) {
             if(decl.names.size() == 1) {
               // Declare a scalar variable.
-              do_user_declare(ctx, names_opt, decl.names.at(0));
+              uint32_t slot = do_user_declare(ctx, names_opt, decl.names.at(0));
 
               if(decl.init.units.empty()) {
                 // Declare a variable with default initialization.
                 AIR_Node::S_define_null_variable xnode_decl = { decl.sloc, altr.immutable,
-                                                                decl.names.at(0) };
+                                                                decl.names.at(0), slot, false };
                 code.emplace_back(move(xnode_decl));
               }
               else {
                 // Evaluate the initializer.
                 do_generate_clear_stack(code);
 
-                AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(0) };
+                AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(0), slot,
+                                                            false };
                 code.emplace_back(move(xnode_decl));
 
                 // Generate code for the initializer.
@@ -187,14 +205,16 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
             }
             else if((decl.names.size() >= 2) && (decl.names.at(0) == "[") && (decl.names.back() == "]")) {
               // Declare a structured binding for array.
+              cow_vector<uint32_t> slots;
               for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k)
-                do_user_declare(ctx, names_opt, decl.names.at(k));
+                slots.emplace_back(do_user_declare(ctx, names_opt, decl.names.at(k)));
 
               if(decl.init.units.empty()) {
                 // Declare variables with default initialization.
                 for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k) {
                   AIR_Node::S_define_null_variable xnode_decl = { decl.sloc, altr.immutable,
-                                                                  decl.names.at(k) };
+                                                                  decl.names.at(k), slots.at(k - 1),
+                                                                  false };
                   code.emplace_back(move(xnode_decl));
                 }
               }
@@ -203,7 +223,8 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
                 do_generate_clear_stack(code);
 
                 for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k) {
-                  AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(k) };
+                  AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(k),
+                                                              slots.at(k - 1), false };
                   code.emplace_back(move(xnode_decl));
                 }
 
@@ -218,13 +239,15 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
             }
             else if((decl.names.size() >= 2) && (decl.names.at(0) == "{") && (decl.names.back() == "}")) {
               // Declare a structured binding for object.
+              cow_vector<uint32_t> slots;
               for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k)
-                do_user_declare(ctx, names_opt, decl.names.at(k));
+                slots.emplace_back(do_user_declare(ctx, names_opt, decl.names.at(k)));
 
               if(decl.init.units.empty()) {
                 // Declare variables with default initialization.
                 for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k) {
-                  AIR_Node::S_define_null_variable xnode_decl = { decl.sloc, altr.immutable, decl.names.at(k) };
+                  AIR_Node::S_define_null_variable xnode_decl = { decl.sloc, altr.immutable, decl.names.at(k),
+                                                                  slots.at(k - 1), false };
                   code.emplace_back(move(xnode_decl));
                 }
               }
@@ -233,7 +256,8 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
                 do_generate_clear_stack(code);
 
                 for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k) {
-                  AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(k) };
+                  AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(k),
+                                                              slots.at(k - 1), false };
                   code.emplace_back(move(xnode_decl));
                 }
 
@@ -257,10 +281,10 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           const auto& altr = this->m_stor.as<S_function>();
 
           // Create a dummy reference for further name lookups.
-          do_user_declare(ctx, names_opt, altr.name);
+          uint32_t slot = do_user_declare(ctx, names_opt, altr.name);
 
           // Declare the function, which is effectively an immutable variable.
-          AIR_Node::S_declare_variable xnode_decl = { altr.sloc, altr.name };
+          AIR_Node::S_declare_variable xnode_decl = { altr.sloc, altr.name, slot, false };
           code.emplace_back(move(xnode_decl));
 
           // Generate code
@@ -268,7 +292,7 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           optmz.reload(&ctx, altr.params, global, altr.body);
 
           AIR_Node::S_define_function xnode_defn = { opts, altr.sloc, altr.name, altr.params,
-                                                     optmz.get_code() };
+                                                     optmz.is_generator(), optmz.get_code() };
           code.emplace_back(move(xnode_defn));
 
           // Initialize the function.
@@ -287,10 +311,14 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
 
           // The result will have been pushed onto the top of the stack.
           // Generate code for both branches. Both can be PTC'd.
-          auto code_true = do_generate_block(opts, global, ctx, ptc, altr.branch_true);
-          auto code_false = do_generate_block(opts, global, ctx, ptc, altr.branch_false);
-
-          AIR_Node::S_if_statement xnode = { altr.negative, move(code_true), move(code_false) };
+          bool scopeless_true, scopeless_false;
+          auto code_true = do_generate_block(scopeless_true, opts, global, ctx, ptc,
+                                             altr.branch_true);
+          auto code_false = do_generate_block(scopeless_false, opts, global, ctx, ptc,
+                                              altr.branch_false);
+
+          AIR_Node::S_if_statement xnode = { altr.negative, move(code_true), move(code_false),
+                                             scopeless_true, scopeless_false };
           code.emplace_back(move(xnode));
           return;
         }
@@ -304,7 +332,13 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           do_generate_expression(code, opts, global, ctx, ptc_aware_none, altr.ctrl);
 
           // Create a fresh context for the `switch` body. Be advised that all
-          // clauses inside a `switch` statement share the same context.
+          // clauses inside a `switch` statement share the same context. If no
+          // clause declares names, the body is generated into `ctx` directly.
+          bool scopeless = all_of(altr.clauses,
+              [](const switch_clause& clause) {
+                return all_of(clause.body, [](const Statement& st) { return st.is_scopeless();  });
+              });
+
           Analytic_Context ctx_body(xtc_plain, ctx);
           cow_vector<AIR_Node::switch_clause> clauses;
           for(const auto& clause : altr.clauses) {
@@ -324,11 +358,12 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
                                         clause.label_upper);
 
             // Generate code for the clause and accumulate names.
-            do_generate_statement_list(r.code_body, ctx_body, &(r.names_added), global, opts,
-                                       ptc_aware_none, clause.body);
+            do_generate_statement_list(r.code_body, scopeless ? ctx : ctx_body,
+                                       &(r.names_added), global, opts, ptc_aware_none,
+                                       clause.body);
           }
 
-          AIR_Node::S_switch_statement xnode = { move(clauses) };
+          AIR_Node::S_switch_statement xnode = { move(clauses), scopeless };
           code.emplace_back(move(xnode));
           return;
         }
@@ -338,7 +373,9 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           const auto& altr = this->m_stor.as<S_do_while>();
 
           // Generate code for the body. Loop statements cannot be PTC'd.
-          auto code_body = do_generate_block(opts, global, ctx, ptc_aware_none, altr.body);
+          bool scopeless_body;
+          auto code_body = do_generate_block(scopeless_body, opts, global, ctx, ptc_aware_none,
+                                             altr.body);
 
           // Generate code for the condition.
           ASTERIA_ASSERT(!altr.cond.units.empty());
@@ -347,8 +384,8 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           // Generate code for the `__ifcomplete` block. This can be PTC'd.
           auto code_complete = do_generate_block(opts, global, ctx, ptc, altr.branch_complete);
 
-          AIR_Node::S_do_while_statement xnode = { move(code_body), altr.negative, move(code_cond),
-                                                   move(code_complete) };
+          AIR_Node::S_do_while_statement xnode = { move(code_body), scopeless_body, altr.negative,
+                                                   move(code_cond), move(code_complete) };
           code.emplace_back(move(xnode));
           return;
         }
@@ -362,13 +399,15 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           auto code_cond = do_generate_expression(opts, global, ctx, ptc_aware_none, altr.cond);
 
           // Generate code for the body. Loop statements cannot be PTC'd.
-          auto code_body = do_generate_block(opts, global, ctx, ptc_aware_none, altr.body);
+          bool scopeless_body;
+          auto code_body = do_generate_block(scopeless_body, opts, global, ctx, ptc_aware_none,
+                                             altr.body);
 
           // Generate code for the `__ifcomplete` block. This can be PTC'd.
           auto code_complete = do_generate_block(opts, global, ctx, ptc, altr.branch_complete);
 
           AIR_Node::S_while_statement xnode = { altr.negative, move(code_cond), move(code_body),
-                                                move(code_complete) };
+                                                scopeless_body, move(code_complete) };
           code.emplace_back(move(xnode));
           return;
         }
@@ -379,22 +418,27 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
 
           // Note that the key and value references outlasts every iteration, so we
           // have to create an outer contexts here.
+          // The key and mapped references always occupy the first two slots.
           Analytic_Context ctx_for(xtc_plain, ctx);
-          do_user_declare(ctx_for, names_opt, altr.name_key);
-          do_user_declare(ctx_for, names_opt, altr.name_mapped);
+          uint32_t slot_key = do_user_declare(ctx_for, names_opt, altr.name_key);
+          uint32_t slot_mapped = do_user_declare(ctx_for, names_opt, altr.name_mapped);
+          ASTERIA_ASSERT((slot_key == 0) && (slot_mapped == 1));
 
           // Generate code for the range initializer.
           ASTERIA_ASSERT(!altr.init.units.empty());
           auto code_init = do_generate_expression(opts, global, ctx_for, ptc_aware_none, altr.init);
 
           // Generate code for the body. Loop statements cannot be PTC'd.
-          auto code_body = do_generate_block(opts, global, ctx_for, ptc_aware_none, altr.body);
+          bool scopeless_body;
+          auto code_body = do_generate_block(scopeless_body, opts, global, ctx_for, ptc_aware_none,
+                                             altr.body);
 
           // Generate code for the `__ifcomplete` block. This can be PTC'd.
           auto code_complete = do_generate_block(opts, global, ctx, ptc, altr.branch_complete);
 
           AIR_Node::S_for_each_statement xnode = { altr.name_key, altr.name_mapped, altr.sloc_init,
-                                                   move(code_init), move(code_body), move(code_complete) };
+                                                   move(code_init), move(code_body), scopeless_body,
+                                                   move(code_complete) };
           code.emplace_back(move(xnode));
           return;
         }
@@ -413,13 +457,15 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           auto code_step = do_generate_expression(opts, global, ctx_for, ptc_aware_none, altr.step);
 
           // Generate code for the body. Loop statements cannot be PTC'd.
-          auto code_body = do_generate_block(opts, global, ctx_for, ptc_aware_none, altr.body);
+          bool scopeless_body;
+          auto code_body = do_generate_block(scopeless_body, opts, global, ctx_for, ptc_aware_none,
+                                             altr.body);
 
           // Generate code for the `__ifcomplete` block. This can be PTC'd.
           auto code_complete = do_generate_block(opts, global, ctx, ptc, altr.branch_complete);
 
           AIR_Node::S_for_statement xnode = { move(code_init), move(code_cond), move(code_step),
-                                              move(code_body), move(code_complete) };
+                                              move(code_body), scopeless_body, move(code_complete) };
           code.emplace_back(move(xnode));
           return;
         }
@@ -432,8 +478,10 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           auto code_try = do_generate_block(opts, global, ctx, ptc_aware_none, altr.body_try);
 
           // Create a fresh context for the `catch` clause.
+          // The exception reference always occupies the first slot.
           Analytic_Context ctx_catch(xtc_plain, ctx);
-          do_user_declare(ctx_catch, names_opt, altr.name_except);
+          uint32_t slot_except = do_user_declare(ctx_catch, names_opt, altr.name_except);
+          ASTERIA_ASSERT(slot_except == 0);
           ctx_catch.insert_named_reference(&"__backtrace");
 
           // Generate code for the `catch` body.
@@ -620,24 +668,43 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
 
           for(const auto& decl : altr.decls) {
             // Structured bindings are not allowed.
-            do_user_declare(ctx, names_opt, decl.name);
+            uint32_t slot = do_user_declare(ctx, names_opt, decl.name);
 
             // Evaluate the initializer, which is required.
             do_generate_clear_stack(code);
 
-            AIR_Node::S_declare_reference xnode_decl = { decl.name };
+            AIR_Node::S_declare_reference xnode_decl = { decl.name, slot };
             code.emplace_back(move(xnode_decl));
 
             // Generate code for the initializer.
             do_generate_subexpression(code, opts, global, ctx, ptc_aware_none, decl.init);
 
             // Initialize the reference.
-            AIR_Node::S_initialize_reference xnode_init = { decl.sloc, decl.name };
+            AIR_Node::S_initialize_reference xnode_init = { decl.sloc, decl.name, slot };
             code.emplace_back(move(xnode_init));
           }
           return;
         }
 
+      case index_yield:
+        {
+          const auto& altr = this->m_stor.as<S_yield>();
+
+          if(altr.expr.units.empty()) {
+            // Yield null.
+            AIR_Node::S_push_constant xnode_null = { V_null() };
+            code.emplace_back(move(xnode_null));
+          }
+          else {
+            // Generate code for the operand.
+            do_generate_expression(code, opts, global, ctx, ptc_aware_none, altr.expr);
+          }
+
+          AIR_Node::S_yield_statement xnode = { altr.sloc };
+          code.emplace_back(move(xnode));
+          return;
+        }
+
       default:
         ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
     }
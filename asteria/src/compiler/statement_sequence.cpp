@@ -1283,6 +1283,32 @@ do_accept_throw_statement_opt(Token_Stream& tstrm)
     return move(xstmt);
   }
 
+opt<Statement>
+do_accept_yield_statement_opt(Token_Stream& tstrm)
+  {
+    // yield-statement ::=
+    //   `yield` ( expression )? `;`
+    auto sloc = tstrm.next_sloc();
+    auto qkwrd = do_accept_keyword_opt(tstrm, { keyword_yield });
+    if(!qkwrd)
+      return nullopt;
+
+    auto arg_sloc = tstrm.next_sloc();
+    Statement::S_expression xexpr;
+    bool has_arg = do_accept_expression(xexpr.units, tstrm);
+
+    auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_semicol });
+    if(!kpunct)
+      throw Compiler_Error(xtc_status,
+                has_arg ? compiler_status_semicolon_expected
+                        : compiler_status_expression_expected,
+                tstrm.next_sloc());
+
+    xexpr.sloc = move(arg_sloc);
+    Statement::S_yield xstmt = { move(sloc), move(xexpr) };
+    return move(xstmt);
+  }
+
 opt<bool>
 do_accept_reference_specifier_opt(Token_Stream& tstrm)
   {
@@ -1462,6 +1488,7 @@ do_accept_statement_opt(Token_Stream& tstrm, scope_flags scope)
     //   continue-statement
     //   throw-statement
     //   return-statement
+    //   yield-statement
     //   assert-statement
     //   try-statement
     //   statement-block
@@ -1513,6 +1540,9 @@ do_accept_statement_opt(Token_Stream& tstrm, scope_flags scope)
     if(auto qstmt = do_accept_return_statement_opt(tstrm))
       return move(*qstmt);
 
+    if(auto qstmt = do_accept_yield_statement_opt(tstrm))
+      return move(*qstmt);
+
     if(auto qstmt = do_accept_assert_statement_opt(tstrm))
       return move(*qstmt);
 
@@ -1551,6 +1581,7 @@ do_accept_nondeclarative_statement_as_block_opt(Token_Stream& tstrm, scope_flags
     //   continue-statement
     //   throw-statement
     //   return-statement
+    //   yield-statement
     //   assert-statement
     //   try-statement
     //   statement-block
@@ -1584,6 +1615,9 @@ do_accept_nondeclarative_statement_as_block_opt(Token_Stream& tstrm, scope_flags
     if(auto qstmt = do_accept_return_statement_opt(tstrm))
       return do_blockify_statement(move(*qstmt));
 
+    if(auto qstmt = do_accept_yield_statement_opt(tstrm))
+      return do_blockify_statement(move(*qstmt));
+
     if(auto qstmt = do_accept_assert_statement_opt(tstrm))
       return do_blockify_statement(move(*qstmt));
 
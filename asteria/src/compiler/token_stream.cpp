@@ -718,6 +718,7 @@ constexpr s_keywords[] =
     { "unset",         keyword_unset       },
     { "var",           keyword_var         },
     { "while",         keyword_while       },
+    { "yield",         keyword_yield       },
   };
 
 bool
@@ -7,6 +7,7 @@
 #include "../runtime/runtime_error.hpp"
 #include "../runtime/ptc_arguments.hpp"
 #include "../runtime/instantiated_function.hpp"
+#include "../runtime/generator.hpp"
 #include "../llds/reference_stack.hpp"
 #include "../utils.hpp"
 namespace asteria {
@@ -79,6 +80,27 @@ invoke(Reference& self, Global_Context& global, Reference_Stack&& stack)
     self.check_function_result(global, move(stack));
   }
 
+bool
+cow_function::
+is_generator()
+  const noexcept
+  {
+    return dynamic_cast<const Generator*>(this->m_sptr.get()) != nullptr;
+  }
+
+bool
+cow_function::
+resume(Value& value, Global_Context& global)
+  const
+  {
+    auto gen = dynamic_cast<const Generator*>(this->m_sptr.get());
+    if(!gen)
+      throw Runtime_Error(xtc_format,
+              "cow_function: attempt to resume a non-generator function");
+
+    return gen->resume(value, global);
+  }
+
 const char*
 describe_type(Type type)
   noexcept
@@ -544,6 +544,22 @@ do_token(cow_string& token, Parser_Context& ctx, const Unified_Source& usrc)
       }
   }
 
+const phcow_string&
+do_intern_key(cow_dictionary<bool>& keys, const cow_string& token)
+  {
+    // Records in a document usually share keys, so make objects share a single
+    // string for each distinct key. The leading quotation mark is removed. The
+    // key is looked up in place, and copied only if it hasn't been seen.
+    auto it = keys.find(cow_string(sref(token.c_str() + 1, token.size() - 1)));
+    if(it != keys.end())
+      return it->first;
+
+    cow_string key(token.data() + 1, token.size() - 1);
+    key.shrink_to_fit();
+    it = keys.try_emplace(move(key)).first;
+    return it->first;
+  }
+
 void
 do_parse_from(Value& root, const Unified_Source& usrc)
   {
@@ -561,6 +577,7 @@ do_parse_from(Value& root, const Unified_Source& usrc)
     cow_vector<xFrame> stack;
     cow_string token;
     ascii_numget numg;
+    cow_dictionary<bool> keys;
     Value* pstor = &root;
 
     do_token(token, ctx, usrc);
@@ -608,7 +625,7 @@ do_parse_from(Value& root, const Unified_Source& usrc)
         if(token[0] != '\"')
           return do_err(ctx, "Missing key string");
 
-        auto emr = frm.pso->try_emplace(token.substr(1));
+        auto emr = frm.pso->try_emplace(do_intern_key(keys, token));
         ASTERIA_ASSERT(emr.second);
 
         do_token(token, ctx, usrc);
@@ -631,9 +648,11 @@ do_parse_from(Value& root, const Unified_Source& usrc)
       // number
       size_t n = numg.parse_DD(token.data(), token.size());
       ASTERIA_ASSERT(n == token.size());
-      numg.cast_D(pstor->open_real(), -DBL_MAX, DBL_MAX);
+      V_real rval;
+      numg.cast_D(rval, -DBL_MAX, DBL_MAX);
       if(numg.overflowed())
         return do_err(ctx, "Number value out of range");
+      *pstor = rval;
     }
     else if(token[0] == '\"') {
       // string
@@ -691,7 +710,7 @@ do_parse_from(Value& root, const Unified_Source& usrc)
             if(token[0] != '\"')
               return do_err(ctx, "Missing key string");
 
-            auto emr = frm.pso->try_emplace(token.substr(1));
+            auto emr = frm.pso->try_emplace(do_intern_key(keys, token));
             if(!emr.second)
               return do_err(ctx, "Duplicate key string");
 
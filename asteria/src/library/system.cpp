@@ -1020,17 +1020,21 @@ std_system_load_conf(V_string path)
         // integer
         size_t n = numg.parse_I(token.data(), token.size());
         ASTERIA_ASSERT(n == token.size());
-        numg.cast_I(pstor->open_integer(), INT64_MIN, INT64_MAX);
+        V_integer ival;
+        numg.cast_I(ival, INT64_MIN, INT64_MAX);
         if(numg.overflowed())
           ASTERIA_THROW(("Integer out of range at '$1:$2:$3'"), path, tok_ln, tok_col);
+        *pstor = ival;
       }
       else {
         // real number
         size_t n = numg.parse_D(token.data(), token.size());
         ASTERIA_ASSERT(n == token.size());
-        numg.cast_D(pstor->open_real(), -DBL_MAX, DBL_MAX);
+        V_real rval;
+        numg.cast_D(rval, -DBL_MAX, DBL_MAX);
         if(numg.overflowed())
           ASTERIA_THROW(("Real number out of range at '$1:$2:$3'"), path, tok_ln, tok_col);
+        *pstor = rval;
       }
     }
     else if(token[0] == '\"') {
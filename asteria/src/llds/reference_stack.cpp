@@ -62,4 +62,13 @@ do_clear(bool free_storage)
     ASTERIA_ASSERT(this->m_size == 0);
   }
 
+void
+Reference_Stack::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+  const
+  {
+    for(uint32_t k = 0;  k != this->m_size;  ++k)
+      this->m_bptr[k].collect_variables(staged, temp);
+  }
+
 }  // namespace asteria
@@ -15,4 +15,15 @@ do_create_lazy_reference_opt(Reference* hint_opt, const phcow_string& name)
     return nullptr;
   }
 
+void
+Abstract_Context::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+  const
+  {
+    this->m_named_refs.collect_variables(staged, temp);
+
+    for(uint32_t k = 0;  k != this->m_slotted_refs.size();  ++k)
+      this->m_slotted_refs[k].second.collect_variables(staged, temp);
+  }
+
 }  // namespace asteria
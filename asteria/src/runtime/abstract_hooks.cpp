@@ -3,16 +3,33 @@
 
 #include "../xprecompiled.hpp"
 #include "../../runtime/abstract_hooks.hpp"
+#include "../../runtime/runtime_error.hpp"
 #include "../../utils.hpp"
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wsuggest-attribute=noreturn"
 namespace asteria {
 
+uint32_t
+Abstract_Hooks::
+get_hook_mask()
+  const noexcept
+  {
+    return hook_mask_all;
+  }
+
 void
 Abstract_Hooks::
 on_trap(const Source_Location& sloc, Executive_Context& ctx)
   {
   }
 
+void
+Abstract_Hooks::
+on_interrupt(Executive_Context& ctx)
+  {
+    throw Runtime_Error(xtc_interrupt);
+  }
+
 void
 Abstract_Hooks::
 on_call(const Source_Location& sloc, const cow_function& target)
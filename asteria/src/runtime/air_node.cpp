@@ -15,6 +15,8 @@
 #include "../../runtime/ptc_arguments.hpp"
 #include "../../runtime/module_loader.hpp"
 #include "../../runtime/air_optimizer.hpp"
+#include "../../runtime/instantiated_function.hpp"
+#include "../../runtime/generator.hpp"
 #include "../../compiler/token_stream.hpp"
 #include "../../compiler/statement_sequence.hpp"
 #include "../../compiler/statement.hpp"
@@ -39,6 +41,39 @@ do_rebind_nodes(bool& dirty, cow_vector<AIR_Node>& code, const Abstract_Context&
         do_set_rebound(dirty, code.mut(i), move(*qnode));
   }
 
+void
+do_capture_nodes(bool& dirty, cow_vector<AIR_Node>& captures, cow_vector<AIR_Node>& code,
+                 uint32_t level)
+  {
+    for(size_t i = 0;  i < code.size();  ++i)
+      if(auto qnode = code.at(i).capture_opt(captures, level))
+        do_set_rebound(dirty, code.mut(i), move(*qnode));
+  }
+
+uint32_t
+do_find_capture(cow_vector<AIR_Node>& captures, const AIR_Node& node)
+  {
+    // References to the same name share the same capture.
+    for(uint32_t k = 0;  k != captures.size();  ++k)
+      if(captures.at(k).index() != node.index())
+        continue;
+      else if(node.index() == AIR_Node::index_push_local_reference) {
+        const auto& lhs = captures.at(k).as<AIR_Node::S_push_local_reference>();
+        const auto& rhs = node.as<AIR_Node::S_push_local_reference>();
+        if((lhs.depth == rhs.depth) && (lhs.slot == rhs.slot) && (lhs.name == rhs.name))
+          return k;
+      }
+      else {
+        const auto& lhs = captures.at(k).as<AIR_Node::S_push_captured_reference>();
+        const auto& rhs = node.as<AIR_Node::S_push_captured_reference>();
+        if((lhs.depth == rhs.depth) && (lhs.index == rhs.index))
+          return k;
+      }
+
+    captures.emplace_back(node);
+    return static_cast<uint32_t>(captures.size() - 1);
+  }
+
 template<typename xNode>
 opt<AIR_Node>
 do_return_rebound_opt(bool dirty, xNode&& bound)
@@ -74,6 +109,34 @@ do_push_subscript_and_check(Reference& ref, xSubscript&& xsub)
     ref.dereference_readonly();
   }
 
+refcnt_ptr<Variable>
+do_create_variable(const Executive_Context& ctx, bool untracked)
+  {
+    // A variable that can't be referenced by any value can't be part of a
+    // cycle, so it is destroyed when its last reference goes away.
+    if(untracked)
+      return make_refcnt<Variable>();
+
+    return ctx.global().garbage_collector()->create_variable();
+  }
+
+// Looks for a global reference. The result is cached by the global context,
+// which is not shared by other threads.
+const Reference&
+do_get_global_reference_cached(const Global_Context& global, const phcow_string& name)
+  {
+    auto qref = global.get_named_reference_cached_opt(name);
+    if(!qref)
+      throw Runtime_Error(xtc_format,
+               "Undeclared identifier `$1`", name);
+
+    if(qref->is_invalid())
+      throw Runtime_Error(xtc_format,
+               "Global reference `$1` is uninitialized", name);
+
+    return *qref;
+  }
+
 template<typename xSparam>
 void
 do_sparam_ctor(AVM_Rod::Header* head, void* arg)
@@ -105,6 +168,43 @@ do_execute_block(const AVM_Rod& rod, const Executive_Context& ctx)
     ctx_next.on_scope_exit_normal();
   }
 
+void
+do_execute_block(const AVM_Rod& rod, bool scopeless, Executive_Context& ctx)
+  {
+    // A block that declares no names is executed in the enclosing context.
+    if(scopeless)
+      rod.execute(ctx);
+    else
+      do_execute_block(rod, ctx);
+  }
+
+void
+do_execute_loop_body(const AVM_Rod& rod, bool scopeless, Executive_Context& ctx,
+                     opt<Executive_Context>& qctx_body)
+  {
+    // This is the back-edge of every loop.
+    ctx.global().check_safepoint(ctx);
+
+    if(scopeless) {
+      rod.execute(ctx);
+      return;
+    }
+
+    // The body context is created by the first iteration and shared by all
+    // the others. It is reset in place instead of being destroyed and created
+    // again, so its storage can be reused.
+    auto& ctx_body = qctx_body.value_or_emplace(xtc_plain, ctx);
+    try {
+      rod.execute(ctx_body);
+    }
+    catch(Runtime_Error& except) {
+      ctx_body.on_scope_exit_exceptional(except);
+      throw;
+    }
+    ctx_body.on_scope_exit_normal();
+    ctx_body.reset_plain();
+  }
+
 void
 do_evaluate_subexpression(Executive_Context& ctx, bool assign, const AVM_Rod& rod)
   {
@@ -161,8 +261,8 @@ do_invoke_partial(Reference& self, Executive_Context& ctx, const Source_Location
     }
     else {
       // Perform a tail call.
-      self.set_ptc(make_refcnt<PTC_Arguments>(sloc, ptc,
-                          target, move(self), move(ctx.alt_stack())));
+      self.set_ptc(ctx.global().acquire_ptc_arguments(sloc, ptc, target, move(self),
+                                                      ctx.alt_stack()));
       ctx.status() = air_status_return;
     }
   }
@@ -194,8 +294,218 @@ do_duplicate_sequence(const xContainer& src, int64_t count)
     return dst;
   }
 
+const Reference&
+do_get_slotted_reference(const Executive_Context& ctx, uint32_t depth, uint32_t slot,
+                         const phcow_string& name)
+  {
+    const Executive_Context* qctx = &ctx;
+    for(uint32_t k = 0;  k != depth;  ++k)
+      qctx = qctx->get_parent_opt();
+
+    auto qref = qctx->get_slotted_reference_opt(slot);
+    if(!qref || qref->is_invalid())
+      throw Runtime_Error(xtc_format,
+               "Initialization of `$1` was bypassed", name);
+
+    return *qref;
+  }
+
+// Encodes a comparison operator. Bits 0-3 are results of comparison, indexed
+// by `Compare`, for which the operator yields `true`. Bit 4 is set if the
+// operator is not applicable to unordered operands.
+uint32_t
+do_encode_compare(Xop xop)
+  {
+    if(xop == xop_cmp_eq)
+      return 1U << compare_equal;
+    else if(xop == xop_cmp_ne)
+      return 15U & ~(1U << compare_equal);
+    else if(xop == xop_cmp_un)
+      return 1U << compare_unordered;
+    else if(xop == xop_cmp_lt)
+      return 16U | 1U << compare_less;
+    else if(xop == xop_cmp_gt)
+      return 16U | 1U << compare_greater;
+    else if(xop == xop_cmp_lte)
+      return 16U | (15U & ~(1U << compare_greater));
+    else if(xop == xop_cmp_gte)
+      return 16U | (15U & ~(1U << compare_less));
+    else
+      ASTERIA_TERMINATE(("Invalid comparison operator `$1`"), xop);
+  }
+
+bool
+do_test_compare(const Value& lhs, V_integer irhs, uint32_t mask)
+  {
+    Compare cmp = (mask & 16U) ? lhs.compare_numeric_total(irhs)
+                               : lhs.compare_numeric_partial(irhs);
+    return (mask >> cmp) & 1U;
+  }
+
 }  // namespace
 
+const char*
+AIR_Node::
+describe_index(Index index)
+  noexcept
+  {
+    switch(index)
+      {
+      case index_clear_stack:
+        return "clear_stack";
+
+      case index_execute_block:
+        return "execute_block";
+
+      case index_declare_variable:
+        return "declare_variable";
+
+      case index_initialize_variable:
+        return "initialize_variable";
+
+      case index_if_statement:
+        return "if_statement";
+
+      case index_switch_statement:
+        return "switch_statement";
+
+      case index_do_while_statement:
+        return "do_while_statement";
+
+      case index_while_statement:
+        return "while_statement";
+
+      case index_for_each_statement:
+        return "for_each_statement";
+
+      case index_for_statement:
+        return "for_statement";
+
+      case index_try_statement:
+        return "try_statement";
+
+      case index_throw_statement:
+        return "throw_statement";
+
+      case index_assert_statement:
+        return "assert_statement";
+
+      case index_simple_status:
+        return "simple_status";
+
+      case index_check_argument:
+        return "check_argument";
+
+      case index_push_global_reference:
+        return "push_global_reference";
+
+      case index_push_local_reference:
+        return "push_local_reference";
+
+      case index_push_bound_reference:
+        return "push_bound_reference";
+
+      case index_define_function:
+        return "define_function";
+
+      case index_branch_expression:
+        return "branch_expression";
+
+      case index_function_call:
+        return "function_call";
+
+      case index_push_unnamed_array:
+        return "push_unnamed_array";
+
+      case index_push_unnamed_object:
+        return "push_unnamed_object";
+
+      case index_apply_operator:
+        return "apply_operator";
+
+      case index_unpack_array:
+        return "unpack_array";
+
+      case index_unpack_object:
+        return "unpack_object";
+
+      case index_define_null_variable:
+        return "define_null_variable";
+
+      case index_single_step_trap:
+        return "single_step_trap";
+
+      case index_variadic_call:
+        return "variadic_call";
+
+      case index_defer_expression:
+        return "defer_expression";
+
+      case index_import_call:
+        return "import_call";
+
+      case index_declare_reference:
+        return "declare_reference";
+
+      case index_initialize_reference:
+        return "initialize_reference";
+
+      case index_catch_expression:
+        return "catch_expression";
+
+      case index_return_statement:
+        return "return_statement";
+
+      case index_push_constant:
+        return "push_constant";
+
+      case index_alt_clear_stack:
+        return "alt_clear_stack";
+
+      case index_alt_function_call:
+        return "alt_function_call";
+
+      case index_coalesce_expression:
+        return "coalesce_expression";
+
+      case index_member_access:
+        return "member_access";
+
+      case index_apply_operator_bi32:
+        return "apply_operator_bi32";
+
+      case index_return_statement_bi32:
+        return "return_statement_bi32";
+
+      case index_check_null:
+        return "check_null";
+
+      case index_push_captured_reference:
+        return "push_captured_reference";
+
+      case index_apply_operator_local_bi32:
+        return "apply_operator_local_bi32";
+
+      case index_branch_compare_bi32:
+        return "branch_compare_bi32";
+
+      case index_push_global_member:
+        return "push_global_member";
+
+      case index_counted_for_statement:
+        return "counted_for_statement";
+
+      case index_inline_call:
+        return "inline_call";
+
+      case index_yield_statement:
+        return "yield_statement";
+
+      default:
+        return "[unknown node]";
+      }
+  }
+
 opt<Value>
 AIR_Node::
 get_constant_opt()
@@ -235,6 +545,7 @@ is_terminator()
       case index_while_statement:
       case index_for_each_statement:
       case index_for_statement:
+      case index_counted_for_statement:
       case index_try_statement:
       case index_assert_statement:
       case index_check_argument:
@@ -260,6 +571,11 @@ is_terminator()
       case index_member_access:
       case index_apply_operator_bi32:
       case index_check_null:
+      case index_push_captured_reference:
+      case index_apply_operator_local_bi32:
+      case index_push_global_member:
+      case index_inline_call:
+      case index_yield_statement:
         return false;
 
       case index_throw_statement:
@@ -299,6 +615,13 @@ is_terminator()
                  && !altr.code_false.empty() && altr.code_false.back().is_terminator();
         }
 
+      case index_branch_compare_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_branch_compare_bi32>();
+          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
+                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+        }
+
       default:
         ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
       }
@@ -315,6 +638,7 @@ rebind_opt(const Abstract_Context& ctx)
       case index_declare_variable:
       case index_initialize_variable:
       case index_throw_statement:
+      case index_yield_statement:
       case index_assert_statement:
       case index_simple_status:
       case index_check_argument:
@@ -340,6 +664,8 @@ rebind_opt(const Abstract_Context& ctx)
       case index_apply_operator_bi32:
       case index_return_statement_bi32:
       case index_check_null:
+      case index_apply_operator_local_bi32:
+      case index_push_global_member:
         return nullopt;
 
       case index_execute_block:
@@ -363,8 +689,8 @@ rebind_opt(const Abstract_Context& ctx)
           auto bound = altr;
           Analytic_Context ctx_empty(xtc_plain, ctx);
 
-          do_rebind_nodes(dirty, bound.code_true, ctx_empty);
-          do_rebind_nodes(dirty, bound.code_false, ctx_empty);
+          do_rebind_nodes(dirty, bound.code_true, altr.scopeless_true ? ctx : ctx_empty);
+          do_rebind_nodes(dirty, bound.code_false, altr.scopeless_false ? ctx : ctx_empty);
 
           return do_return_rebound_opt(dirty, move(bound));
         }
@@ -376,6 +702,7 @@ rebind_opt(const Abstract_Context& ctx)
           bool dirty = false;
           auto bound = altr;
           Analytic_Context ctx_empty(xtc_plain, ctx);
+          const Abstract_Context& ctx_body = altr.scopeless ? ctx : ctx_empty;
 
           for(size_t k = 0;  k < bound.clauses.size();  ++k) {
             // Labels are to be evaluated in the same scope as the condition
@@ -385,7 +712,7 @@ rebind_opt(const Abstract_Context& ctx)
                 do_set_rebound(dirty, bound.clauses.mut(k).code_labels.mut(i), move(*qnode));
 
             for(size_t i = 0;  i < bound.clauses.at(k).code_body.size();  ++i)
-              if(auto qnode = bound.clauses.at(k).code_body.at(i).rebind_opt(ctx_empty))
+              if(auto qnode = bound.clauses.at(k).code_body.at(i).rebind_opt(ctx_body))
                 do_set_rebound(dirty, bound.clauses.mut(k).code_body.mut(i), move(*qnode));
           }
 
@@ -401,7 +728,7 @@ rebind_opt(const Abstract_Context& ctx)
           Analytic_Context ctx_empty(xtc_plain, ctx);
 
           // The condition expression is not a part of the body.
-          do_rebind_nodes(dirty, bound.code_body, ctx_empty);
+          do_rebind_nodes(dirty, bound.code_body, altr.scopeless_body ? ctx : ctx_empty);
           do_rebind_nodes(dirty, bound.code_cond, ctx);
           do_rebind_nodes(dirty, bound.code_complete, ctx_empty);
 
@@ -418,7 +745,7 @@ rebind_opt(const Abstract_Context& ctx)
 
           // The condition expression is not a part of the body.
           do_rebind_nodes(dirty, bound.code_cond, ctx);
-          do_rebind_nodes(dirty, bound.code_body, ctx_empty);
+          do_rebind_nodes(dirty, bound.code_body, altr.scopeless_body ? ctx : ctx_empty);
           do_rebind_nodes(dirty, bound.code_complete, ctx_empty);
 
           return do_return_rebound_opt(dirty, move(bound));
@@ -435,9 +762,9 @@ rebind_opt(const Abstract_Context& ctx)
 
           // The range key and mapped references are declared in a dedicated scope
           // where the initializer is to be evaluated. The body is to be executed
-          // in an inner scope, created and destroyed for each iteration.
+          // in an inner scope, unless it declares no names.
           do_rebind_nodes(dirty, bound.code_init, ctx_for);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+          do_rebind_nodes(dirty, bound.code_body, altr.scopeless_body ? ctx_for : ctx_body);
           do_rebind_nodes(dirty, bound.code_complete, ctx_for);
 
           return do_return_rebound_opt(dirty, move(bound));
@@ -453,17 +780,48 @@ rebind_opt(const Abstract_Context& ctx)
           Analytic_Context ctx_body(xtc_plain, ctx_for);
 
           // All these are declared in a dedicated scope where the initializer is
-          // to be evaluated. The body is to be executed in an inner scope,
-          // created and destroyed for each iteration.
+          // to be evaluated. The body is to be executed in an inner scope, unless
+          // it declares no names.
           do_rebind_nodes(dirty, bound.code_init, ctx_for);
           do_rebind_nodes(dirty, bound.code_cond, ctx_for);
           do_rebind_nodes(dirty, bound.code_step, ctx_for);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+          do_rebind_nodes(dirty, bound.code_body, altr.scopeless_body ? ctx_for : ctx_body);
+          do_rebind_nodes(dirty, bound.code_complete, ctx_for);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_counted_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_counted_for_statement>();
+
+          bool dirty = false;
+          auto bound = altr;
+          Analytic_Context ctx_for(xtc_plain, ctx);
+          Analytic_Context ctx_body(xtc_plain, ctx_for);
+
+          // This is the same as `S_for_statement`, without the condition and
+          // step expressions.
+          do_rebind_nodes(dirty, bound.code_init, ctx_for);
+          do_rebind_nodes(dirty, bound.code_body, altr.scopeless_body ? ctx_for : ctx_body);
           do_rebind_nodes(dirty, bound.code_complete, ctx_for);
 
           return do_return_rebound_opt(dirty, move(bound));
         }
 
+      case index_inline_call:
+        {
+          const auto& altr = this->m_stor.as<S_inline_call>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          // Parameters are stored in the enclosing scope.
+          do_rebind_nodes(dirty, bound.code_body, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
       case index_try_statement:
         {
           const auto& altr = this->m_stor.as<S_try_statement>();
@@ -490,8 +848,14 @@ rebind_opt(const Abstract_Context& ctx)
           if(qctx->is_analytic())
             return nullopt;
 
-          // Look for the name.
-          auto qref = qctx->get_named_reference_opt(altr.name);
+          // Look for the name. If the slot has not been allocated, its declaration
+          // may have been bypassed, where the name will have been injected.
+          const Reference* qref = nullptr;
+          if(altr.slot != UINT32_MAX)
+            qref = qctx->get_slotted_reference_opt(altr.slot);
+          if(!qref)
+            qref = qctx->get_named_reference_opt(altr.name);
+
           if(!qref)
             return nullopt;
           else if(qref->is_invalid())
@@ -503,6 +867,25 @@ rebind_opt(const Abstract_Context& ctx)
           return move(xnode);
         }
 
+      case index_push_captured_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_captured_reference>();
+
+          // Get the function context.
+          const Abstract_Context* qctx = &ctx;
+          for(uint32_t k = 0;  k != altr.depth;  ++k)
+            qctx = qctx->get_parent_opt();
+
+          if(qctx->is_analytic())
+            return nullopt;
+
+          // Bind the reference that has been captured by this function.
+          auto qfunc = static_cast<const Executive_Context*>(qctx)->func_opt();
+          ASTERIA_ASSERT(qfunc);
+          S_push_bound_reference xnode = { qfunc->captured_reference(altr.index) };
+          return move(xnode);
+        }
+
       case index_define_function:
         {
           const auto& altr = this->m_stor.as<S_define_function>();
@@ -531,6 +914,19 @@ rebind_opt(const Abstract_Context& ctx)
           return do_return_rebound_opt(dirty, move(bound));
         }
 
+      case index_branch_compare_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_branch_compare_bi32>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_true, ctx);
+          do_rebind_nodes(dirty, bound.code_false, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
       case index_defer_expression:
         {
           const auto& altr = this->m_stor.as<S_defer_expression>();
@@ -572,9 +968,9 @@ rebind_opt(const Abstract_Context& ctx)
       }
   }
 
-void
+opt<AIR_Node>
 AIR_Node::
-collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+capture_opt(cow_vector<AIR_Node>& captures, uint32_t level)
   const
   {
     switch(static_cast<Index>(this->m_stor.index()))
@@ -583,11 +979,12 @@ collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
       case index_declare_variable:
       case index_initialize_variable:
       case index_throw_statement:
+      case index_yield_statement:
       case index_assert_statement:
       case index_simple_status:
       case index_check_argument:
       case index_push_global_reference:
-      case index_push_local_reference:
+      case index_push_bound_reference:
       case index_function_call:
       case index_push_unnamed_array:
       case index_push_unnamed_object:
@@ -601,53 +998,364 @@ collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
       case index_declare_reference:
       case index_initialize_reference:
       case index_return_statement:
+      case index_push_constant:
       case index_alt_clear_stack:
       case index_alt_function_call:
       case index_member_access:
       case index_apply_operator_bi32:
       case index_return_statement_bi32:
       case index_check_null:
-        return;
+      case index_apply_operator_local_bi32:
+      case index_push_global_member:
+        return nullopt;
 
+      // Scopes are counted exactly the same way as `rebind_opt()`.
       case index_execute_block:
         {
           const auto& altr = this->m_stor.as<S_execute_block>();
 
-          // Collect variables from the body.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_body, level + 1);
+
+          return do_return_rebound_opt(dirty, move(bound));
         }
 
       case index_if_statement:
         {
           const auto& altr = this->m_stor.as<S_if_statement>();
 
-          // Collect variables from both branches.
-          do_collect_variables_for_each(staged, temp, altr.code_true);
-          do_collect_variables_for_each(staged, temp, altr.code_false);
-          return;
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_true, level + !altr.scopeless_true);
+          do_capture_nodes(dirty, captures, bound.code_false, level + !altr.scopeless_false);
+
+          return do_return_rebound_opt(dirty, move(bound));
         }
 
       case index_switch_statement:
         {
           const auto& altr = this->m_stor.as<S_switch_statement>();
 
-          // Collect variables from all labels and clauses.
-          for(const auto& clause : altr.clauses)
-            do_collect_variables_for_each(staged, temp, clause.code_labels);
-          for(const auto& clause : altr.clauses)
-            do_collect_variables_for_each(staged, temp, clause.code_body);
-          return;
+          bool dirty = false;
+          auto bound = altr;
+          uint32_t level_body = level + !altr.scopeless;
+
+          for(size_t k = 0;  k < bound.clauses.size();  ++k) {
+            for(size_t i = 0;  i < bound.clauses.at(k).code_labels.size();  ++i)
+              if(auto qnode = bound.clauses.at(k).code_labels.at(i).capture_opt(captures, level))
+                do_set_rebound(dirty, bound.clauses.mut(k).code_labels.mut(i), move(*qnode));
+
+            for(size_t i = 0;  i < bound.clauses.at(k).code_body.size();  ++i)
+              if(auto qnode = bound.clauses.at(k).code_body.at(i).capture_opt(captures, level_body))
+                do_set_rebound(dirty, bound.clauses.mut(k).code_body.mut(i), move(*qnode));
+          }
+
+          return do_return_rebound_opt(dirty, move(bound));
         }
 
       case index_do_while_statement:
         {
           const auto& altr = this->m_stor.as<S_do_while_statement>();
 
-          // Collect variables from the body and the condition expression.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          do_collect_variables_for_each(staged, temp, altr.code_cond);
-          do_collect_variables_for_each(staged, temp, altr.code_complete);
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_body, level + !altr.scopeless_body);
+          do_capture_nodes(dirty, captures, bound.code_cond, level);
+          do_capture_nodes(dirty, captures, bound.code_complete, level + 1);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_while_statement>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_cond, level);
+          do_capture_nodes(dirty, captures, bound.code_body, level + !altr.scopeless_body);
+          do_capture_nodes(dirty, captures, bound.code_complete, level + 1);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_for_each_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_each_statement>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_init, level + 1);
+          do_capture_nodes(dirty, captures, bound.code_body, level + 2 - altr.scopeless_body);
+          do_capture_nodes(dirty, captures, bound.code_complete, level + 1);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_statement>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_init, level + 1);
+          do_capture_nodes(dirty, captures, bound.code_cond, level + 1);
+          do_capture_nodes(dirty, captures, bound.code_step, level + 1);
+          do_capture_nodes(dirty, captures, bound.code_body, level + 2 - altr.scopeless_body);
+          do_capture_nodes(dirty, captures, bound.code_complete, level + 1);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_counted_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_counted_for_statement>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_init, level + 1);
+          do_capture_nodes(dirty, captures, bound.code_body, level + 2 - altr.scopeless_body);
+          do_capture_nodes(dirty, captures, bound.code_complete, level + 1);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_inline_call:
+        {
+          const auto& altr = this->m_stor.as<S_inline_call>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_body, level);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_try_statement:
+        {
+          const auto& altr = this->m_stor.as<S_try_statement>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_try, level + 1);
+          do_capture_nodes(dirty, captures, bound.code_catch, level + 1);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_push_local_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_local_reference>();
+
+          if(altr.depth <= level)
+            return nullopt;
+
+          // This name is declared outside the function. Record it with its depth
+          // relative to the context where the function is defined.
+          auto orig = altr;
+          orig.depth = static_cast<uint16_t>(altr.depth - level - 1);
+
+          S_push_captured_reference xnode = { altr.sloc, static_cast<uint16_t>(level),
+                                              do_find_capture(captures, move(orig)) };
+          return move(xnode);
+        }
+
+      case index_push_captured_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_captured_reference>();
+
+          if(altr.depth <= level)
+            return nullopt;
+
+          // This has been captured by an enclosing function, which shall be
+          // captured again.
+          auto orig = altr;
+          orig.depth = static_cast<uint16_t>(altr.depth - level - 1);
+
+          S_push_captured_reference xnode = { altr.sloc, static_cast<uint16_t>(level),
+                                              do_find_capture(captures, move(orig)) };
+          return move(xnode);
+        }
+
+      case index_define_function:
+        {
+          const auto& altr = this->m_stor.as<S_define_function>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_body, level + 1);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_true, level);
+          do_capture_nodes(dirty, captures, bound.code_false, level);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_branch_compare_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_branch_compare_bi32>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_true, level);
+          do_capture_nodes(dirty, captures, bound.code_false, level);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_defer_expression:
+        {
+          const auto& altr = this->m_stor.as<S_defer_expression>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_body, level);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_catch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_catch_expression>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_body, level);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_coalesce_expression:
+        {
+          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+
+          bool dirty = false;
+          auto bound = altr;
+
+          do_capture_nodes(dirty, captures, bound.code_null, level);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+      }
+  }
+
+void
+AIR_Node::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+  const
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+      case index_declare_variable:
+      case index_initialize_variable:
+      case index_throw_statement:
+      case index_yield_statement:
+      case index_assert_statement:
+      case index_simple_status:
+      case index_check_argument:
+      case index_push_global_reference:
+      case index_push_local_reference:
+      case index_function_call:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_array:
+      case index_unpack_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_variadic_call:
+      case index_import_call:
+      case index_declare_reference:
+      case index_initialize_reference:
+      case index_return_statement:
+      case index_alt_clear_stack:
+      case index_alt_function_call:
+      case index_member_access:
+      case index_apply_operator_bi32:
+      case index_return_statement_bi32:
+      case index_check_null:
+      case index_push_captured_reference:
+      case index_apply_operator_local_bi32:
+      case index_push_global_member:
+        return;
+
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
+
+          // Collect variables from the body.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
+
+      case index_if_statement:
+        {
+          const auto& altr = this->m_stor.as<S_if_statement>();
+
+          // Collect variables from both branches.
+          do_collect_variables_for_each(staged, temp, altr.code_true);
+          do_collect_variables_for_each(staged, temp, altr.code_false);
+          return;
+        }
+
+      case index_branch_compare_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_branch_compare_bi32>();
+
+          // Collect variables from both branches.
+          do_collect_variables_for_each(staged, temp, altr.code_true);
+          do_collect_variables_for_each(staged, temp, altr.code_false);
+          return;
+        }
+
+      case index_switch_statement:
+        {
+          const auto& altr = this->m_stor.as<S_switch_statement>();
+
+          // Collect variables from all labels and clauses.
+          for(const auto& clause : altr.clauses)
+            do_collect_variables_for_each(staged, temp, clause.code_labels);
+          for(const auto& clause : altr.clauses)
+            do_collect_variables_for_each(staged, temp, clause.code_body);
+          return;
+        }
+
+      case index_do_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_do_while_statement>();
+
+          // Collect variables from the body and the condition expression.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          do_collect_variables_for_each(staged, temp, altr.code_cond);
+          do_collect_variables_for_each(staged, temp, altr.code_complete);
           return;
         }
 
@@ -686,6 +1394,26 @@ collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
           return;
         }
 
+      case index_counted_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_counted_for_statement>();
+
+          // Collect variables from the initializer and the body.
+          do_collect_variables_for_each(staged, temp, altr.code_init);
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          do_collect_variables_for_each(staged, temp, altr.code_complete);
+          return;
+        }
+
+      case index_inline_call:
+        {
+          const auto& altr = this->m_stor.as<S_inline_call>();
+
+          // Collect variables from the body.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
+
       case index_try_statement:
         {
           const auto& altr = this->m_stor.as<S_try_statement>();
@@ -846,7 +1574,11 @@ solidify(AVM_Rod& rod)
         {
           const auto& altr = this->m_stor.as<S_declare_variable>();
 
-          struct Sparam
+          AVM_Rod::Uparam up2;
+          up2.b0 = altr.untracked;
+          up2.u2345 = altr.slot;
+
+          struct Sparam
             {
               phcow_string name;
             };
@@ -858,13 +1590,14 @@ solidify(AVM_Rod& rod)
             +[](Executive_Context& ctx, const AVM_Rod::Header* head)
               __attribute__((__hot__, __flatten__))
               {
+                const bool untracked = head->uparam.b0;
+                const uint32_t slot = head->uparam.u2345;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
                 const auto& sloc = *(head->pv_meta->sloc_opt);
 
                 // Allocate a variable and inject it into the current context.
-                const auto gcoll = ctx.global().garbage_collector();
-                const auto var = gcoll->create_variable();
-                ctx.insert_named_reference(sp.name).set_variable(var);
+                const auto var = do_create_variable(ctx, untracked);
+                ctx.insert_slotted_reference(slot, sp.name).set_variable(var);
                 ctx.global().call_hook(&Abstract_Hooks::on_declare, sloc, sp.name);
 
                 // Push a copy of the reference onto the stack, which we will get
@@ -873,7 +1606,7 @@ solidify(AVM_Rod& rod)
               }
 
             // Uparam
-            , AVM_Rod::Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
@@ -929,6 +1662,8 @@ solidify(AVM_Rod& rod)
 
           AVM_Rod::Uparam up2;
           up2.b0 = altr.negative;
+          up2.b1 = altr.scopeless_true;
+          up2.b2 = altr.scopeless_false;
 
           struct Sparam
             {
@@ -945,13 +1680,15 @@ solidify(AVM_Rod& rod)
               __attribute__((__hot__, __flatten__))
               {
                 const bool negative = head->uparam.b0;
+                const bool scopeless_true = head->uparam.b1;
+                const bool scopeless_false = head->uparam.b2;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
                 // Check the condition and pick a branch.
                 if(ctx.stack().top().dereference_readonly().test() != negative)
-                  do_execute_block(sp.rod_true, ctx);
+                  do_execute_block(sp.rod_true, scopeless_true, ctx);
                 else
-                  do_execute_block(sp.rod_false, ctx);
+                  do_execute_block(sp.rod_false, scopeless_false, ctx);
               }
 
             // Uparam
@@ -988,24 +1725,61 @@ solidify(AVM_Rod& rod)
               cow_vector<phcow_string> names_added;
             };
 
-          using Sparam = cow_vector<Sparam_switch_clause>;
+          struct Sparam
+            {
+              cow_vector<Sparam_switch_clause> clauses;
+
+              // If all labels are constant integers or strings, these map them
+              // to indices of clauses, so clauses need not be tested one by one.
+              bool has_table;
+              size_t default_index;
+              cow_hashmap<V_integer, uint32_t, ::std::hash<V_integer>> integer_targets;
+              cow_dictionary<uint32_t> string_targets;
+            };
+
           Sparam sp2;
-          sp2.reserve(altr.clauses.size());
+          sp2.clauses.reserve(altr.clauses.size());
+          sp2.has_table = true;
+          sp2.default_index = SIZE_MAX;
 
           for(const auto& clause : altr.clauses) {
-            auto& r = sp2.emplace_back();
+            auto& r = sp2.clauses.emplace_back();
             r.type = clause.type;
             r.cmp2_lower = clause.lower_closed ? compare_equal : compare_greater;
             r.cmp2_upper = clause.upper_closed ? compare_equal : compare_less;
             do_solidify_nodes(r.rod_labels, clause.code_labels);
             do_solidify_nodes(r.rod_body, clause.code_body);
             r.names_added = clause.names_added;
+
+            // Check whether this label can be put into the table. If there are
+            // duplicate labels, only the first one can be matched.
+            uint32_t index = static_cast<uint32_t>(sp2.clauses.size() - 1);
+            opt<Value> qlabel;
+            if(clause.type == switch_clause_default)
+              sp2.default_index = index;
+            else if(clause.type != switch_clause_case)
+              sp2.has_table = false;
+            else if((clause.code_labels.size() != 2)
+                    || (clause.code_labels.front().index() != index_clear_stack))
+              sp2.has_table = false;
+            else if(!(qlabel = clause.code_labels.back().get_constant_opt()))
+              sp2.has_table = false;
+            else if(qlabel->is_integer())
+              sp2.integer_targets.try_emplace(qlabel->as_integer(), index);
+            else if(qlabel->is_string())
+              sp2.string_targets.try_emplace(qlabel->as_string(), index);
+            else
+              sp2.has_table = false;
           }
 
+          AVM_Rod::Uparam up2;
+          up2.b0 = altr.scopeless;
+
           rod.push_function(
             +[](Executive_Context& ctx, const AVM_Rod::Header* head)
               __attribute__((__cold__))
               {
+                const bool scopeless = head->uparam.b0;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
                 // Read the value of the condition and find the target clause for it.
@@ -1014,53 +1788,81 @@ solidify(AVM_Rod& rod)
                 auto cond = ctx.stack().top().dereference_readonly();
                 size_t target_index = SIZE_MAX;
 
-                for(size_t k = 0;  k < sp.size();  ++k)
-                  if(sp.at(k).type == switch_clause_default) {
-                    target_index = k;
-                  }
-                  else if(sp.at(k).type == switch_clause_case) {
-                    // Expect an exact match of one value.
-                    sp.at(k).rod_labels.execute(ctx);
-                    ASTERIA_ASSERT(ctx.status() == air_status_next);
+                if(sp.has_table && !cond.is_real()) {
+                  // A real number may equal an integer label, so it is not looked
+                  // up. Values of other types can only match labels of the same
+                  // type.
+                  target_index = sp.default_index;
+                  const uint32_t* qindex = nullptr;
+                  if(cond.is_integer())
+                    qindex = sp.integer_targets.ptr(cond.as_integer());
+                  else if(cond.is_string())
+                    qindex = sp.string_targets.ptr(cond.as_string());
+
+                  if(qindex)
+                    target_index = *qindex;
+                }
+                else
+                  for(size_t k = 0;  k < sp.clauses.size();  ++k)
+                    if(sp.clauses.at(k).type == switch_clause_default) {
+                      target_index = k;
+                    }
+                    else if(sp.clauses.at(k).type == switch_clause_case) {
+                      // Expect an exact match of one value.
+                      sp.clauses.at(k).rod_labels.execute(ctx);
+                      ASTERIA_ASSERT(ctx.status() == air_status_next);
 
-                    auto cmp = cond.compare_partial(ctx.stack().top().dereference_readonly());
-                    if(cmp != compare_equal)
-                      continue;
+                      auto cmp = cond.compare_partial(ctx.stack().top().dereference_readonly());
+                      if(cmp != compare_equal)
+                        continue;
 
-                    target_index = k;
-                    break;
-                  }
-                  else if(sp.at(k).type == switch_clause_each) {
-                    // Expect an interval of two values.
-                    sp.at(k).rod_labels.execute(ctx);
-                    ASTERIA_ASSERT(ctx.status() == air_status_next);
-
-                    auto cmp_lo = cond.compare_partial(ctx.stack().top(1).dereference_readonly());
-                    auto cmp_up = cond.compare_partial(ctx.stack().top(0).dereference_readonly());
-                    if(is_none_of(cmp_lo, { compare_greater, sp.at(k).cmp2_lower })
-                        || is_none_of(cmp_up, { compare_less, sp.at(k).cmp2_upper }))
-                      continue;
-
-                    target_index = k;
-                    break;
-                  }
+                      target_index = k;
+                      break;
+                    }
+                    else if(sp.clauses.at(k).type == switch_clause_each) {
+                      // Expect an interval of two values.
+                      sp.clauses.at(k).rod_labels.execute(ctx);
+                      ASTERIA_ASSERT(ctx.status() == air_status_next);
+
+                      auto cmp_lo = cond.compare_partial(ctx.stack().top(1).dereference_readonly());
+                      auto cmp_up = cond.compare_partial(ctx.stack().top(0).dereference_readonly());
+                      if(is_none_of(cmp_lo, { compare_greater, sp.clauses.at(k).cmp2_lower })
+                          || is_none_of(cmp_up, { compare_less, sp.clauses.at(k).cmp2_upper }))
+                        continue;
+
+                      target_index = k;
+                      break;
+                    }
 
                 // Skip this statement if no matching clause has been found.
-                if(target_index >= sp.size())
+                if(target_index >= sp.clauses.size())
                   return;
 
-                // Jump to the target clause.
+                // Jump to the target clause. If no clause declares names, there
+                // are no names to inject, and clauses are executed in `ctx`.
+                if(scopeless) {
+                  for(size_t i = target_index;  i < sp.clauses.size();  ++i) {
+                    sp.clauses.at(i).rod_body.execute(ctx);
+                    if(ctx.status() != air_status_next) {
+                      if(is_any_of(ctx.status(), { air_status_break, air_status_break_switch }))
+                        ctx.status() = air_status_next;
+                      break;
+                    }
+                  }
+                  return;
+                }
+
                 Executive_Context ctx_body(xtc_plain, ctx);
                 try {
-                  for(size_t i = 0;  i < sp.size();  ++i)
+                  for(size_t i = 0;  i < sp.clauses.size();  ++i)
                     if(i < target_index) {
                       // Inject bypassed names into the scope.
-                      for(const auto& name : sp.at(i).names_added)
+                      for(const auto& name : sp.clauses.at(i).names_added)
                         ctx_body.insert_named_reference(name);
                     }
                     else {
                       // Execute the body of this clause.
-                      sp.at(i).rod_body.execute(ctx_body);
+                      sp.clauses.at(i).rod_body.execute(ctx_body);
                       if(ctx.status() != air_status_next) {
                         if(is_any_of(ctx.status(), { air_status_break, air_status_break_switch }))
                           ctx.status() = air_status_next;
@@ -1076,7 +1878,7 @@ solidify(AVM_Rod& rod)
               }
 
             // Uparam
-            , AVM_Rod::Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
@@ -1085,9 +1887,9 @@ solidify(AVM_Rod& rod)
             , +[](Variable_HashMap& staged, Variable_HashMap& temp, const AVM_Rod::Header* head)
               {
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-                for(const auto& r : sp)
+                for(const auto& r : sp.clauses)
                   r.rod_labels.collect_variables(staged, temp);
-                for(const auto& r : sp)
+                for(const auto& r : sp.clauses)
                   r.rod_body.collect_variables(staged, temp);
               }
 
@@ -1103,6 +1905,7 @@ solidify(AVM_Rod& rod)
 
           AVM_Rod::Uparam up2;
           up2.b0 = altr.negative;
+          up2.b1 = altr.scopeless_body;
 
           struct Sparam
             {
@@ -1121,13 +1924,15 @@ solidify(AVM_Rod& rod)
               __attribute__((__hot__, __flatten__))
               {
                 const bool negative = head->uparam.b0;
+                const bool scopeless_body = head->uparam.b1;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
                 // This is the same as a `do`..`while` loop in other languages.
                 // A `break while` statement shall terminate the loop and return
                 // `air_status_next` to resume execution after the loop body.
+                opt<Executive_Context> ctx_body;
                 for(;;) {
-                  do_execute_block(sp.rod_body, ctx);
+                  do_execute_loop_body(sp.rod_body, scopeless_body, ctx, ctx_body);
                   if(is_any_of(ctx.status(), { air_status_continue, air_status_continue_while }))
                     ctx.status() = air_status_next;
                   else if(ctx.status() != air_status_next) {
@@ -1172,6 +1977,7 @@ solidify(AVM_Rod& rod)
 
           AVM_Rod::Uparam up2;
           up2.b0 = altr.negative;
+          up2.b1 = altr.scopeless_body;
 
           struct Sparam
             {
@@ -1190,11 +1996,13 @@ solidify(AVM_Rod& rod)
               __attribute__((__hot__, __flatten__))
               {
                 const bool negative = head->uparam.b0;
+                const bool scopeless_body = head->uparam.b1;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
                 // This is the same as a `while` loop in other languages. A
                 // `break while` statement shall terminate the loop and return
                 // `air_status_next` to resume execution after the loop body.
+                opt<Executive_Context> ctx_body;
                 for(;;) {
                   sp.rod_cond.execute(ctx);
                   ASTERIA_ASSERT(ctx.status() == air_status_next);
@@ -1203,7 +2011,7 @@ solidify(AVM_Rod& rod)
                     break;
                   }
 
-                  do_execute_block(sp.rod_body, ctx);
+                  do_execute_loop_body(sp.rod_body, scopeless_body, ctx, ctx_body);
                   if(is_any_of(ctx.status(), { air_status_continue, air_status_continue_while }))
                     ctx.status() = air_status_next;
                   else if(ctx.status() != air_status_next) {
@@ -1257,10 +2065,14 @@ solidify(AVM_Rod& rod)
           do_solidify_nodes(sp2.rod_body, altr.code_body);
           do_solidify_nodes(sp2.rod_complete, altr.code_complete);
 
+          AVM_Rod::Uparam up2;
+          up2.b0 = altr.scopeless_body;
+
           rod.push_function(
             +[](Executive_Context& ctx, const AVM_Rod::Header* head)
               __attribute__((__hot__, __flatten__))
               {
+                const bool scopeless_body = head->uparam.b0;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
                 // This is the same as a `for` loop in other languages. A `break for`
@@ -1270,10 +2082,10 @@ solidify(AVM_Rod& rod)
                 // outlast every iteration.
                 Executive_Context ctx_for(xtc_plain, ctx);
                 try {
-                  // Create key and mapped references.
-                  if(!sp.name_key.empty())
-                    ctx_for.insert_named_reference(sp.name_key);
-                  ctx_for.insert_named_reference(sp.name_mapped);
+                  // Create key and mapped references, which occupy the first two
+                  // slots.
+                  ctx_for.insert_slotted_reference(0, sp.name_key);
+                  ctx_for.insert_slotted_reference(1, sp.name_mapped);
 
                   // Evaluate the range initializer and set the range up, which isn't
                   // going to change for all loops.
@@ -1282,13 +2094,14 @@ solidify(AVM_Rod& rod)
 
                   Reference* qkey_ref = nullptr;
                   if(!sp.name_key.empty())
-                    qkey_ref = ctx_for.mut_named_reference_opt(sp.name_key);
+                    qkey_ref = ctx_for.mut_slotted_reference_opt(0);
 
-                  Reference* mapped_ref = ctx_for.mut_named_reference_opt(sp.name_mapped);
+                  Reference* mapped_ref = ctx_for.mut_slotted_reference_opt(1);
                   ASTERIA_ASSERT(mapped_ref);
                   *mapped_ref = move(ctx_for.stack().mut_top());
 
                   auto range = mapped_ref->dereference_readonly();
+                  opt<Executive_Context> ctx_body;
                   if(range.is_array()) {
                     const auto& arr = range.as_array();
                     mapped_ref->push_subscript(Subscript::S_array_head());  // placeholder
@@ -1318,7 +2131,7 @@ solidify(AVM_Rod& rod)
                       ++ index;
 
                       // Execute the loop body.
-                      do_execute_block(sp.rod_body, ctx_for);
+                      do_execute_loop_body(sp.rod_body, scopeless_body, ctx_for, ctx_body);
                       if(is_any_of(ctx.status(), { air_status_continue, air_status_continue_for }))
                         ctx.status() = air_status_next;
                       else if(ctx.status() != air_status_next) {
@@ -1357,7 +2170,44 @@ solidify(AVM_Rod& rod)
                       ++ cur_it;
 
                       // Execute the loop body.
-                      do_execute_block(sp.rod_body, ctx_for);
+                      do_execute_loop_body(sp.rod_body, scopeless_body, ctx_for, ctx_body);
+                      if(is_any_of(ctx.status(), { air_status_continue, air_status_continue_for }))
+                        ctx.status() = air_status_next;
+                      else if(ctx.status() != air_status_next) {
+                        if(is_any_of(ctx.status(), { air_status_break, air_status_break_for }))
+                          ctx.status() = air_status_next;
+                        break;
+                      }
+                    }
+                  }
+                  else if(range.is_function() && range.as_function().is_generator()) {
+                    const auto& gen = range.as_function();
+                    Value val;
+                    int64_t index = 0;
+                    for(;;) {
+                      if(!gen.resume(val, ctx.global())) {
+                        do_execute_block(sp.rod_complete, ctx);
+                        break;
+                      }
+
+                      // Set the key variable which is the number of values that
+                      // have been yielded before.
+                      if(qkey_ref) {
+                        auto key_var = qkey_ref->unphase_variable_opt();
+                        if(!key_var) {
+                          key_var = ctx.global().garbage_collector()->create_variable();
+                          qkey_ref->set_variable(key_var);
+                        }
+                        key_var->initialize(index);
+                        key_var->set_immutable();
+                      }
+
+                      // Set the mapped reference to the value that has been yielded.
+                      mapped_ref->set_temporary(move(val));
+                      ++ index;
+
+                      // Execute the loop body.
+                      do_execute_loop_body(sp.rod_body, scopeless_body, ctx_for, ctx_body);
                       if(is_any_of(ctx.status(), { air_status_continue, air_status_continue_for }))
                         ctx.status() = air_status_next;
                       else if(ctx.status() != air_status_next) {
@@ -1379,7 +2229,7 @@ solidify(AVM_Rod& rod)
               }
 
             // Uparam
-            , AVM_Rod::Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
@@ -1419,10 +2269,14 @@ solidify(AVM_Rod& rod)
           do_solidify_nodes(sp2.rod_body, altr.code_body);
           do_solidify_nodes(sp2.rod_complete, altr.code_complete);
 
+          AVM_Rod::Uparam up2;
+          up2.b0 = altr.scopeless_body;
+
           rod.push_function(
             +[](Executive_Context& ctx, const AVM_Rod::Header* head)
               __attribute__((__hot__, __flatten__))
               {
+                const bool scopeless_body = head->uparam.b0;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
                 // This is the same as a `for` loop in other languages. A `break for`
@@ -1437,6 +2291,7 @@ solidify(AVM_Rod& rod)
                   sp.rod_init.execute(ctx_for);
                   ASTERIA_ASSERT(ctx_for.status() == air_status_next);
 
+                  opt<Executive_Context> ctx_body;
                   for(;;) {
                     // Check the condition. If the condition is empty, then it is
                     // always true, and the loop is infinite.
@@ -1447,7 +2302,7 @@ solidify(AVM_Rod& rod)
                       break;
                     }
 
-                    do_execute_block(sp.rod_body, ctx_for);
+                    do_execute_loop_body(sp.rod_body, scopeless_body, ctx_for, ctx_body);
                     if(is_any_of(ctx.status(), { air_status_continue, air_status_continue_for }))
                       ctx.status() = air_status_next;
                     else if(ctx.status() != air_status_next) {
@@ -1469,7 +2324,7 @@ solidify(AVM_Rod& rod)
               }
 
             // Uparam
-            , AVM_Rod::Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
@@ -1527,6 +2382,8 @@ solidify(AVM_Rod& rod)
                   // Append a frame due to exit of the `try` clause.
                   // Reuse the exception object. Don't bother allocating a new one.
                   except.push_frame_try(try_sloc);
+                  if(except.is_uncatchable())
+                    throw;
 
                   // This branch must be executed inside this `catch` block.
                   // User-provided bindings may obtain the current exception using
@@ -1546,7 +2403,7 @@ solidify(AVM_Rod& rod)
                     }
 
                     ctx_catch.insert_named_reference(&"__backtrace").set_temporary(move(backtrace));
-                    ctx_catch.insert_named_reference(sp.name_except).set_temporary(except.value());
+                    ctx_catch.insert_slotted_reference(0, sp.name_except).set_temporary(except.value());
 
                     // Execute the `catch` clause.
                     sp.rod_catch.execute(ctx_catch);
@@ -1740,18 +2597,10 @@ solidify(AVM_Rod& rod)
               {
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                // Look for the name in the global context.
-                auto qref = ctx.global().get_named_reference_opt(sp.name);
-                if(!qref)
-                  throw Runtime_Error(xtc_format,
-                           "Undeclared identifier `$1`", sp.name);
-
-                if(qref->is_invalid())
-                  throw Runtime_Error(xtc_format,
-                           "Global reference `$1` is uninitialized", sp.name);
-
-                // Push a copy of the reference onto the stack.
-                ctx.stack().push() = *qref;
+                // Look for the name in the global context, then push a copy
+                // of the reference onto the stack.
+                const auto& gref = do_get_global_reference_cached(ctx.global(), sp.name);
+                ctx.stack().push() = gref;
               }
 
             // Uparam
@@ -1775,6 +2624,7 @@ solidify(AVM_Rod& rod)
 
           AVM_Rod::Uparam up2;
           up2.u01 = altr.depth;
+          up2.u2345 = altr.slot;
 
           struct Sparam
             {
@@ -1784,6 +2634,46 @@ solidify(AVM_Rod& rod)
           Sparam sp2;
           sp2.name = altr.name;
 
+          if(altr.slot != UINT32_MAX) {
+            rod.push_function(
+              +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+                __attribute__((__hot__, __flatten__))
+                {
+                  const uint32_t depth = head->uparam.u01;
+                  const uint32_t slot = head->uparam.u2345;
+                  const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+                  // Locate the target context.
+                  const Executive_Context* qctx = &ctx;
+                  for(uint32_t k = 0;  k != depth;  ++k)
+                    qctx = qctx->get_parent_opt();
+
+                  // Get the reference by its slot. If the slot has not been
+                  // initialized, its declaration must have been bypassed.
+                  auto qref = qctx->get_slotted_reference_opt(slot);
+                  if(!qref || qref->is_invalid())
+                    throw Runtime_Error(xtc_format,
+                             "Initialization of `$1` was bypassed", sp.name);
+
+                  // Push a copy of the reference onto the stack.
+                  ctx.stack().push() = *qref;
+                }
+
+              // Uparam
+              , up2
+
+              // Sparam
+              , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+              // Collector
+              , nullptr
+
+              // Symbols
+              , &(altr.sloc)
+            );
+            return;
+          }
+
           rod.push_function(
             +[](Executive_Context& ctx, const AVM_Rod::Header* head)
               __attribute__((__hot__, __flatten__))
@@ -1875,28 +2765,60 @@ solidify(AVM_Rod& rod)
               Compiler_Options opts;
               cow_string func;
               cow_vector<phcow_string> params;
+              bool generator;
               cow_vector<AIR_Node> code_body;
+              cow_vector<AIR_Node> captures;
+              refcnt_ptr<const Instantiated_Function> proto;
             };
 
           Sparam sp2;
           sp2.opts = altr.opts;
           sp2.func = altr.func;
           sp2.params = altr.params;
+          sp2.generator = altr.generator;
           sp2.code_body = altr.code_body;
 
+          // Replace names outside the function with captured references, and
+          // solidify the body only once. Each evaluation of this node has only
+          // to bind these captures.
+          bool dirty = false;
+          auto code_proto = altr.code_body;
+          do_capture_nodes(dirty, sp2.captures, code_proto, 0);
+
+          AIR_Optimizer optmz(altr.opts);
+          optmz.rebind(nullptr, altr.params, altr.generator, code_proto);
+          sp2.proto = optmz.create_prototype(altr.sloc, altr.func);
+
           rod.push_function(
             +[](Executive_Context& ctx, const AVM_Rod::Header* head)
-              __attribute__((__cold__))
+              __attribute__((__hot__, __flatten__))
               {
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
                 const auto& sloc = *(head->pv_meta->sloc_opt);
 
-                // Instantiate the function.
-                AIR_Optimizer optmz(sp.opts);
-                optmz.rebind(&ctx, sp.params, sp.code_body);
+                // Bind captured references.
+                cow_vector<Reference> captured;
+                captured.reserve(sp.captures.size());
+                for(size_t k = 0;  k < sp.captures.size();  ++k)
+                  if(auto qnode = sp.captures.at(k).rebind_opt(ctx))
+                    captured.emplace_back(move(qnode->mut<S_push_bound_reference>().ref));
+
+                if(captured.size() == sp.captures.size()) {
+                  // Create a closure that shares the body of the prototype, and
+                  // push it as a temporary value.
+                  auto qfunc = make_refcnt<Instantiated_Function>(sp.proto, move(captured));
+                  ctx.stack().push().set_temporary(cow_function(move(qfunc)));
+                  return;
+                }
+
+                // Some names have not been declared, probably because they have
+                // been bypassed. Instantiate the function the slow way, which
+                // reports errors when the function is called.
+                AIR_Optimizer optmz_slow(sp.opts);
+                optmz_slow.rebind(&ctx, sp.params, sp.generator, sp.code_body);
 
                 // Push the function as a temporary value.
-                ctx.stack().push().set_temporary(optmz.create_function(sloc, sp.func));
+                ctx.stack().push().set_temporary(optmz_slow.create_function(sloc, sp.func));
               }
 
             // Uparam
@@ -2111,7 +3033,7 @@ solidify(AVM_Rod& rod)
 
                     if(rhs.is_integer()) {
                       // ++ integer ; may overflow
-                      V_integer& val = rhs.open_integer();
+                      V_integer val = rhs.as_integer();
                       bool ovr = false;
                       V_integer result = addm(val, 1, &ovr);
                       if(ovr)
@@ -2119,15 +3041,15 @@ solidify(AVM_Rod& rod)
                            "Integer increment overflow (operand was `$1`)", val);
                       if(postfix)
                         top.set_temporary(val);
-                      val = result;
+                      rhs.open_integer() = result;
                     }
                     else if(rhs.is_real()) {
                       // ++ real ; can't overflow
-                      V_real& val = rhs.open_real();
+                      V_real val = rhs.as_real();
                       V_real result = val + 1;
                       if(postfix)
                         top.set_temporary(val);
-                      val = result;
+                      rhs.open_real() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -2155,7 +3077,7 @@ solidify(AVM_Rod& rod)
 
                     if(rhs.is_integer()) {
                       // -- integer ; may overflow
-                      V_integer& val = rhs.open_integer();
+                      V_integer val = rhs.as_integer();
                       bool ovr = false;
                       V_integer result = subm(val, 1, &ovr);
                       if(ovr)
@@ -2163,15 +3085,15 @@ solidify(AVM_Rod& rod)
                            "Integer increment overflow (operand was `$1`)", val);
                       if(postfix)
                         top.set_temporary(val);
-                      val = result;
+                      rhs.open_integer() = result;
                     }
                     else if(rhs.is_real()) {
                       // -- real ; can't overflow
-                      V_real& val = rhs.open_real();
+                      V_real val = rhs.as_real();
                       V_real result = val - 1;
                       if(postfix)
                         top.set_temporary(val);
-                      val = result;
+                      rhs.open_real() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -2388,17 +3310,17 @@ solidify(AVM_Rod& rod)
 
                     if(rhs.is_integer()) {
                       // - integer ; may overflow
-                      V_integer& val = rhs.open_integer();
+                      V_integer val = rhs.as_integer();
                       bool ovr = false;
                       V_integer result = subm(0, val, &ovr);
                       if(ovr)
                         throw Runtime_Error(xtc_format,
                            "Integer negation overflow (operand was `$1`)", val);
-                      val = result;
+                      rhs.open_integer() = result;
                     }
                     else if(rhs.is_real()) {
                       // - real ; can't overflow
-                      V_real& val = rhs.open_real();
+                      auto&& val = rhs.open_real();
                       val = -val;
                     }
                     else
@@ -2427,12 +3349,12 @@ solidify(AVM_Rod& rod)
 
                     if(rhs.is_integer()) {
                       // ~ integer
-                      V_integer& val = rhs.open_integer();
+                      auto&& val = rhs.open_integer();
                       val = ~val;
                     }
                     else if(rhs.is_boolean()) {
                       // ~ boolean ; same as !
-                      V_boolean& val = rhs.open_boolean();
+                      auto&& val = rhs.open_boolean();
                       val = !val;
                     }
                     else if(rhs.is_string()) {
@@ -2641,17 +3563,17 @@ solidify(AVM_Rod& rod)
 
                     if(rhs.is_integer()) {
                       // __abs integer ; may overflow
-                      V_integer& val = rhs.open_integer();
+                      V_integer val = rhs.as_integer();
                       bool ovr = false;
                       V_integer negv = subm(0, val, &ovr);
                       if(ovr)
                         throw Runtime_Error(xtc_format,
                            "Integer absolute value overflow (operand was `$1`)", val);
-                      val = ((val ^ negv) & (val >> 63)) ^ val;
+                      rhs.open_integer() = ((val ^ negv) & (val >> 63)) ^ val;
                     }
                     else if(rhs.is_real()) {
                       // __abs real
-                      V_real& val = rhs.open_real();
+                      auto&& val = rhs.open_real();
                       val = ::std::fabs(val);
                     }
                     else
@@ -2968,7 +3890,7 @@ solidify(AVM_Rod& rod)
 
                     if(rhs.is_integer()) {
                       // __lzcnt integer
-                      V_integer& val = rhs.open_integer();
+                      auto&& val = rhs.open_integer();
                       val = static_cast<V_integer>(lzcnt64(static_cast<uint64_t>(val)));
                     }
                     else
@@ -2997,7 +3919,7 @@ solidify(AVM_Rod& rod)
 
                     if(rhs.is_integer()) {
                       // __tzcnt integer
-                      V_integer& val = rhs.open_integer();
+                      auto&& val = rhs.open_integer();
                       val = static_cast<V_integer>(tzcnt64(static_cast<uint64_t>(val)));
                     }
                     else
@@ -3026,7 +3948,7 @@ solidify(AVM_Rod& rod)
 
                     if(rhs.is_integer()) {
                       // __popcnt integer
-                      V_integer& val = rhs.open_integer();
+                      auto&& val = rhs.open_integer();
                       val = static_cast<V_integer>(popcnt64(static_cast<uint64_t>(val)));
                     }
                     else
@@ -3275,22 +4197,22 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // integer + integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = addm(val, rhs.as_integer(), &ovr);
                       if(ovr)
                         throw Runtime_Error(xtc_format,
                            "Integer addition overflow (operands were `$1` and `$2`)", val, rhs.as_integer());
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else if(lhs.is_real() && rhs.is_real()) {
                       // real + real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val += rhs.as_real();
                     }
                     else if(lhs.is_boolean() && rhs.is_boolean()) {
                       // boolean + boolean ; same as |
-                      V_boolean& val = lhs.open_boolean();
+                      auto&& val = lhs.open_boolean();
                       val |= rhs.as_boolean();
                     }
                     else if(lhs.is_string() && rhs.is_string()) {
@@ -3327,17 +4249,17 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // integer - integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = subm(val, rhs.as_integer(), &ovr);
                       if(ovr)
                         throw Runtime_Error(xtc_format,
                            "Integer subtraction overflow (operands were `$1` and `$2`)", val, rhs.as_integer());
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else if(lhs.is_real() && rhs.is_real()) {
                       // real - real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val -= rhs.as_real();
                     }
                     else
@@ -3369,22 +4291,22 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // integer * integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = mulm(val, rhs.as_integer(), &ovr);
                       if(ovr)
                         throw Runtime_Error(xtc_format,
                            "Integer multiplication overflow (operands were `$1` and `$2`)", val, rhs.as_integer());
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else if(lhs.is_real() && rhs.is_real()) {
                       // real * real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val *= rhs.as_real();
                     }
                     else if(lhs.is_boolean() && rhs.is_boolean()) {
                       // boolean * boolean ; same as &
-                      V_boolean& val = lhs.open_boolean();
+                      auto&& val = lhs.open_boolean();
                       val &= rhs.as_boolean();
                     }
                     else if(lhs.is_string() && rhs.is_integer()) {
@@ -3436,7 +4358,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // integer / integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       if(rhs.as_integer() == 0)
                         throw Runtime_Error(xtc_format,
                            "Integer division by zero (operands were `$1` and `$2`)", val, rhs.as_integer());
@@ -3447,7 +4369,7 @@ solidify(AVM_Rod& rod)
                     }
                     else if(lhs.is_real() && rhs.is_real()) {
                       // real / real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val /= rhs.as_real();
                     }
                     else if(lhs.is_string() && rhs.is_string()) {
@@ -3485,7 +4407,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // integer % integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       if(rhs.as_integer() == 0)
                         throw Runtime_Error(xtc_format,
                            "Integer division by zero (operands were `$1` and `$2`)", val, rhs.as_integer());
@@ -3496,7 +4418,7 @@ solidify(AVM_Rod& rod)
                     }
                     else if(lhs.is_real() && rhs.is_real()) {
                       // real % real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val = ::std::fmod(val, rhs.as_real());
                     }
                     else
@@ -3528,12 +4450,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // integer & integer
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       val &= rhs.as_integer();
                     }
                     else if(lhs.is_boolean() && rhs.is_boolean()) {
                       // boolean & boolean
-                      V_boolean& val = lhs.open_boolean();
+                      auto&& val = lhs.open_boolean();
                       val &= rhs.as_boolean();
                     }
                     else if(lhs.is_string() && rhs.is_string()) {
@@ -3575,12 +4497,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // integer | integer
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       val |= rhs.as_integer();
                     }
                     else if(lhs.is_boolean() && rhs.is_boolean()) {
                       // boolean & boolean
-                      V_boolean& val = lhs.open_boolean();
+                      auto&& val = lhs.open_boolean();
                       val |= rhs.as_boolean();
                     }
                     else if(lhs.is_string() && rhs.is_string()) {
@@ -3622,12 +4544,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // integer ^ integer
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       val ^= rhs.as_integer();
                     }
                     else if(lhs.is_boolean() && rhs.is_boolean()) {
                       // boolean ^ boolean
-                      V_boolean& val = lhs.open_boolean();
+                      auto&& val = lhs.open_boolean();
                       val ^= rhs.as_boolean();
                     }
                     else if(lhs.is_string() && rhs.is_string()) {
@@ -3669,9 +4591,9 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // __addm integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       V_integer result = addm(val, rhs.as_integer());
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -3702,9 +4624,9 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // __subm integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       V_integer result = subm(val, rhs.as_integer());
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -3735,9 +4657,9 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // __mulm integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       V_integer result = mulm(val, rhs.as_integer());
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -3768,12 +4690,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // __adds integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = addm(val, rhs.as_integer(), &ovr);
                       if(ovr)
                         result = (val >> 63) ^ INT64_MAX;
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -3804,12 +4726,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // __subs integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = subm(val, rhs.as_integer(), &ovr);
                       if(ovr)
                         result = (val >> 63) ^ INT64_MAX;
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -3840,12 +4762,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer() && rhs.is_integer()) {
                       // __muls integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = mulm(val, rhs.as_integer(), &ovr);
                       if(ovr)
                         result = (val >> 63) ^ (rhs.as_integer() >> 63) ^ INT64_MAX;
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -3884,10 +4806,10 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer <<< ; bitwise, fixed-width
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       int64_t n = min(rhs.as_integer(), 63);
-                      reinterpret_cast<uint64_t&>(val) <<= n;
-                      reinterpret_cast<uint64_t&>(val) <<= n != rhs.as_integer();
+                      uint64_t bits = static_cast<uint64_t>(val) << n;
+                      val = static_cast<V_integer>(bits << (n != rhs.as_integer()));
                     }
                     else if(lhs.is_string()) {
                       // string <<< ; bytewise, fixed-width
@@ -3940,10 +4862,10 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer >>> ; bitwise, fixed-width
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       int64_t n = min(rhs.as_integer(), 63);
-                      reinterpret_cast<uint64_t&>(val) >>= n;
-                      reinterpret_cast<uint64_t&>(val) >>= n != rhs.as_integer();
+                      uint64_t bits = static_cast<uint64_t>(val) >> n;
+                      val = static_cast<V_integer>(bits >> (n != rhs.as_integer()));
                     }
                     else if(lhs.is_string()) {
                       // string >>> ; bytewise, fixed-width
@@ -3996,12 +4918,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer <<< ; bitwise, variable-width, may overflow
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       int64_t n = min(rhs.as_integer(), 63);
                       if((val != 0) && ((n != rhs.as_integer()) || (val >> (63 - n) != val >> 63)))
                         throw Runtime_Error(xtc_format,
                            "Arithmetic left shift overflow (operands were `$1` and `$2`)", lhs, rhs);
-                      reinterpret_cast<uint64_t&>(val) <<= n;
+                      val = static_cast<V_integer>(static_cast<uint64_t>(val) << n);
                     }
                     else if(lhs.is_string()) {
                       // string <<< ; bytewise, variable-width
@@ -4052,7 +4974,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer <<< ; bitwise, variable-width, may overflow
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       int64_t n = min(rhs.as_integer(), 63);
                       val >>= n;
                     }
@@ -4099,7 +5021,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_real() && mid.is_real() && rhs.is_real()) {
                       // __fma ; always real
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val = ::std::fma(val, mid.as_real(), rhs.as_real());
                     }
                     else
@@ -4241,6 +5163,8 @@ solidify(AVM_Rod& rod)
 
           AVM_Rod::Uparam up2;
           up2.b0 = altr.immutable;
+          up2.b1 = altr.untracked;
+          up2.u2345 = altr.slot;
 
           struct Sparam
             {
@@ -4255,13 +5179,14 @@ solidify(AVM_Rod& rod)
               __attribute__((__hot__, __flatten__))
               {
                 const bool immutable = head->uparam.b0;
+                const bool untracked = head->uparam.b1;
+                const uint32_t slot = head->uparam.u2345;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
                 const auto& sloc = *(head->pv_meta->sloc_opt);
 
                 // Allocate a variable and inject it into the current context.
-                const auto gcoll = ctx.global().garbage_collector();
-                const auto var = gcoll->create_variable();
-                ctx.insert_named_reference(sp.name).set_variable(var);
+                const auto var = do_create_variable(ctx, untracked);
+                ctx.insert_slotted_reference(slot, sp.name).set_variable(var);
                 ctx.global().call_hook(&Abstract_Hooks::on_declare, sloc, sp.name);
 
                 // Initialize it to null.
@@ -4549,6 +5474,9 @@ solidify(AVM_Rod& rod)
         {
           const auto& altr = this->m_stor.as<S_declare_reference>();
 
+          AVM_Rod::Uparam up2;
+          up2.u2345 = altr.slot;
+
           struct Sparam
             {
               phcow_string name;
@@ -4561,14 +5489,15 @@ solidify(AVM_Rod& rod)
             +[](Executive_Context& ctx, const AVM_Rod::Header* head)
               __attribute__((__hot__, __flatten__))
               {
+                const uint32_t slot = head->uparam.u2345;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
                 // Declare a void reference.
-                ctx.insert_named_reference(sp.name).clear();
+                ctx.insert_slotted_reference(slot, sp.name).clear();
               }
 
             // Uparam
-            , AVM_Rod::Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
@@ -4586,6 +5515,9 @@ solidify(AVM_Rod& rod)
         {
           const auto& altr = this->m_stor.as<S_initialize_reference>();
 
+          AVM_Rod::Uparam up2;
+          up2.u2345 = altr.slot;
+
           struct Sparam
             {
               phcow_string name;
@@ -4598,15 +5530,16 @@ solidify(AVM_Rod& rod)
             +[](Executive_Context& ctx, const AVM_Rod::Header* head)
               __attribute__((__hot__, __flatten__))
               {
+                const uint32_t slot = head->uparam.u2345;
                 const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
                 // Move a reference from the stack into the current context.
-                ctx.insert_named_reference(sp.name) = move(ctx.stack().mut_top());
+                ctx.insert_slotted_reference(slot, sp.name) = move(ctx.stack().mut_top());
                 ctx.stack().pop();
               }
 
             // Uparam
-            , AVM_Rod::Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
@@ -4649,6 +5582,9 @@ solidify(AVM_Rod& rod)
                   ASTERIA_ASSERT(ctx.status() == air_status_next);
                 }
                 catch(Runtime_Error& except) {
+                  if(except.is_uncatchable())
+                    throw;
+
                   exval = except.value();
                 }
 
@@ -5207,17 +6143,17 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer + integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = addm(val, irhs, &ovr);
                       if(ovr)
                         throw Runtime_Error(xtc_format,
                            "Integer addition overflow (operands were `$1` and `$2`)", val, irhs);
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else if(lhs.is_real()) {
                       // real + real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val += static_cast<V_real>(irhs);
                     }
                     else
@@ -5247,17 +6183,17 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer - integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = subm(val, irhs, &ovr);
                       if(ovr)
                         throw Runtime_Error(xtc_format,
                            "Integer subtraction overflow (operands were `$1` and `$2`)", val, irhs);
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else if(lhs.is_real()) {
                       // real - real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val -= static_cast<V_real>(irhs);
                     }
                     else
@@ -5287,17 +6223,17 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer * integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = mulm(val, irhs, &ovr);
                       if(ovr)
                         throw Runtime_Error(xtc_format,
                            "Integer multiplication overflow (operands were `$1` and `$2`)", val, irhs);
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else if(lhs.is_real()) {
                       // real * real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val *= static_cast<V_real>(irhs);
                     }
                     else if(lhs.is_string()) {
@@ -5337,7 +6273,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer / integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       if(irhs == 0)
                         throw Runtime_Error(xtc_format,
                            "Integer division by zero (operands were `$1` and `$2`)", val, irhs);
@@ -5348,7 +6284,7 @@ solidify(AVM_Rod& rod)
                     }
                     else if(lhs.is_real()) {
                       // real / real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val /= static_cast<V_real>(irhs);;
                     }
                     else
@@ -5378,7 +6314,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer % integer ; may overflow
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       if(irhs == 0)
                         throw Runtime_Error(xtc_format,
                            "Integer division by zero (operands were `$1` and `$2`)", val, irhs);
@@ -5389,7 +6325,7 @@ solidify(AVM_Rod& rod)
                     }
                     else if(lhs.is_real()) {
                       // real % real ; can't overflow
-                      V_real& val = lhs.open_real();
+                      auto&& val = lhs.open_real();
                       val = ::std::fmod(val, static_cast<V_real>(irhs));
                     }
                     else
@@ -5419,7 +6355,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer & integer
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       val &= irhs;
                     }
                     else
@@ -5449,7 +6385,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer | integer
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       val |= irhs;
                     }
                     else
@@ -5479,7 +6415,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer ^ integer
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       val ^= irhs;
                     }
                     else
@@ -5509,9 +6445,9 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // __addm integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       V_integer result = addm(val, irhs);
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -5540,9 +6476,9 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // __subm integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       V_integer result = subm(val, irhs);
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -5571,9 +6507,9 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // __mulm integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       V_integer result = mulm(val, irhs);
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -5602,12 +6538,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // __adds integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = addm(val, irhs, &ovr);
                       if(ovr)
                         result = (val >> 63) ^ INT64_MAX;
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -5636,12 +6572,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // __subs integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = subm(val, irhs, &ovr);
                       if(ovr)
                         result = (val >> 63) ^ INT64_MAX;
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -5670,12 +6606,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // __muls integer
-                      V_integer& val = lhs.open_integer();
+                      V_integer val = lhs.as_integer();
                       bool ovr = false;
                       V_integer result = mulm(val, irhs, &ovr);
                       if(ovr)
                         result = (val >> 63) ^ (irhs >> 63) ^ INT64_MAX;
-                      val = result;
+                      lhs.open_integer() = result;
                     }
                     else
                       throw Runtime_Error(xtc_format,
@@ -5708,10 +6644,10 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer <<< ; bitwise, fixed-width
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       int64_t n = min(irhs, 63);
-                      reinterpret_cast<uint64_t&>(val) <<= n;
-                      reinterpret_cast<uint64_t&>(val) <<= n != irhs;
+                      uint64_t bits = static_cast<uint64_t>(val) << n;
+                      val = static_cast<V_integer>(bits << (n != irhs));
                     }
                     else if(lhs.is_string()) {
                       // string <<< ; bytewise, fixed-width
@@ -5758,10 +6694,10 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer >>> ; bitwise, fixed-width
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       int64_t n = min(irhs, 63);
-                      reinterpret_cast<uint64_t&>(val) >>= n;
-                      reinterpret_cast<uint64_t&>(val) >>= n != irhs;
+                      uint64_t bits = static_cast<uint64_t>(val) >> n;
+                      val = static_cast<V_integer>(bits >> (n != irhs));
                     }
                     else if(lhs.is_string()) {
                       // string >>> ; bytewise, fixed-width
@@ -5808,12 +6744,12 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer <<< ; bitwise, variable-width, may overflow
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       int64_t n = min(irhs, 63);
                       if((val != 0) && ((n != irhs) || (val >> (63 - n) != val >> 63)))
                         throw Runtime_Error(xtc_format,
                            "Arithmetic left shift overflow (operands were `$1` and `$2`)", lhs, irhs);
-                      reinterpret_cast<uint64_t&>(val) <<= n;
+                      val = static_cast<V_integer>(static_cast<uint64_t>(val) << n);
                     }
                     else if(lhs.is_string()) {
                       // string <<< ; bytewise, variable-width
@@ -5858,7 +6794,7 @@ solidify(AVM_Rod& rod)
 
                     if(lhs.is_integer()) {
                       // integer <<< ; bitwise, variable-width, may overflow
-                      V_integer& val = lhs.open_integer();
+                      auto&& val = lhs.open_integer();
                       int64_t n = min(irhs, 63);
                       val >>= n;
                     }
@@ -5962,6 +6898,469 @@ solidify(AVM_Rod& rod)
           );
           return;
         }
+
+      case index_push_captured_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_captured_reference>();
+
+          AVM_Rod::Uparam up2;
+          up2.u01 = altr.depth;
+          up2.u2345 = altr.index;
+
+          rod.push_function(
+            +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+              __attribute__((__hot__, __flatten__))
+              {
+                const uint32_t depth = head->uparam.u01;
+                const uint32_t index = head->uparam.u2345;
+
+                // Locate the function context.
+                const Executive_Context* qctx = &ctx;
+                for(uint32_t k = 0;  k != depth;  ++k)
+                  qctx = qctx->get_parent_opt();
+
+                // Push a copy of the captured reference onto the stack.
+                ASTERIA_ASSERT(qctx->func_opt());
+                ctx.stack().push() = qctx->func_opt()->captured_reference(index);
+              }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+
+      case index_apply_operator_local_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_apply_operator_local_bi32>();
+
+          AVM_Rod::Uparam up2;
+          up2.b0 = altr.assign;
+          up2.i2345 = altr.irhs;
+
+          struct Sparam
+            {
+              phcow_string name;
+              uint32_t depth;
+              uint32_t slot;
+            };
+
+          Sparam sp2;
+          sp2.name = altr.name;
+          sp2.depth = altr.depth;
+          sp2.slot = altr.slot;
+
+          if(is_any_of(altr.xop, { xop_cmp_eq, xop_cmp_ne, xop_cmp_un, xop_cmp_lt,
+                                   xop_cmp_gt, xop_cmp_lte, xop_cmp_gte })) {
+            up2.u1 = static_cast<uint8_t>(do_encode_compare(altr.xop));
+            rod.push_function(
+              +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+                __attribute__((__hot__, __flatten__))
+                {
+                  const bool assign = head->uparam.b0;
+                  const uint32_t mask = head->uparam.u1;
+                  const V_integer irhs = head->uparam.i2345;
+                  const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                  const auto& local = do_get_slotted_reference(ctx, sp.depth, sp.slot, sp.name);
+
+                  if(!assign) {
+                    // The operand need not be copied.
+                    bool res = do_test_compare(local.dereference_readonly(), irhs, mask);
+                    ctx.stack().push().set_temporary(res);
+                    return;
+                  }
+
+                  Reference& top = ctx.stack().push();
+                  top = local;
+                  auto& lhs = top.dereference_mutable();
+                  lhs = do_test_compare(lhs, irhs, mask);
+                }
+
+              // Uparam
+              , up2
+
+              // Sparam
+              , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+              // Collector
+              , nullptr
+
+              // Symbols
+              , &(altr.sloc)
+            );
+            return;
+          }
+
+          if(altr.xop == xop_add) {
+            rod.push_function(
+              +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+                __attribute__((__hot__, __flatten__))
+                {
+                  const bool assign = head->uparam.b0;
+                  const V_integer irhs = head->uparam.i2345;
+                  const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                  Reference& top = ctx.stack().push();
+                  top = do_get_slotted_reference(ctx, sp.depth, sp.slot, sp.name);
+                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+                  if(lhs.is_integer()) {
+                    // integer + integer ; may overflow
+                    V_integer val = lhs.as_integer();
+                    bool ovr = false;
+                    V_integer result = addm(val, irhs, &ovr);
+                    if(ovr)
+                      throw Runtime_Error(xtc_format,
+                         "Integer addition overflow (operands were `$1` and `$2`)", val, irhs);
+                    lhs.open_integer() = result;
+                  }
+                  else if(lhs.is_real()) {
+                    // real + real ; can't overflow
+                    auto&& val = lhs.open_real();
+                    val += static_cast<V_real>(irhs);
+                  }
+                  else
+                    throw Runtime_Error(xtc_format,
+                       "Addition not applicable (operands were `$1` and `$2`)", lhs, irhs);
+                }
+
+              // Uparam
+              , up2
+
+              // Sparam
+              , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+              // Collector
+              , nullptr
+
+              // Symbols
+              , &(altr.sloc)
+            );
+            return;
+          }
+
+          if(altr.xop == xop_sub) {
+            rod.push_function(
+              +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+                __attribute__((__hot__, __flatten__))
+                {
+                  const bool assign = head->uparam.b0;
+                  const V_integer irhs = head->uparam.i2345;
+                  const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                  Reference& top = ctx.stack().push();
+                  top = do_get_slotted_reference(ctx, sp.depth, sp.slot, sp.name);
+                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+                  if(lhs.is_integer()) {
+                    // integer - integer ; may overflow
+                    V_integer val = lhs.as_integer();
+                    bool ovr = false;
+                    V_integer result = subm(val, irhs, &ovr);
+                    if(ovr)
+                      throw Runtime_Error(xtc_format,
+                         "Integer subtraction overflow (operands were `$1` and `$2`)", val, irhs);
+                    lhs.open_integer() = result;
+                  }
+                  else if(lhs.is_real()) {
+                    // real - real ; can't overflow
+                    auto&& val = lhs.open_real();
+                    val -= static_cast<V_real>(irhs);
+                  }
+                  else
+                    throw Runtime_Error(xtc_format,
+                       "Subtraction not applicable (operands were `$1` and `$2`)", lhs, irhs);
+                }
+
+              // Uparam
+              , up2
+
+              // Sparam
+              , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+              // Collector
+              , nullptr
+
+              // Symbols
+              , &(altr.sloc)
+            );
+            return;
+          }
+
+          ASTERIA_TERMINATE(("Fused node not implemented for `$1`"), altr.xop);
+        }
+
+      case index_branch_compare_bi32:
+        {
+          const auto& altr = this->m_stor.as<S_branch_compare_bi32>();
+
+          AVM_Rod::Uparam up2;
+          up2.u0 = static_cast<uint8_t>(do_encode_compare(altr.xop));
+          up2.i2345 = altr.irhs;
+
+          struct Sparam
+            {
+              AVM_Rod rod_true;
+              AVM_Rod rod_false;
+            };
+
+          Sparam sp2;
+          do_solidify_nodes(sp2.rod_true, altr.code_true);
+          do_solidify_nodes(sp2.rod_false, altr.code_false);
+
+          rod.push_function(
+            +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+              __attribute__((__hot__, __flatten__))
+              {
+                const uint32_t mask = head->uparam.u0;
+                const V_integer irhs = head->uparam.i2345;
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                Reference& top = ctx.stack().mut_top();
+
+                // Compare the operand and pick a branch. If the branch is empty,
+                // the result of comparison is the result.
+                bool res = do_test_compare(top.dereference_readonly(), irhs, mask);
+                top.set_temporary(res);
+                do_evaluate_subexpression(ctx, false, res ? sp.rod_true : sp.rod_false);
+              }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const AVM_Rod::Header* head)
+              {
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                sp.rod_true.collect_variables(staged, temp);
+                sp.rod_false.collect_variables(staged, temp);
+              }
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+
+      case index_push_global_member:
+        {
+          const auto& altr = this->m_stor.as<S_push_global_member>();
+
+          struct Sparam
+            {
+              phcow_string name;
+              cow_vector<phcow_string> keys;
+            };
+
+          Sparam sp2;
+          sp2.name = altr.name;
+          sp2.keys = altr.keys;
+
+          rod.push_function(
+            +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+              __attribute__((__hot__, __flatten__))
+              {
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+                // Look for the name in the global context. Push a copy of the
+                // reference onto the stack, then push all subscripts.
+                const auto& gref = do_get_global_reference_cached(ctx.global(), sp.name);
+                Reference& top = ctx.stack().push();
+                top = gref;
+
+                for(size_t k = 0;  k < sp.keys.size();  ++k) {
+                  Subscript::S_object_key xsub = { sp.keys.at(k) };
+                  do_push_subscript_and_check(top, move(xsub));
+                }
+              }
+
+            // Uparam
+            , AVM_Rod::Uparam()
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+
+      case index_counted_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_counted_for_statement>();
+
+          AVM_Rod::Uparam up2;
+          up2.b0 = altr.scopeless_body;
+
+          struct Sparam
+            {
+              AVM_Rod rod_init;
+              int64_t count;
+              AVM_Rod rod_body;
+              AVM_Rod rod_complete;
+            };
+
+          Sparam sp2;
+          do_solidify_nodes(sp2.rod_init, altr.code_init);
+          sp2.count = altr.count;
+          do_solidify_nodes(sp2.rod_body, altr.code_body);
+          do_solidify_nodes(sp2.rod_complete, altr.code_complete);
+
+          rod.push_function(
+            +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+              __attribute__((__hot__, __flatten__))
+              {
+                const bool scopeless_body = head->uparam.b0;
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+                // This is a `for` loop whose induction variable is referenced by
+                // neither the body nor anything else, so only the number of
+                // iterations matters.
+                Executive_Context ctx_for(xtc_plain, ctx);
+                try {
+                  sp.rod_init.execute(ctx_for);
+                  ASTERIA_ASSERT(ctx_for.status() == air_status_next);
+
+                  opt<Executive_Context> ctx_body;
+                  for(int64_t k = 0;  ;  ++k) {
+                    if(k >= sp.count) {
+                      do_execute_block(sp.rod_complete, ctx);
+                      break;
+                    }
+
+                    do_execute_loop_body(sp.rod_body, scopeless_body, ctx_for, ctx_body);
+                    if(is_any_of(ctx.status(), { air_status_continue, air_status_continue_for }))
+                      ctx.status() = air_status_next;
+                    else if(ctx.status() != air_status_next) {
+                      if(is_any_of(ctx.status(), { air_status_break, air_status_break_for }))
+                        ctx.status() = air_status_next;
+                      break;
+                    }
+                  }
+                }
+                catch(Runtime_Error& except) {
+                  ctx_for.on_scope_exit_exceptional(except);
+                  throw;
+                }
+                ctx_for.on_scope_exit_normal();
+              }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const AVM_Rod::Header* head)
+              {
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                sp.rod_init.collect_variables(staged, temp);
+                sp.rod_body.collect_variables(staged, temp);
+                sp.rod_complete.collect_variables(staged, temp);
+              }
+
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
+
+      case index_inline_call:
+        {
+          const auto& altr = this->m_stor.as<S_inline_call>();
+
+          struct Sparam
+            {
+              AVM_Rod rod_body;
+              Source_Location sloc_func;
+              cow_string func;
+            };
+
+          Sparam sp2;
+          do_solidify_nodes(sp2.rod_body, altr.code_body);
+          sp2.sloc_func = altr.sloc_func;
+          sp2.func = altr.func;
+
+          rod.push_function(
+            +[](Executive_Context& ctx, const AVM_Rod::Header* head)
+              __attribute__((__hot__, __flatten__))
+              {
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+                // Evaluate the body of the callee in the current context. A
+                // frame is added as if the function was called, so backtraces
+                // look the same.
+                try {
+                  sp.rod_body.execute(ctx);
+                  ASTERIA_ASSERT(ctx.status() == air_status_next);
+                }
+                catch(Runtime_Error& except) {
+                  except.push_frame_function(sp.sloc_func, sp.func);
+                  throw;
+                }
+              }
+
+            // Uparam
+            , AVM_Rod::Uparam()
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const AVM_Rod::Header* head)
+              {
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                sp.rod_body.collect_variables(staged, temp);
+              }
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+
+      case index_yield_statement:
+        {
+          const auto& altr = this->m_stor.as<S_yield_statement>();
+
+          rod.push_function(
+            +[](Executive_Context& ctx, const AVM_Rod::Header* /*head*/)
+              {
+                // Read a value and suspend the generator. Execution continues
+                // when it is resumed.
+                Value val = ctx.stack().mut_top().dereference_copy();
+                ctx.stack().pop();
+                Generator::yield(ctx, move(val));
+              }
+
+            // Uparam
+            , AVM_Rod::Uparam()
+
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
     }
   }
 
@@ -5,12 +5,1924 @@
 #include "../../runtime/air_optimizer.hpp"
 #include "../../runtime/air_node.hpp"
 #include "../../runtime/analytic_context.hpp"
+#include "../../runtime/executive_context.hpp"
+#include "../../runtime/global_context.hpp"
 #include "../../runtime/instantiated_function.hpp"
+#include "../../runtime/runtime_error.hpp"
 #include "../../runtime/enums.hpp"
 #include "../../compiler/statement.hpp"
 #include "../../compiler/expression_unit.hpp"
+#include "../../llds/avm_rod.hpp"
+#include "../../llds/reference_stack.hpp"
 #include "../../utils.hpp"
 namespace asteria {
+namespace {
+
+template<typename xElem>
+const xElem&
+do_elem(const cow_vector<xElem>& vec, size_t i)
+  {
+    return vec.at(i);
+  }
+
+template<typename xElem>
+xElem&
+do_elem(cow_vector<xElem>& vec, size_t i)
+  {
+    return vec.mut(i);
+  }
+
+template<typename xAltr>
+const xAltr&
+do_altr(const AIR_Node& node)
+  {
+    return node.as<xAltr>();
+  }
+
+template<typename xAltr>
+xAltr&
+do_altr(AIR_Node& node)
+  {
+    return node.mut<xAltr>();
+  }
+
+// Calls `func` on each sequence of nodes that is nested in `node`. Bodies of
+// closures are only visited if `closures` is set.
+template<typename xNode, typename xFunc>
+void
+do_for_each_nested(xNode& node, bool closures, xFunc&& func)
+  {
+    switch(node.index())
+      {
+      case AIR_Node::index_clear_stack:
+      case AIR_Node::index_declare_variable:
+      case AIR_Node::index_initialize_variable:
+      case AIR_Node::index_throw_statement:
+      case AIR_Node::index_yield_statement:
+      case AIR_Node::index_assert_statement:
+      case AIR_Node::index_simple_status:
+      case AIR_Node::index_check_argument:
+      case AIR_Node::index_push_global_reference:
+      case AIR_Node::index_push_local_reference:
+      case AIR_Node::index_push_bound_reference:
+      case AIR_Node::index_function_call:
+      case AIR_Node::index_push_unnamed_array:
+      case AIR_Node::index_push_unnamed_object:
+      case AIR_Node::index_apply_operator:
+      case AIR_Node::index_unpack_array:
+      case AIR_Node::index_unpack_object:
+      case AIR_Node::index_define_null_variable:
+      case AIR_Node::index_single_step_trap:
+      case AIR_Node::index_variadic_call:
+      case AIR_Node::index_import_call:
+      case AIR_Node::index_declare_reference:
+      case AIR_Node::index_initialize_reference:
+      case AIR_Node::index_return_statement:
+      case AIR_Node::index_push_constant:
+      case AIR_Node::index_alt_clear_stack:
+      case AIR_Node::index_alt_function_call:
+      case AIR_Node::index_member_access:
+      case AIR_Node::index_apply_operator_bi32:
+      case AIR_Node::index_return_statement_bi32:
+      case AIR_Node::index_check_null:
+      case AIR_Node::index_push_captured_reference:
+      case AIR_Node::index_apply_operator_local_bi32:
+      case AIR_Node::index_push_global_member:
+        return;
+
+      case AIR_Node::index_execute_block:
+        {
+          auto& altr = do_altr<AIR_Node::S_execute_block>(node);
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_if_statement:
+        {
+          auto& altr = do_altr<AIR_Node::S_if_statement>(node);
+          func(altr.code_true);
+          func(altr.code_false);
+          return;
+        }
+
+      case AIR_Node::index_switch_statement:
+        {
+          auto& altr = do_altr<AIR_Node::S_switch_statement>(node);
+          for(size_t i = 0;  i < altr.clauses.size();  ++i) {
+            auto& clause = do_elem(altr.clauses, i);
+            func(clause.code_labels);
+            func(clause.code_body);
+          }
+          return;
+        }
+
+      case AIR_Node::index_do_while_statement:
+        {
+          auto& altr = do_altr<AIR_Node::S_do_while_statement>(node);
+          func(altr.code_body);
+          func(altr.code_cond);
+          func(altr.code_complete);
+          return;
+        }
+
+      case AIR_Node::index_while_statement:
+        {
+          auto& altr = do_altr<AIR_Node::S_while_statement>(node);
+          func(altr.code_cond);
+          func(altr.code_body);
+          func(altr.code_complete);
+          return;
+        }
+
+      case AIR_Node::index_for_each_statement:
+        {
+          auto& altr = do_altr<AIR_Node::S_for_each_statement>(node);
+          func(altr.code_init);
+          func(altr.code_body);
+          func(altr.code_complete);
+          return;
+        }
+
+      case AIR_Node::index_for_statement:
+        {
+          auto& altr = do_altr<AIR_Node::S_for_statement>(node);
+          func(altr.code_init);
+          func(altr.code_cond);
+          func(altr.code_step);
+          func(altr.code_body);
+          func(altr.code_complete);
+          return;
+        }
+
+      case AIR_Node::index_counted_for_statement:
+        {
+          auto& altr = do_altr<AIR_Node::S_counted_for_statement>(node);
+          func(altr.code_init);
+          func(altr.code_body);
+          func(altr.code_complete);
+          return;
+        }
+
+      case AIR_Node::index_inline_call:
+        {
+          auto& altr = do_altr<AIR_Node::S_inline_call>(node);
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_try_statement:
+        {
+          auto& altr = do_altr<AIR_Node::S_try_statement>(node);
+          func(altr.code_try);
+          func(altr.code_catch);
+          return;
+        }
+
+      case AIR_Node::index_define_function:
+        {
+          auto& altr = do_altr<AIR_Node::S_define_function>(node);
+          if(closures)
+            func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_branch_expression:
+        {
+          auto& altr = do_altr<AIR_Node::S_branch_expression>(node);
+          func(altr.code_true);
+          func(altr.code_false);
+          return;
+        }
+
+      case AIR_Node::index_defer_expression:
+        {
+          auto& altr = do_altr<AIR_Node::S_defer_expression>(node);
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_catch_expression:
+        {
+          auto& altr = do_altr<AIR_Node::S_catch_expression>(node);
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_coalesce_expression:
+        {
+          auto& altr = do_altr<AIR_Node::S_coalesce_expression>(node);
+          func(altr.code_null);
+          return;
+        }
+
+      case AIR_Node::index_branch_compare_bi32:
+        {
+          auto& altr = do_altr<AIR_Node::S_branch_compare_bi32>(node);
+          func(altr.code_true);
+          func(altr.code_false);
+          return;
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), node.index());
+      }
+  }
+
+// Gets the number of operands of an operator that can be evaluated at compile
+// time. Zero is returned if the operator has side effects or yields a reference.
+uint32_t
+do_get_pure_operand_count(Xop xop)
+  {
+    switch(xop)
+      {
+      case xop_inc:
+      case xop_dec:
+      case xop_index:
+      case xop_unset:
+      case xop_assign:
+      case xop_head:
+      case xop_tail:
+      case xop_random:
+        return 0;
+
+      case xop_pos:
+      case xop_neg:
+      case xop_notb:
+      case xop_notl:
+      case xop_countof:
+      case xop_typeof:
+      case xop_sqrt:
+      case xop_isnan:
+      case xop_isinf:
+      case xop_abs:
+      case xop_sign:
+      case xop_round:
+      case xop_floor:
+      case xop_ceil:
+      case xop_trunc:
+      case xop_iround:
+      case xop_ifloor:
+      case xop_iceil:
+      case xop_itrunc:
+      case xop_lzcnt:
+      case xop_tzcnt:
+      case xop_popcnt:
+      case xop_isvoid:
+        return 1;
+
+      case xop_cmp_eq:
+      case xop_cmp_ne:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
+      case xop_cmp_3way:
+      case xop_cmp_un:
+      case xop_add:
+      case xop_sub:
+      case xop_mul:
+      case xop_div:
+      case xop_mod:
+      case xop_sll:
+      case xop_srl:
+      case xop_sla:
+      case xop_sra:
+      case xop_andb:
+      case xop_orb:
+      case xop_xorb:
+      case xop_addm:
+      case xop_subm:
+      case xop_mulm:
+      case xop_adds:
+      case xop_subs:
+      case xop_muls:
+        return 2;
+
+      case xop_fma:
+        return 3;
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), xop);
+      }
+  }
+
+bool
+do_is_constant(const AIR_Node& node)
+  {
+    return node.index() == AIR_Node::index_push_constant;
+  }
+
+bool
+do_is_same_local(const AIR_Node& node, const AIR_Node& other)
+  {
+    if((node.index() != AIR_Node::index_push_local_reference)
+       || (other.index() != AIR_Node::index_push_local_reference))
+      return false;
+
+    const auto& altr = node.as<AIR_Node::S_push_local_reference>();
+    const auto& oth = other.as<AIR_Node::S_push_local_reference>();
+    return (altr.depth == oth.depth) && (altr.slot == oth.slot) && (altr.name == oth.name);
+  }
+
+// Evaluates the last `count` nodes of `code`, which must have been checked
+// to be free of side effects.
+opt<Value>
+do_evaluate_tail_opt(const Global_Context& global, const cow_vector<AIR_Node>& code,
+                     size_t count)
+  {
+    AVM_Rod rod;
+    for(size_t k = code.size() - count;  k != code.size();  ++k)
+      code.at(k).solidify(rod);
+    rod.finalize();
+
+    // Pure operators never access the global context, so it is safe to cast
+    // `const` away.
+    AIR_Status status = air_status_next;
+    Reference_Stack stack, alt_stack;
+    Executive_Context ctx(xtc_defer, const_cast<Global_Context&>(global), status,
+                          stack, alt_stack);
+
+    opt<Value> res;
+    try {
+      rod.execute(ctx);
+      if((status == air_status_next) && (stack.size() == 1))
+        res = stack.top().dereference_readonly();
+    }
+    catch(Runtime_Error& /*except*/) {
+      // The error shall be raised at run time, if ever.
+    }
+    return res;
+  }
+
+// Replaces the last `count` nodes of `code` with a constant, if they can be
+// evaluated.
+bool
+do_fold_tail(cow_vector<AIR_Node>& code, const Global_Context& global, size_t count)
+  {
+    if(code.size() < count)
+      return false;
+
+    for(size_t k = code.size() - count;  k != code.size() - 1;  ++k)
+      if(!do_is_constant(code.at(k)))
+        return false;
+
+    auto qval = do_evaluate_tail_opt(global, code, count);
+    if(!qval)
+      return false;
+
+    code.pop_back(count);
+    AIR_Node::S_push_constant xnode = { move(*qval) };
+    code.emplace_back(move(xnode));
+    return true;
+  }
+
+bool
+do_has_string_operand(const cow_vector<AIR_Node>& code, size_t count)
+  {
+    for(size_t k = code.size() - count;  k != code.size() - 1;  ++k)
+      if(code.at(k).as<AIR_Node::S_push_constant>().val.is_string())
+        return true;
+    return false;
+  }
+
+void
+do_append_folded(cow_vector<AIR_Node>& code, const Global_Context& global,
+                 AIR_Node&& node);
+
+void
+do_append_folded_sequence(cow_vector<AIR_Node>& code, const Global_Context& global,
+                          const cow_vector<AIR_Node>& src)
+  {
+    for(size_t i = 0;  i < src.size();  ++i) {
+      AIR_Node node = src.at(i);
+      do_append_folded(code, global, move(node));
+    }
+  }
+
+// Appends `node` to `code`, and then attempts to fold it with its preceding
+// constant operands.
+void
+do_append_folded(cow_vector<AIR_Node>& code, const Global_Context& global,
+                 AIR_Node&& node)
+  {
+    code.emplace_back(move(node));
+    const auto& back = code.back();
+
+    if((back.index() == AIR_Node::index_apply_operator) && (code.size() >= 4)
+       && back.as<AIR_Node::S_apply_operator>().assign
+       && (back.as<AIR_Node::S_apply_operator>().xop == xop_assign)
+       && do_is_same_local(code.at(code.size() - 4), code.at(code.size() - 3))
+       && (code.at(code.size() - 2).index() == AIR_Node::index_apply_operator_bi32)) {
+      // Rewrite `x = x + 1` as `x += 1`, which modifies `x` in place.
+      auto altr = code.at(code.size() - 2).as<AIR_Node::S_apply_operator_bi32>();
+      if(altr.assign || is_any_of(altr.xop, { xop_assign, xop_index }))
+        return;
+
+      altr.assign = true;
+      code.pop_back(3);
+      code.emplace_back(move(altr));
+    }
+    else if(back.index() == AIR_Node::index_apply_operator) {
+      const auto& altr = back.as<AIR_Node::S_apply_operator>();
+      uint32_t nops = do_get_pure_operand_count(altr.xop);
+      if(altr.assign || (nops == 0) || (code.size() < nops + 1U))
+        return;
+
+      // Don't fold duplication of strings, which could produce a huge result.
+      if(is_any_of(altr.xop, { xop_mul, xop_sll, xop_srl, xop_sla, xop_sra })
+         && do_is_constant(code.at(code.size() - 2))
+         && do_is_constant(code.at(code.size() - 3))
+         && do_has_string_operand(code, nops + 1U))
+        return;
+
+      do_fold_tail(code, global, nops + 1U);
+    }
+    else if(back.index() == AIR_Node::index_apply_operator_bi32) {
+      const auto& altr = back.as<AIR_Node::S_apply_operator_bi32>();
+      if(altr.assign || (do_get_pure_operand_count(altr.xop) != 2) || (code.size() < 2))
+        return;
+
+      if(is_any_of(altr.xop, { xop_mul, xop_sll, xop_srl, xop_sla, xop_sra })
+         && do_is_constant(code.at(code.size() - 2))
+         && do_has_string_operand(code, 2))
+        return;
+
+      do_fold_tail(code, global, 2);
+    }
+    else if(back.index() == AIR_Node::index_check_null)
+      do_fold_tail(code, global, 2);
+    else if(back.index() == AIR_Node::index_push_unnamed_array) {
+      // Arrays are copy-on-write, so a literal of constants can be shared.
+      const auto& altr = back.as<AIR_Node::S_push_unnamed_array>();
+      do_fold_tail(code, global, altr.nelems + 1U);
+    }
+    else if(back.index() == AIR_Node::index_push_unnamed_object) {
+      const auto& altr = back.as<AIR_Node::S_push_unnamed_object>();
+      do_fold_tail(code, global, altr.keys.size() + 1U);
+    }
+    else if((back.index() == AIR_Node::index_branch_expression) && (code.size() >= 2)
+            && do_is_constant(code.at(code.size() - 2))) {
+      // Select a branch according to the condition. If the branch is empty,
+      // the condition is the result.
+      auto altr = back.as<AIR_Node::S_branch_expression>();
+      if(altr.assign)
+        return;
+
+      code.pop_back();
+      const auto& cond = code.back().as<AIR_Node::S_push_constant>().val;
+      const auto& branch = cond.test() ? altr.code_true : altr.code_false;
+      if(branch.empty())
+        return;
+
+      code.pop_back();
+      do_append_folded_sequence(code, global, branch);
+    }
+    else if((back.index() == AIR_Node::index_coalesce_expression) && (code.size() >= 2)
+            && do_is_constant(code.at(code.size() - 2))) {
+      // Evaluate the alternative only if the condition is null.
+      auto altr = back.as<AIR_Node::S_coalesce_expression>();
+      if(altr.assign)
+        return;
+
+      code.pop_back();
+      const auto& cond = code.back().as<AIR_Node::S_push_constant>().val;
+      if(!cond.is_null() || altr.code_null.empty())
+        return;
+
+      code.pop_back();
+      do_append_folded_sequence(code, global, altr.code_null);
+    }
+    else if((back.index() == AIR_Node::index_return_statement) && (code.size() >= 2)
+            && do_is_constant(code.at(code.size() - 2))) {
+      // Encode the result like the code generator does.
+      auto altr = back.as<AIR_Node::S_return_statement>();
+      if(altr.is_void)
+        return;
+
+      const auto& val = code.at(code.size() - 2).as<AIR_Node::S_push_constant>().val;
+      AIR_Node::S_return_statement_bi32 xnode = { altr.sloc, type_null, 0 };
+      if(val.is_null())
+        xnode.type = type_null;
+      else if(val.is_boolean())
+        xnode.type = type_boolean, xnode.irhs = val.as_boolean();
+      else if(val.is_integer() && ((int32_t) val.as_integer() == val.as_integer()))
+        xnode.type = type_integer, xnode.irhs = (int32_t) val.as_integer();
+      else
+        return;
+
+      code.pop_back(2);
+      code.emplace_back(move(xnode));
+    }
+    else if((back.index() == AIR_Node::index_if_statement) && (code.size() >= 2)
+            && do_is_constant(code.at(code.size() - 2))) {
+      // Select a branch according to the condition. The condition is left on
+      // the stack, as the statement does not pop it.
+      auto altr = back.as<AIR_Node::S_if_statement>();
+      code.pop_back();
+      const auto& cond = code.back().as<AIR_Node::S_push_constant>().val;
+      bool taken = cond.test() != altr.negative;
+      auto& branch = taken ? altr.code_true : altr.code_false;
+      bool scopeless = taken ? altr.scopeless_true : altr.scopeless_false;
+      if(branch.empty())
+        return;
+
+      // A branch that declares no names has been generated into the enclosing
+      // scope, so it is spliced here. Otherwise it needs a scope of its own.
+      if(scopeless) {
+        do_append_folded_sequence(code, global, branch);
+        return;
+      }
+
+      AIR_Node::S_execute_block xnode = { move(branch) };
+      code.emplace_back(move(xnode));
+    }
+  }
+
+// Performs constant folding and removes unreachable code, recursively. The
+// bodies of closures have been optimized by their own optimizers.
+void
+do_fold_constants(cow_vector<AIR_Node>& code, const Global_Context& global)
+  {
+    cow_vector<AIR_Node> res;
+    res.reserve(code.size());
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      AIR_Node node = code.at(i);
+      do_for_each_nested(node, false,
+          [&](cow_vector<AIR_Node>& nested) { do_fold_constants(nested, global);  });
+
+      do_append_folded(res, global, move(node));
+
+      // Nodes after a terminator are unreachable.
+      if(!res.empty() && res.back().is_terminator())
+        break;
+    }
+
+    code.swap(res);
+  }
+
+void
+do_collect_referenced_names(cow_dictionary<bool>& names, const cow_vector<AIR_Node>& code)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code.at(i);
+      if(node.index() == AIR_Node::index_push_local_reference)
+        names.try_emplace(node.as<AIR_Node::S_push_local_reference>().name, true);
+      else if(node.index() == AIR_Node::index_push_global_reference)
+        names.try_emplace(node.as<AIR_Node::S_push_global_reference>().name, true);
+
+      do_for_each_nested(node, true,
+          [&](const cow_vector<AIR_Node>& nested) { do_collect_referenced_names(names, nested);  });
+    }
+  }
+
+// Collects names of local references that may be referenced by a value, or
+// outlive the current function. `pending` contains names that have been pushed
+// by the current statement, and whether they have been subscripted. This is
+// conservative, as shadowing names are not distinguished.
+void
+do_collect_escaping_names(cow_dictionary<bool>& names, cow_dictionary<bool>& pending,
+                          const cow_vector<AIR_Node>& code)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code.at(i);
+      bool by_ref = false;
+
+      if(node.index() == AIR_Node::index_clear_stack)
+        pending.clear();
+      else if(node.index() == AIR_Node::index_push_local_reference)
+        pending.try_emplace(node.as<AIR_Node::S_push_local_reference>().name, false);
+      else if(is_any_of(node.index(), { AIR_Node::index_member_access,
+                                        AIR_Node::index_apply_operator,
+                                        AIR_Node::index_apply_operator_bi32 })) {
+        // If a member function is called, its `this` will alias the object.
+        // Assume any subscript may designate one.
+        for(auto it = pending.mut_begin();  it != pending.mut_end();  ++it)
+          it->second = true;
+      }
+      else if(is_any_of(node.index(), { AIR_Node::index_function_call,
+                                        AIR_Node::index_alt_function_call,
+                                        AIR_Node::index_variadic_call })) {
+        for(auto it = pending.begin();  it != pending.end();  ++it)
+          if(it->second)
+            names.try_emplace(it->first, true);
+      }
+      else if(node.index() == AIR_Node::index_check_argument)
+        by_ref = node.as<AIR_Node::S_check_argument>().by_ref;
+      else if(node.index() == AIR_Node::index_return_statement)
+        by_ref = node.as<AIR_Node::S_return_statement>().by_ref;
+      else if(node.index() == AIR_Node::index_initialize_reference)
+        by_ref = true;
+      else if(node.index() == AIR_Node::index_for_each_statement) {
+        // The mapped reference aliases the range.
+        do_collect_referenced_names(names, node.as<AIR_Node::S_for_each_statement>().code_init);
+      }
+      else if(node.index() == AIR_Node::index_define_function)
+        do_collect_referenced_names(names, node.as<AIR_Node::S_define_function>().code_body);
+      else if(node.index() == AIR_Node::index_defer_expression)
+        do_collect_referenced_names(names, node.as<AIR_Node::S_defer_expression>().code_body);
+
+      if(by_ref) {
+        // References that are passed, returned or bound by reference may be
+        // captured elsewhere.
+        for(auto it = pending.begin();  it != pending.end();  ++it)
+          names.try_emplace(it->first, true);
+      }
+
+      do_for_each_nested(node, false,
+          [&](const cow_vector<AIR_Node>& nested) {
+            do_collect_escaping_names(names, pending, nested);
+          });
+    }
+  }
+
+// Marks variables that don't escape, so they will not be tracked by the
+// garbage collector. Nested closures are optimized separately.
+void
+do_mark_untracked_variables(cow_vector<AIR_Node>& code, const cow_dictionary<bool>& names)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      auto& node = code.mut(i);
+      if(node.index() == AIR_Node::index_declare_variable) {
+        auto& altr = node.mut<AIR_Node::S_declare_variable>();
+        altr.untracked = names.count(altr.name) == 0;
+      }
+      else if(node.index() == AIR_Node::index_define_null_variable) {
+        auto& altr = node.mut<AIR_Node::S_define_null_variable>();
+        altr.untracked = names.count(altr.name) == 0;
+      }
+
+      do_for_each_nested(node, false,
+          [&](cow_vector<AIR_Node>& nested) { do_mark_untracked_variables(nested, names);  });
+    }
+  }
+
+// Removes variables that are never referenced by name. Initializers are still
+// evaluated for their side effects, but the values are discarded.
+void
+do_eliminate_dead_stores(cow_vector<AIR_Node>& code, const cow_dictionary<bool>& names)
+  {
+    cow_vector<AIR_Node> res;
+    res.reserve(code.size());
+    size_t ndead = 0;
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      AIR_Node node = code.at(i);
+      do_for_each_nested(node, false,
+          [&](cow_vector<AIR_Node>& nested) { do_eliminate_dead_stores(nested, names);  });
+
+      if(node.index() == AIR_Node::index_define_null_variable) {
+        // The variable has no initializer.
+        if(names.count(node.as<AIR_Node::S_define_null_variable>().name) == 0)
+          continue;
+      }
+      else if((node.index() == AIR_Node::index_declare_variable)
+              && (names.count(node.as<AIR_Node::S_declare_variable>().name) == 0)) {
+        // The variable shall be initialized by the next `S_initialize_variable`.
+        // Structured bindings are not handled.
+        size_t k = i + 1;
+        while((k < code.size()) && is_none_of(code.at(k).index(),
+                     { AIR_Node::index_initialize_variable, AIR_Node::index_declare_variable,
+                       AIR_Node::index_unpack_array, AIR_Node::index_unpack_object }))
+          k ++;
+
+        if((k < code.size()) && (code.at(k).index() == AIR_Node::index_initialize_variable)) {
+          ndead ++;
+          continue;
+        }
+      }
+      else if((node.index() == AIR_Node::index_initialize_variable) && (ndead != 0)) {
+        // Ensure the initializer is still dereferenceable, just like
+        // `S_initialize_variable`, but leave it on the stack.
+        ndead --;
+        AIR_Node::S_check_argument xnode = { node.as<AIR_Node::S_initialize_variable>().sloc,
+                                             true };
+        node = move(xnode);
+      }
+
+      res.emplace_back(move(node));
+    }
+
+    code.swap(res);
+  }
+
+// Replaces the last nodes of `code` with a fused one, if possible. Nodes are
+// fused in two passes, so a comparison preceding a branch is fused with the
+// branch, rather than its operand.
+void
+do_fuse_tail(cow_vector<AIR_Node>& code, bool operands)
+  {
+    if(code.size() < 2)
+      return;
+
+    const auto& back = code.back();
+    const auto& prev = code.at(code.size() - 2);
+
+    if(!operands) {
+      if((back.index() == AIR_Node::index_branch_expression)
+         && !back.as<AIR_Node::S_branch_expression>().assign
+         && (prev.index() == AIR_Node::index_apply_operator_bi32)
+         && !prev.as<AIR_Node::S_apply_operator_bi32>().assign
+         && is_any_of(prev.as<AIR_Node::S_apply_operator_bi32>().xop,
+                      { xop_cmp_eq, xop_cmp_ne, xop_cmp_un, xop_cmp_lt, xop_cmp_gt,
+                        xop_cmp_lte, xop_cmp_gte })) {
+        // `x < 1 ? a : b`
+        const auto& altr = back.as<AIR_Node::S_branch_expression>();
+        const auto& cmp = prev.as<AIR_Node::S_apply_operator_bi32>();
+        AIR_Node::S_branch_compare_bi32 xnode = { cmp.sloc, cmp.xop, cmp.irhs,
+                                                  altr.code_true, altr.code_false };
+        code.pop_back(2);
+        code.emplace_back(move(xnode));
+      }
+      else if((back.index() == AIR_Node::index_member_access)
+              && (prev.index() == AIR_Node::index_push_global_reference)) {
+        // `std.math`
+        const auto& glob = prev.as<AIR_Node::S_push_global_reference>();
+        AIR_Node::S_push_global_member xnode = { glob.sloc, glob.name, { } };
+        xnode.keys.emplace_back(back.as<AIR_Node::S_member_access>().key);
+        code.pop_back(2);
+        code.emplace_back(move(xnode));
+      }
+      else if((back.index() == AIR_Node::index_member_access)
+              && (prev.index() == AIR_Node::index_push_global_member)) {
+        // `std.math.sin`
+        auto key = back.as<AIR_Node::S_member_access>().key;
+        code.pop_back();
+        code.mut_back().mut<AIR_Node::S_push_global_member>().keys.emplace_back(move(key));
+      }
+    }
+    else {
+      if((back.index() == AIR_Node::index_apply_operator_bi32)
+         && (prev.index() == AIR_Node::index_push_local_reference)
+         && (prev.as<AIR_Node::S_push_local_reference>().slot != UINT32_MAX)
+         && is_any_of(back.as<AIR_Node::S_apply_operator_bi32>().xop,
+                      { xop_cmp_eq, xop_cmp_ne, xop_cmp_un, xop_cmp_lt, xop_cmp_gt,
+                        xop_cmp_lte, xop_cmp_gte, xop_add, xop_sub })) {
+        // `x + 1`, `x += 1`, `x < 1`
+        const auto& altr = back.as<AIR_Node::S_apply_operator_bi32>();
+        const auto& local = prev.as<AIR_Node::S_push_local_reference>();
+        AIR_Node::S_apply_operator_local_bi32 xnode = { altr.sloc, local.depth, local.name,
+                                                        local.slot, altr.xop, altr.assign,
+                                                        altr.irhs };
+        code.pop_back(2);
+        code.emplace_back(move(xnode));
+      }
+    }
+  }
+
+// Fuses frequent sequences of nodes into superinstructions, recursively. This
+// must happen after all references have been rebound, as fused nodes are not
+// rebound. The set of fused nodes was chosen from the results of
+// `count_node_pairs()`.
+void
+do_fuse_nodes(cow_vector<AIR_Node>& code, bool operands)
+  {
+    cow_vector<AIR_Node> res;
+    res.reserve(code.size());
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      AIR_Node node = code.at(i);
+      do_for_each_nested(node, false,
+          [&](cow_vector<AIR_Node>& nested) { do_fuse_nodes(nested, operands);  });
+
+      res.emplace_back(move(node));
+      do_fuse_tail(res, operands);
+    }
+
+    code.swap(res);
+  }
+
+void
+do_count_node_pairs(cow_dictionary<uint64_t>& counts, const cow_vector<AIR_Node>& code)
+  {
+    for(size_t k = 0;  k < code.size();  ++k) {
+      if(k != 0) {
+        cow_string key;
+        key.append(AIR_Node::describe_index(code.at(k - 1).index()));
+        key.push_back(' ');
+        key.append(AIR_Node::describe_index(code.at(k).index()));
+        counts[phcow_string(move(key))] ++;
+      }
+
+      do_for_each_nested(code.at(k), true,
+          [&](const cow_vector<AIR_Node>& nested) { do_count_node_pairs(counts, nested);  });
+    }
+  }
+
+// Checks whether `code[i]` starts a chain of member accesses on a temporary
+// global reference, such as `std.string.find`. The number of member accesses
+// is returned if all but the last one designate existent members, which can be
+// evaluated without side effects or errors; otherwise zero is returned.
+size_t
+do_match_invariant_chain(const Global_Context& global, const cow_vector<AIR_Node>& code,
+                         size_t i)
+  {
+    if(code.at(i).index() != AIR_Node::index_push_global_reference)
+      return 0;
+
+    size_t nkeys = 0;
+    while((i + 1 + nkeys < code.size())
+          && (code.at(i + 1 + nkeys).index() == AIR_Node::index_member_access))
+      nkeys ++;
+
+    // Hoisting a single member access gains nothing.
+    if(nkeys < 2)
+      return 0;
+
+    auto qref = global.get_named_reference_opt(
+                        code.at(i).as<AIR_Node::S_push_global_reference>().name);
+    if(!qref || !qref->is_temporary())
+      return 0;
+
+    const Value* qval = &(qref->dereference_readonly());
+    for(size_t k = 0;  k < nkeys - 1;  ++k) {
+      if(!qval->is_object())
+        return 0;
+
+      qval = qval->as_object().ptr(code.at(i + 1 + k).as<AIR_Node::S_member_access>().key);
+      if(!qval)
+        return 0;
+    }
+    return nkeys;
+  }
+
+bool
+do_has_function_calls(const cow_vector<AIR_Node>& code)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code.at(i);
+      if(is_any_of(node.index(), { AIR_Node::index_function_call,
+                                   AIR_Node::index_alt_function_call,
+                                   AIR_Node::index_variadic_call,
+                                   AIR_Node::index_import_call,
+                                   AIR_Node::index_yield_statement }))
+        return true;
+
+      bool found = false;
+      do_for_each_nested(node, false,
+          [&](const cow_vector<AIR_Node>& nested) { found |= do_has_function_calls(nested);  });
+      if(found)
+        return true;
+    }
+    return false;
+  }
+
+// Checks whether a function with this body is a generator. `yield` statements
+// in closures belong to the closures.
+bool
+do_has_yield_statements(const cow_vector<AIR_Node>& code)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code.at(i);
+      if(node.index() == AIR_Node::index_yield_statement)
+        return true;
+
+      bool found = false;
+      do_for_each_nested(node, false,
+          [&](const cow_vector<AIR_Node>& nested) { found |= do_has_yield_statements(nested);  });
+      if(found)
+        return true;
+    }
+    return false;
+  }
+
+// Checks whether the value of the subscript at the top of the stack is
+// consumed by `node`, which will not modify it.
+bool
+do_is_read_only_consumer(const AIR_Node& node)
+  {
+    if(node.index() == AIR_Node::index_apply_operator_bi32)
+      return !node.as<AIR_Node::S_apply_operator_bi32>().assign;
+
+    if(node.index() != AIR_Node::index_apply_operator)
+      return false;
+
+    // The top of the stack is the last operand of a binary or ternary operator,
+    // which is never modified.
+    const auto& altr = node.as<AIR_Node::S_apply_operator>();
+    if(is_any_of(altr.xop, { xop_index, xop_assign, xop_fma })
+       || ((altr.xop >= xop_cmp_eq) && (altr.xop <= xop_xorb))
+       || ((altr.xop >= xop_addm) && (altr.xop <= xop_muls)))
+      return true;
+
+    return !altr.assign
+           && is_none_of(altr.xop, { xop_inc, xop_dec, xop_unset, xop_head, xop_tail,
+                                     xop_random });
+  }
+
+// Checks whether all references to `name` in `code` are read-only, which are
+// either operands of `countof`, or subscripts such as `a[i]` whose values are
+// consumed immediately. Such a variable cannot be modified by name.
+bool
+do_is_only_read(const phcow_string& name, const cow_vector<AIR_Node>& code)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code.at(i);
+      if((node.index() == AIR_Node::index_push_local_reference)
+         && (node.as<AIR_Node::S_push_local_reference>().name == name)) {
+        if(i + 1 >= code.size())
+          return false;
+
+        const auto& next = code.at(i + 1);
+        if((next.index() == AIR_Node::index_apply_operator)
+           && (next.as<AIR_Node::S_apply_operator>().xop == xop_countof)
+           && !next.as<AIR_Node::S_apply_operator>().assign)
+          continue;
+
+        if((i + 3 >= code.size())
+           || is_none_of(next.index(), { AIR_Node::index_push_local_reference,
+                                         AIR_Node::index_push_constant })
+           || (code.at(i + 2).index() != AIR_Node::index_apply_operator)
+           || (code.at(i + 2).as<AIR_Node::S_apply_operator>().xop != xop_index)
+           || code.at(i + 2).as<AIR_Node::S_apply_operator>().assign
+           || !do_is_read_only_consumer(code.at(i + 3)))
+          return false;
+      }
+
+      bool good = true;
+      do_for_each_nested(node, true,
+          [&](const cow_vector<AIR_Node>& nested) { good &= do_is_only_read(name, nested);  });
+      if(!good)
+        return false;
+    }
+    return true;
+  }
+
+// Collects names that may alias other variables: parameters, references, and
+// mapped references of range-based loops. Returns whether any reference is
+// declared, which may alias any variable.
+bool
+do_collect_alias_names(cow_dictionary<bool>& names, const cow_vector<AIR_Node>& code)
+  {
+    bool refs = false;
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code.at(i);
+      if(node.index() == AIR_Node::index_declare_reference)
+        refs = true;
+      else if(node.index() == AIR_Node::index_for_each_statement)
+        names.try_emplace(node.as<AIR_Node::S_for_each_statement>().name_mapped, true);
+
+      do_for_each_nested(node, false,
+          [&](const cow_vector<AIR_Node>& nested) { refs |= do_collect_alias_names(names, nested);  });
+    }
+    return refs;
+  }
+
+// These are values that have been hoisted out of a loop. Each value is stored
+// in an immutable variable in the scope of the loop initializer.
+struct Loop_Invariants
+  {
+    cow_vector<AIR_Node> code_init;
+    cow_dictionary<uint32_t> slots;
+    uint32_t next_slot;
+    cow_dictionary<bool> counted;
+  };
+
+// Gets the slot of a hoisted value, which is identified by `key`. If it has
+// not been hoisted, `code_value` is appended to the loop initializer.
+uint32_t
+do_hoist_value(Loop_Invariants& inv, const Source_Location& sloc, const cow_string& key,
+               const cow_vector<AIR_Node>& code_value)
+  {
+    phcow_string name(key);
+    auto qslot = inv.slots.ptr(name);
+    if(qslot)
+      return *qslot;
+
+    uint32_t slot = inv.next_slot ++;
+    inv.slots.try_emplace(name, slot);
+
+    inv.code_init.emplace_back(AIR_Node::S_clear_stack());
+    AIR_Node::S_declare_variable xdecl = { sloc, name, slot, true };
+    inv.code_init.emplace_back(move(xdecl));
+    inv.code_init.append(code_value.begin(), code_value.end());
+    AIR_Node::S_initialize_variable xinit = { sloc, true };
+    inv.code_init.emplace_back(move(xinit));
+    return slot;
+  }
+
+// Replaces loop-invariant values in `code` with references to hoisted
+// variables. `extra` is the number of scopes between `code` and the loop
+// initializer. Only nodes that are evaluated in the same function are
+// inspected; nested loops have been processed before, and their initializers
+// are also candidates.
+void
+do_hoist_invariants(Loop_Invariants& inv, cow_vector<AIR_Node>& code, uint32_t extra,
+                    const Global_Context& global)
+  {
+    cow_vector<AIR_Node> res;
+    res.reserve(code.size());
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      AIR_Node node = code.at(i);
+
+      size_t nkeys = do_match_invariant_chain(global, code, i);
+      if(nkeys != 0) {
+        // `std.string.find` => `[hoisted std.string] .find`
+        const auto& glob = node.as<AIR_Node::S_push_global_reference>();
+        cow_vector<AIR_Node> code_value;
+        code_value.emplace_back(node);
+        cow_string key = glob.name.rdstr();
+        for(size_t k = 0;  k < nkeys - 1;  ++k) {
+          code_value.emplace_back(code.at(i + 1 + k));
+          key << "." << code.at(i + 1 + k).as<AIR_Node::S_member_access>().key.rdstr();
+        }
+
+        uint32_t slot = do_hoist_value(inv, glob.sloc, key, code_value);
+        AIR_Node::S_push_local_reference xnode = { glob.sloc, static_cast<uint16_t>(extra),
+                                                   phcow_string(key), slot };
+        res.emplace_back(move(xnode));
+        res.emplace_back(code.at(i + nkeys));
+        i += nkeys;
+        continue;
+      }
+
+      if((node.index() == AIR_Node::index_push_local_reference)
+         && (i + 1 < code.size())
+         && (code.at(i + 1).index() == AIR_Node::index_apply_operator)
+         && (code.at(i + 1).as<AIR_Node::S_apply_operator>().xop == xop_countof)
+         && !code.at(i + 1).as<AIR_Node::S_apply_operator>().assign
+         && (node.as<AIR_Node::S_push_local_reference>().depth > extra)
+         && inv.counted.count(node.as<AIR_Node::S_push_local_reference>().name)) {
+        // `countof a` => `[hoisted countof a]`
+        auto local = node.as<AIR_Node::S_push_local_reference>();
+        local.depth = static_cast<uint16_t>(local.depth - extra);
+        cow_vector<AIR_Node> code_value;
+        code_value.emplace_back(local);
+        code_value.emplace_back(code.at(i + 1));
+        cow_string key = sformat("countof $1@$2", local.name, local.depth);
+
+        uint32_t slot = do_hoist_value(inv, local.sloc, key, code_value);
+        AIR_Node::S_push_local_reference xnode = { local.sloc, static_cast<uint16_t>(extra),
+                                                   phcow_string(key), slot };
+        res.emplace_back(move(xnode));
+        i += 1;
+        continue;
+      }
+
+      // Scopes are counted exactly the same way as `rebind_opt()`.
+      if(node.index() == AIR_Node::index_if_statement) {
+        auto& altr = node.mut<AIR_Node::S_if_statement>();
+        do_hoist_invariants(inv, altr.code_true, extra + !altr.scopeless_true, global);
+        do_hoist_invariants(inv, altr.code_false, extra + !altr.scopeless_false, global);
+      }
+      else if(node.index() == AIR_Node::index_do_while_statement) {
+        auto& altr = node.mut<AIR_Node::S_do_while_statement>();
+        do_hoist_invariants(inv, altr.code_body, extra + !altr.scopeless_body, global);
+        do_hoist_invariants(inv, altr.code_cond, extra, global);
+      }
+      else if(node.index() == AIR_Node::index_while_statement) {
+        auto& altr = node.mut<AIR_Node::S_while_statement>();
+        do_hoist_invariants(inv, altr.code_cond, extra, global);
+        do_hoist_invariants(inv, altr.code_body, extra + !altr.scopeless_body, global);
+      }
+      else if(node.index() == AIR_Node::index_for_each_statement)
+        do_hoist_invariants(inv, node.mut<AIR_Node::S_for_each_statement>().code_init,
+                            extra + 1, global);
+      else if(node.index() == AIR_Node::index_for_statement)
+        do_hoist_invariants(inv, node.mut<AIR_Node::S_for_statement>().code_init,
+                            extra + 1, global);
+      else if(node.index() == AIR_Node::index_counted_for_statement)
+        do_hoist_invariants(inv, node.mut<AIR_Node::S_counted_for_statement>().code_init,
+                            extra + 1, global);
+      else if(node.index() == AIR_Node::index_branch_expression) {
+        auto& altr = node.mut<AIR_Node::S_branch_expression>();
+        do_hoist_invariants(inv, altr.code_true, extra, global);
+        do_hoist_invariants(inv, altr.code_false, extra, global);
+      }
+      else if(node.index() == AIR_Node::index_coalesce_expression)
+        do_hoist_invariants(inv, node.mut<AIR_Node::S_coalesce_expression>().code_null,
+                            extra, global);
+
+      res.emplace_back(move(node));
+    }
+
+    code.swap(res);
+  }
+
+// Gets the slot of a variable or reference that is declared by `node`. If
+// `node` is not a declaration, `UINT32_MAX` is returned.
+uint32_t
+do_get_declared_slot(const AIR_Node& node)
+  {
+    if(node.index() == AIR_Node::index_declare_variable)
+      return node.as<AIR_Node::S_declare_variable>().slot;
+    else if(node.index() == AIR_Node::index_define_null_variable)
+      return node.as<AIR_Node::S_define_null_variable>().slot;
+    else if(node.index() == AIR_Node::index_declare_reference)
+      return node.as<AIR_Node::S_declare_reference>().slot;
+    else if(node.index() == AIR_Node::index_initialize_reference)
+      return node.as<AIR_Node::S_initialize_reference>().slot;
+    else
+      return UINT32_MAX;
+  }
+
+// Gets the first slot after all variables and references that are declared in
+// `code`, such as a loop initializer.
+uint32_t
+do_get_next_slot(const cow_vector<AIR_Node>& code, uint32_t first)
+  {
+    uint32_t next = first;
+    for(size_t i = 0;  i < code.size();  ++i) {
+      uint32_t slot = do_get_declared_slot(code.at(i));
+      if(slot != UINT32_MAX)
+        next = ::std::max(next, slot + 1);
+    }
+    return next;
+  }
+
+// Checks whether `code` is `++i`, `i++` or `i += 1`.
+bool
+do_is_increment_of(const cow_vector<AIR_Node>& code, const AIR_Node::S_declare_variable& var)
+  {
+    if((code.size() != 3)
+       || (code.at(0).index() != AIR_Node::index_clear_stack)
+       || (code.at(1).index() != AIR_Node::index_push_local_reference))
+      return false;
+
+    const auto& local = code.at(1).as<AIR_Node::S_push_local_reference>();
+    if((local.depth != 0) || (local.slot != var.slot) || (local.name != var.name))
+      return false;
+
+    if(code.at(2).index() == AIR_Node::index_apply_operator)
+      return code.at(2).as<AIR_Node::S_apply_operator>().xop == xop_inc;
+
+    if(code.at(2).index() == AIR_Node::index_apply_operator_bi32)
+      return (code.at(2).as<AIR_Node::S_apply_operator_bi32>().xop == xop_add)
+             && code.at(2).as<AIR_Node::S_apply_operator_bi32>().assign
+             && (code.at(2).as<AIR_Node::S_apply_operator_bi32>().irhs == 1);
+
+    return false;
+  }
+
+// Converts `for(var i = M;  i < N;  ++i)` into a counted loop, if the body
+// never references `i`, where both `M` and `N` are 32-bit integer constants.
+// The induction variable is still declared, but is neither compared nor
+// incremented.
+opt<AIR_Node>
+do_make_counted_loop_opt(const AIR_Node::S_for_statement& altr)
+  {
+    if((altr.code_init.size() != 4)
+       || (altr.code_init.at(0).index() != AIR_Node::index_clear_stack)
+       || (altr.code_init.at(1).index() != AIR_Node::index_declare_variable)
+       || (altr.code_init.at(2).index() != AIR_Node::index_push_constant)
+       || (altr.code_init.at(3).index() != AIR_Node::index_initialize_variable))
+      return nullopt;
+
+    const auto& var = altr.code_init.at(1).as<AIR_Node::S_declare_variable>();
+    const auto& init = altr.code_init.at(2).as<AIR_Node::S_push_constant>().val;
+    if(!init.is_integer() || (init.as_integer() < INT32_MIN) || (init.as_integer() > INT32_MAX))
+      return nullopt;
+
+    if((altr.code_cond.size() != 3)
+       || (altr.code_cond.at(0).index() != AIR_Node::index_clear_stack)
+       || (altr.code_cond.at(1).index() != AIR_Node::index_push_local_reference)
+       || (altr.code_cond.at(2).index() != AIR_Node::index_apply_operator_bi32))
+      return nullopt;
+
+    const auto& local = altr.code_cond.at(1).as<AIR_Node::S_push_local_reference>();
+    const auto& cmp = altr.code_cond.at(2).as<AIR_Node::S_apply_operator_bi32>();
+    if((local.depth != 0) || (local.slot != var.slot) || (local.name != var.name)
+       || cmp.assign || is_none_of(cmp.xop, { xop_cmp_lt, xop_cmp_lte }))
+      return nullopt;
+
+    if(!do_is_increment_of(altr.code_step, var))
+      return nullopt;
+
+    cow_dictionary<bool> names;
+    do_collect_referenced_names(names, altr.code_body);
+    do_collect_referenced_names(names, altr.code_complete);
+    if(names.count(var.name) != 0)
+      return nullopt;
+
+    int64_t count = static_cast<int64_t>(cmp.irhs) - init.as_integer() + (cmp.xop == xop_cmp_lte);
+    AIR_Node::S_counted_for_statement xnode = { altr.code_init, (count > 0) ? count : 0,
+                                                altr.code_body, altr.scopeless_body,
+                                                altr.code_complete };
+    return move(xnode);
+  }
+
+// Performs loop optimizations recursively. `level` is the number of scopes
+// between `code` and the function scope.
+void
+do_optimize_loops(cow_vector<AIR_Node>& code, uint32_t level, const Global_Context& global,
+                  const cow_dictionary<bool>& aliases, bool refs)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      auto& node = code.mut(i);
+
+      // Optimize inner loops first.
+      if(node.index() == AIR_Node::index_if_statement) {
+        auto& altr = node.mut<AIR_Node::S_if_statement>();
+        do_optimize_loops(altr.code_true, level + !altr.scopeless_true, global, aliases, refs);
+        do_optimize_loops(altr.code_false, level + !altr.scopeless_false, global, aliases, refs);
+      }
+      else if(node.index() == AIR_Node::index_do_while_statement) {
+        auto& altr = node.mut<AIR_Node::S_do_while_statement>();
+        do_optimize_loops(altr.code_body, level + !altr.scopeless_body, global, aliases, refs);
+      }
+      else if(node.index() == AIR_Node::index_while_statement) {
+        auto& altr = node.mut<AIR_Node::S_while_statement>();
+        do_optimize_loops(altr.code_body, level + !altr.scopeless_body, global, aliases, refs);
+      }
+      else if(node.index() == AIR_Node::index_for_each_statement) {
+        auto& altr = node.mut<AIR_Node::S_for_each_statement>();
+        do_optimize_loops(altr.code_body, level + 1 + !altr.scopeless_body, global, aliases,
+                          refs);
+      }
+      else if(node.index() == AIR_Node::index_for_statement) {
+        auto& altr = node.mut<AIR_Node::S_for_statement>();
+        do_optimize_loops(altr.code_body, level + 1 + !altr.scopeless_body, global, aliases,
+                          refs);
+      }
+      else if(node.index() == AIR_Node::index_switch_statement) {
+        auto& altr = node.mut<AIR_Node::S_switch_statement>();
+        for(size_t k = 0;  k < altr.clauses.size();  ++k) {
+          // Labels are evaluated in the current scope.
+          do_optimize_loops(altr.clauses.mut(k).code_labels, level, global, aliases, refs);
+          do_optimize_loops(altr.clauses.mut(k).code_body, level + !altr.scopeless, global,
+                            aliases, refs);
+        }
+      }
+      else if(is_any_of(node.index(), { AIR_Node::index_execute_block,
+                                        AIR_Node::index_try_statement })) {
+        // These bodies are all executed in a new scope.
+        do_for_each_nested(node, false,
+            [&](cow_vector<AIR_Node>& nested) {
+              do_optimize_loops(nested, level + 1, global, aliases, refs);
+            });
+      }
+
+      if(node.index() == AIR_Node::index_for_statement) {
+        if(auto qnode = do_make_counted_loop_opt(node.as<AIR_Node::S_for_statement>()))
+          node = move(*qnode);
+      }
+
+      if(node.index() == AIR_Node::index_for_statement) {
+        auto& altr = node.mut<AIR_Node::S_for_statement>();
+        Loop_Invariants inv;
+        inv.next_slot = do_get_next_slot(altr.code_init, 0);
+
+        // The length of an array is hoisted only if it's used by the condition,
+        // which is always evaluated before the first iteration, so no error is
+        // raised too early. The array must be neither modified by name nor
+        // aliased by a reference, and the loop shall neither call any function
+        // nor yield.
+        if(!refs && !do_has_function_calls(altr.code_cond)
+           && !do_has_function_calls(altr.code_step)
+           && !do_has_function_calls(altr.code_body))
+          for(size_t k = 0;  k + 1 < altr.code_cond.size();  ++k) {
+            const auto& node_k = altr.code_cond.at(k);
+            const auto& next = altr.code_cond.at(k + 1);
+            if((node_k.index() != AIR_Node::index_push_local_reference)
+               || (next.index() != AIR_Node::index_apply_operator)
+               || (next.as<AIR_Node::S_apply_operator>().xop != xop_countof))
+              continue;
+
+            const auto& local = node_k.as<AIR_Node::S_push_local_reference>();
+            if((local.depth == 0) || (local.depth > level + 1) || (local.slot == UINT32_MAX)
+               || (aliases.count(local.name) != 0)
+               || !do_is_only_read(local.name, altr.code_cond)
+               || !do_is_only_read(local.name, altr.code_step)
+               || !do_is_only_read(local.name, altr.code_body))
+              continue;
+
+            inv.counted.try_emplace(local.name, true);
+          }
+
+        do_hoist_invariants(inv, altr.code_cond, 0, global);
+        do_hoist_invariants(inv, altr.code_step, 0, global);
+        do_hoist_invariants(inv, altr.code_body, !altr.scopeless_body, global);
+        altr.code_init.append(inv.code_init.begin(), inv.code_init.end());
+      }
+      else if(node.index() == AIR_Node::index_counted_for_statement) {
+        auto& altr = node.mut<AIR_Node::S_counted_for_statement>();
+        Loop_Invariants inv;
+        inv.next_slot = do_get_next_slot(altr.code_init, 0);
+        do_hoist_invariants(inv, altr.code_body, !altr.scopeless_body, global);
+        altr.code_init.append(inv.code_init.begin(), inv.code_init.end());
+      }
+      else if(node.index() == AIR_Node::index_for_each_statement) {
+        // The key and mapped references occupy the first two slots. Hoisted
+        // values are initialized before the range, which shall be left on the
+        // top of the stack.
+        auto& altr = node.mut<AIR_Node::S_for_each_statement>();
+        Loop_Invariants inv;
+        inv.next_slot = do_get_next_slot(altr.code_init, 2);
+        do_hoist_invariants(inv, altr.code_body, !altr.scopeless_body, global);
+        inv.code_init.append(altr.code_init.begin(), altr.code_init.end());
+        altr.code_init.swap(inv.code_init);
+      }
+    }
+  }
+
+// Forms a function signature such as `foo(a, b)`, if `name` looks like a
+// function name. Otherwise `name` is returned intact.
+cow_string
+do_make_signature(const cow_string& name, const cow_vector<phcow_string>& params)
+  {
+    cow_string func = name;
+    if(is_cmask(func.front(), cmask_namei) && is_cmask(func.back(), cmask_name)) {
+      // If `name` looks like a function name, append the parameter list
+      // to form a function signature.
+      func << "(";
+      uint32_t off = 0;
+      switch(params.size())
+        {
+          do {
+            func << ", ";  // fallthrough
+        default:
+            func << params[off];
+          } while(++off != params.size());  // fallthrough
+        case 0:
+          break;
+        }
+      func << ")";
+    }
+    return func;
+  }
+
+// Gets the number of values that `node` pops from the stack, and the number
+// of values that it pushes. If `node` may do anything else with the stack,
+// `false` is returned.
+bool
+do_get_stack_effect(uint32_t& npop, uint32_t& npush, const AIR_Node& node)
+  {
+    npop = 0;
+    npush = 1;
+
+    if(is_any_of(node.index(), { AIR_Node::index_push_global_reference,
+                                 AIR_Node::index_push_local_reference,
+                                 AIR_Node::index_push_constant,
+                                 AIR_Node::index_define_function,
+                                 AIR_Node::index_catch_expression }))
+      return true;
+
+    npop = 1;
+    if(is_any_of(node.index(), { AIR_Node::index_member_access,
+                                 AIR_Node::index_check_argument,
+                                 AIR_Node::index_check_null,
+                                 AIR_Node::index_apply_operator_bi32,
+                                 AIR_Node::index_branch_expression,
+                                 AIR_Node::index_coalesce_expression,
+                                 AIR_Node::index_inline_call }))
+      return true;
+
+    if(node.index() == AIR_Node::index_apply_operator) {
+      Xop xop = node.as<AIR_Node::S_apply_operator>().xop;
+      if(xop == xop_fma)
+        npop = 3;
+      else if(is_any_of(xop, { xop_index, xop_assign })
+              || (do_get_pure_operand_count(xop) == 2))
+        npop = 2;
+      return true;
+    }
+
+    if(node.index() == AIR_Node::index_push_unnamed_array) {
+      npop = node.as<AIR_Node::S_push_unnamed_array>().nelems;
+      return true;
+    }
+
+    if(node.index() == AIR_Node::index_push_unnamed_object) {
+      npop = static_cast<uint32_t>(node.as<AIR_Node::S_push_unnamed_object>().keys.size());
+      return true;
+    }
+
+    if(node.index() == AIR_Node::index_function_call) {
+      npop = node.as<AIR_Node::S_function_call>().nargs + 1;
+      return true;
+    }
+
+    return false;
+  }
+
+// Checks whether `code[i]` pushes the target of a function call. If so, the
+// arguments are `code[iargs]` to `code[icall]` exclusively, which push `nargs`
+// values, and `code[icall]` is the call.
+bool
+do_match_call(size_t& iargs, size_t& icall, uint32_t& nargs, const cow_vector<AIR_Node>& code,
+              size_t i)
+  {
+    bool alt = (i + 1 < code.size())
+               && (code.at(i + 1).index() == AIR_Node::index_alt_clear_stack);
+    iargs = i + 1 + alt;
+    nargs = 0;
+
+    for(size_t k = iargs;  k < code.size();  ++k) {
+      const auto& node = code.at(k);
+      if(alt && (node.index() == AIR_Node::index_alt_function_call)) {
+        icall = k;
+        return true;
+      }
+
+      if(!alt && (node.index() == AIR_Node::index_function_call)
+         && (node.as<AIR_Node::S_function_call>().nargs == nargs)) {
+        icall = k;
+        return true;
+      }
+
+      if(!alt && (node.index() == AIR_Node::index_alt_clear_stack) && (nargs != 0)) {
+        // This is a nested call, whose arguments are evaluated on another
+        // stack, and whose target at the top is replaced with its result.
+        while((k < code.size()) && (code.at(k).index() != AIR_Node::index_alt_function_call))
+          k ++;
+        continue;
+      }
+
+      // The target shall not be consumed by anything else.
+      uint32_t npop, npush;
+      if(!do_get_stack_effect(npop, npush, node) || (npop > nargs))
+        return false;
+
+      nargs = nargs - npop + npush;
+    }
+    return false;
+  }
+
+// Checks whether `code` is an expression that can be spliced into a caller. It
+// shall neither call a function nor modify anything, and shall not reference
+// local names other than parameters and names from enclosing scopes. `count`
+// is incremented by the number of nodes.
+bool
+do_is_inlinable_expression(size_t& count, const cow_vector<AIR_Node>& code, size_t nparams)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code.at(i);
+      count ++;
+
+      if(is_any_of(node.index(), { AIR_Node::index_push_global_reference,
+                                   AIR_Node::index_push_constant,
+                                   AIR_Node::index_member_access,
+                                   AIR_Node::index_check_argument,
+                                   AIR_Node::index_check_null,
+                                   AIR_Node::index_push_unnamed_array,
+                                   AIR_Node::index_push_unnamed_object }))
+        continue;
+
+      if(node.index() == AIR_Node::index_push_local_reference) {
+        const auto& altr = node.as<AIR_Node::S_push_local_reference>();
+        if((altr.slot == UINT32_MAX) || ((altr.depth == 0) && (altr.slot >= nparams)))
+          return false;
+      }
+      else if(node.index() == AIR_Node::index_apply_operator) {
+        const auto& altr = node.as<AIR_Node::S_apply_operator>();
+        if(altr.assign || is_any_of(altr.xop, { xop_inc, xop_dec, xop_unset, xop_assign }))
+          return false;
+      }
+      else if(node.index() == AIR_Node::index_apply_operator_bi32) {
+        if(node.as<AIR_Node::S_apply_operator_bi32>().assign)
+          return false;
+      }
+      else if(node.index() == AIR_Node::index_branch_expression) {
+        const auto& altr = node.as<AIR_Node::S_branch_expression>();
+        if(altr.assign || !do_is_inlinable_expression(count, altr.code_true, nparams)
+           || !do_is_inlinable_expression(count, altr.code_false, nparams))
+          return false;
+      }
+      else if(node.index() == AIR_Node::index_coalesce_expression) {
+        const auto& altr = node.as<AIR_Node::S_coalesce_expression>();
+        if(altr.assign || !do_is_inlinable_expression(count, altr.code_null, nparams))
+          return false;
+      }
+      else
+        return false;
+    }
+    return true;
+  }
+
+// This is a function that may be inlined. It has been defined by a `func`
+// statement or as an immutable variable. Its body is a single `return`
+// statement.
+struct Inline_Candidate
+  {
+    phcow_string name;
+    uint32_t slot;
+    Source_Location sloc_func;
+    cow_string func;
+    cow_vector<phcow_string> params;
+    cow_vector<AIR_Node> code_expr;
+    Source_Location sloc_ret;
+
+    // These are slots of variables from enclosing scopes, with indices of
+    // their scopes.
+    cow_vector<pair<size_t, uint32_t>> outer_slots;
+  };
+
+// This is a scope where calls are inlined, which mirrors the analytic context
+// that `rebind_opt()` creates.
+struct Inline_Scope
+  {
+    cow_vector<Inline_Candidate> candidates;
+    uint32_t next_slot;  // where parameters of inlined functions are stored
+    bool recording;
+  };
+
+void
+do_collect_outer_slots(Inline_Candidate& cand, const cow_vector<AIR_Node>& code, size_t iscope)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      const auto& node = code.at(i);
+      if(node.index() == AIR_Node::index_push_local_reference) {
+        const auto& altr = node.as<AIR_Node::S_push_local_reference>();
+        if((altr.depth != 0) && (altr.depth - 1u <= iscope))
+          cand.outer_slots.emplace_back(iscope - (altr.depth - 1u), altr.slot);
+      }
+
+      do_for_each_nested(node, false,
+          [&](const cow_vector<AIR_Node>& nested) {
+            do_collect_outer_slots(cand, nested, iscope);
+          });
+    }
+  }
+
+// Checks whether a function that is defined in scope `iscope` can be inlined.
+opt<Inline_Candidate>
+do_make_inline_candidate_opt(const AIR_Node::S_declare_variable& var,
+                             const AIR_Node::S_define_function& defn, size_t iscope)
+  {
+    for(size_t k = 0;  k < defn.params.size();  ++k)
+      if(defn.params.at(k) == "...")
+        return nullopt;
+
+    const auto& body = defn.code_body;
+    if((body.size() < 2) || (body.front().index() != AIR_Node::index_clear_stack))
+      return nullopt;
+
+    Inline_Candidate cand;
+    cand.name = var.name;
+    cand.slot = var.slot;
+    cand.sloc_func = defn.sloc;
+    cand.func = do_make_signature(defn.func, defn.params);
+    cand.params = defn.params;
+
+    if((body.size() == 2) && (body.back().index() == AIR_Node::index_return_statement_bi32)) {
+      // The result is encoded in the node.
+      const auto& altr = body.back().as<AIR_Node::S_return_statement_bi32>();
+      AIR_Node::S_push_constant xnode;
+      if(altr.type == type_boolean)
+        xnode.val = altr.irhs != 0;
+      else if(altr.type == type_integer)
+        xnode.val = altr.irhs;
+      cand.code_expr.emplace_back(move(xnode));
+      cand.sloc_ret = altr.sloc;
+      return move(cand);
+    }
+
+    if((body.size() < 3) || (body.back().index() != AIR_Node::index_return_statement))
+      return nullopt;
+
+    const auto& ret = body.back().as<AIR_Node::S_return_statement>();
+    if(ret.by_ref || ret.is_void)
+      return nullopt;
+
+    // Large functions are not inlined, so code will not bloat.
+    cand.code_expr.append(body.begin() + 1, body.end() - 1);
+    cand.sloc_ret = ret.sloc;
+    size_t count = 0;
+    if(!do_is_inlinable_expression(count, cand.code_expr, defn.params.size()) || (count > 16))
+      return nullopt;
+
+    do_collect_outer_slots(cand, cand.code_expr, iscope);
+    return move(cand);
+  }
+
+// Forgets functions that are stored in, or reference, a slot that is being
+// redeclared.
+void
+do_forget_slot(cow_vector<Inline_Scope>& scopes, size_t iscope, uint32_t slot)
+  {
+    for(size_t k = 0;  k < scopes.size();  ++k) {
+      auto& cands = scopes.mut(k).candidates;
+      for(size_t i = cands.size() - 1;  i != SIZE_MAX;  --i) {
+        const auto& cand = cands.at(i);
+        bool dirty = (k == iscope) && (cand.slot == slot);
+        for(size_t j = 0;  j < cand.outer_slots.size();  ++j)
+          dirty |= (cand.outer_slots.at(j).first == iscope)
+                   && (cand.outer_slots.at(j).second == slot);
+        if(dirty)
+          cands.erase(i, 1);
+      }
+    }
+  }
+
+// Rewrites references in an inlined expression. Parameters are stored in the
+// scope of the caller, and `dist` is the number of scopes between the caller
+// and the scope where the callee was defined.
+void
+do_relocate_inlined(cow_vector<AIR_Node>& code, const cow_vector<phcow_string>& names,
+                    uint32_t base, uint32_t dist)
+  {
+    for(size_t i = 0;  i < code.size();  ++i) {
+      auto& node = code.mut(i);
+      if(node.index() == AIR_Node::index_push_local_reference) {
+        auto& altr = node.mut<AIR_Node::S_push_local_reference>();
+        if(altr.depth == 0) {
+          altr.name = names.at(altr.slot);
+          altr.slot += base;
+        }
+        else
+          altr.depth = static_cast<uint16_t>(altr.depth - 1 + dist);
+      }
+
+      do_for_each_nested(node, false,
+          [&](cow_vector<AIR_Node>& nested) { do_relocate_inlined(nested, names, base, dist);  });
+    }
+  }
+
+void
+do_inline_calls(cow_vector<Inline_Scope>& scopes, cow_vector<AIR_Node>& code);
+
+void
+do_inline_calls_in_scope(cow_vector<Inline_Scope>& scopes, cow_vector<AIR_Node>& code,
+                         uint32_t next_slot)
+  {
+    auto& scope = scopes.emplace_back();
+    scope.next_slot = next_slot;
+    scope.recording = true;
+    do_inline_calls(scopes, code);
+    scopes.pop_back();
+  }
+
+// Replaces calls to small functions with their bodies. Scopes are counted
+// exactly the same way as `rebind_opt()`.
+void
+do_inline_calls(cow_vector<Inline_Scope>& scopes, cow_vector<AIR_Node>& code)
+  {
+    cow_vector<AIR_Node> res;
+    res.reserve(code.size());
+    size_t iscope = scopes.size() - 1;
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      AIR_Node node = code.at(i);
+
+      if((node.index() == AIR_Node::index_declare_variable) && (i + 2 < code.size())
+         && (code.at(i + 1).index() == AIR_Node::index_define_function)
+         && (code.at(i + 2).index() == AIR_Node::index_initialize_variable)
+         && code.at(i + 2).as<AIR_Node::S_initialize_variable>().immutable) {
+        // `func foo(...) { ... }` or `const foo = func(...) { ... };`
+        const auto& var = node.as<AIR_Node::S_declare_variable>();
+        do_forget_slot(scopes, iscope, var.slot);
+        if(scopes.at(iscope).recording)
+          if(auto qcand = do_make_inline_candidate_opt(var,
+                                 code.at(i + 1).as<AIR_Node::S_define_function>(), iscope))
+            scopes.mut(iscope).candidates.emplace_back(move(*qcand));
+
+        res.append(code.begin() + static_cast<ptrdiff_t>(i),
+                   code.begin() + static_cast<ptrdiff_t>(i + 3));
+        i += 2;
+        continue;
+      }
+
+      uint32_t slot = do_get_declared_slot(node);
+      if(slot != UINT32_MAX)
+        do_forget_slot(scopes, iscope, slot);
+
+      opt<Inline_Candidate> qcand;
+      uint32_t dist = 0;
+      if((node.index() == AIR_Node::index_push_local_reference)
+         && (node.as<AIR_Node::S_push_local_reference>().depth <= iscope)) {
+        const auto& local = node.as<AIR_Node::S_push_local_reference>();
+        dist = local.depth;
+        const auto& cands = scopes.at(iscope - dist).candidates;
+        for(size_t k = 0;  k < cands.size();  ++k)
+          if((cands.at(k).slot == local.slot) && (cands.at(k).name == local.name))
+            qcand = cands.at(k);
+      }
+
+      size_t iargs, icall;
+      uint32_t nargs;
+      if(qcand && do_match_call(iargs, icall, nargs, code, i)
+         && (nargs <= qcand->params.size())) {
+        // Evaluate arguments as usual, which may contain other calls to inline.
+        // Missing arguments are null.
+        cow_vector<AIR_Node> code_args(code.begin() + static_cast<ptrdiff_t>(iargs),
+                                       code.begin() + static_cast<ptrdiff_t>(icall));
+        do_inline_calls(scopes, code_args);
+        res.append(code_args.begin(), code_args.end());
+        for(size_t k = nargs;  k < qcand->params.size();  ++k)
+          res.emplace_back(AIR_Node::S_push_constant());
+
+        Source_Location sloc;
+        PTC_Aware ptc;
+        if(code.at(icall).index() == AIR_Node::index_alt_function_call) {
+          sloc = code.at(icall).as<AIR_Node::S_alt_function_call>().sloc;
+          ptc = code.at(icall).as<AIR_Node::S_alt_function_call>().ptc;
+        }
+        else {
+          sloc = code.at(icall).as<AIR_Node::S_function_call>().sloc;
+          ptc = code.at(icall).as<AIR_Node::S_function_call>().ptc;
+        }
+
+        // Move arguments into hidden slots of the current scope. As arguments
+        // are evaluated from left to right, the last one is at the top.
+        uint32_t base = scopes.at(iscope).next_slot;
+        cow_vector<phcow_string> names;
+        for(size_t k = 0;  k < qcand->params.size();  ++k)
+          names.emplace_back(sformat("$1:$2", qcand->name, qcand->params.at(k)));
+
+        AIR_Node::S_inline_call xcall = { sloc, qcand->sloc_func, qcand->func, { } };
+        for(size_t k = names.size() - 1;  k != SIZE_MAX;  --k) {
+          AIR_Node::S_initialize_reference xinit = { sloc, names.at(k),
+                                                     base + static_cast<uint32_t>(k) };
+          xcall.code_body.emplace_back(move(xinit));
+        }
+
+        cow_vector<AIR_Node> code_expr = qcand->code_expr;
+        do_relocate_inlined(code_expr, names, base, dist);
+        xcall.code_body.append(code_expr.begin(), code_expr.end());
+        AIR_Node::S_check_argument xcheck = { qcand->sloc_ret, false };
+        xcall.code_body.emplace_back(move(xcheck));
+        res.emplace_back(move(xcall));
+
+        if(ptc != ptc_aware_none) {
+          // This was a proper tail call, whose result is returned.
+          AIR_Node::S_return_statement xret = { sloc, ptc == ptc_aware_by_ref,
+                                                ptc == ptc_aware_void };
+          res.emplace_back(move(xret));
+        }
+
+        i = icall;
+        continue;
+      }
+
+      if(node.index() == AIR_Node::index_execute_block) {
+        auto& altr = node.mut<AIR_Node::S_execute_block>();
+        do_inline_calls_in_scope(scopes, altr.code_body, do_get_next_slot(altr.code_body, 0));
+      }
+      else if(node.index() == AIR_Node::index_if_statement) {
+        auto& altr = node.mut<AIR_Node::S_if_statement>();
+        if(altr.scopeless_true)
+          do_inline_calls(scopes, altr.code_true);
+        else
+          do_inline_calls_in_scope(scopes, altr.code_true, do_get_next_slot(altr.code_true, 0));
+
+        if(altr.scopeless_false)
+          do_inline_calls(scopes, altr.code_false);
+        else
+          do_inline_calls_in_scope(scopes, altr.code_false,
+                                   do_get_next_slot(altr.code_false, 0));
+      }
+      else if(node.index() == AIR_Node::index_switch_statement) {
+        // Labels are evaluated in the current scope. All clauses share the
+        // same scope, where declarations may be bypassed, so functions there
+        // are not recorded.
+        auto& altr = node.mut<AIR_Node::S_switch_statement>();
+        if(altr.scopeless) {
+          for(size_t k = 0;  k < altr.clauses.size();  ++k) {
+            do_inline_calls(scopes, altr.clauses.mut(k).code_labels);
+            do_inline_calls(scopes, altr.clauses.mut(k).code_body);
+          }
+        }
+        else {
+          uint32_t next = 0;
+          for(size_t k = 0;  k < altr.clauses.size();  ++k) {
+            do_inline_calls(scopes, altr.clauses.mut(k).code_labels);
+            next = do_get_next_slot(altr.clauses.at(k).code_body, next);
+          }
+
+          auto& scope = scopes.emplace_back();
+          scope.next_slot = next;
+          scope.recording = false;
+          for(size_t k = 0;  k < altr.clauses.size();  ++k)
+            do_inline_calls(scopes, altr.clauses.mut(k).code_body);
+          scopes.pop_back();
+        }
+      }
+      else if(node.index() == AIR_Node::index_do_while_statement) {
+        auto& altr = node.mut<AIR_Node::S_do_while_statement>();
+        if(altr.scopeless_body)
+          do_inline_calls(scopes, altr.code_body);
+        else
+          do_inline_calls_in_scope(scopes, altr.code_body, do_get_next_slot(altr.code_body, 0));
+
+        do_inline_calls(scopes, altr.code_cond);
+      }
+      else if(node.index() == AIR_Node::index_while_statement) {
+        auto& altr = node.mut<AIR_Node::S_while_statement>();
+        do_inline_calls(scopes, altr.code_cond);
+        if(altr.scopeless_body)
+          do_inline_calls(scopes, altr.code_body);
+        else
+          do_inline_calls_in_scope(scopes, altr.code_body, do_get_next_slot(altr.code_body, 0));
+      }
+      else if(node.index() == AIR_Node::index_for_each_statement) {
+        // The key and mapped references occupy the first two slots.
+        auto& altr = node.mut<AIR_Node::S_for_each_statement>();
+        auto& scope = scopes.emplace_back();
+        scope.next_slot = do_get_next_slot(altr.code_init, 2);
+        scope.recording = true;
+        do_inline_calls(scopes, altr.code_init);
+        if(altr.scopeless_body)
+          do_inline_calls(scopes, altr.code_body);
+        else
+          do_inline_calls_in_scope(scopes, altr.code_body, do_get_next_slot(altr.code_body, 0));
+        scopes.pop_back();
+      }
+      else if(node.index() == AIR_Node::index_for_statement) {
+        auto& altr = node.mut<AIR_Node::S_for_statement>();
+        auto& scope = scopes.emplace_back();
+        scope.next_slot = do_get_next_slot(altr.code_init, 0);
+        scope.recording = true;
+        do_inline_calls(scopes, altr.code_init);
+        do_inline_calls(scopes, altr.code_cond);
+        do_inline_calls(scopes, altr.code_step);
+        if(altr.scopeless_body)
+          do_inline_calls(scopes, altr.code_body);
+        else
+          do_inline_calls_in_scope(scopes, altr.code_body, do_get_next_slot(altr.code_body, 0));
+        scopes.pop_back();
+      }
+      else if(node.index() == AIR_Node::index_counted_for_statement) {
+        auto& altr = node.mut<AIR_Node::S_counted_for_statement>();
+        auto& scope = scopes.emplace_back();
+        scope.next_slot = do_get_next_slot(altr.code_init, 0);
+        scope.recording = true;
+        do_inline_calls(scopes, altr.code_init);
+        if(altr.scopeless_body)
+          do_inline_calls(scopes, altr.code_body);
+        else
+          do_inline_calls_in_scope(scopes, altr.code_body, do_get_next_slot(altr.code_body, 0));
+        scopes.pop_back();
+      }
+      else if(node.index() == AIR_Node::index_try_statement) {
+        // The exception reference occupies the first slot.
+        auto& altr = node.mut<AIR_Node::S_try_statement>();
+        do_inline_calls_in_scope(scopes, altr.code_try, do_get_next_slot(altr.code_try, 0));
+        do_inline_calls_in_scope(scopes, altr.code_catch, do_get_next_slot(altr.code_catch, 1));
+      }
+      else if(is_any_of(node.index(), { AIR_Node::index_branch_expression,
+                                        AIR_Node::index_coalesce_expression,
+                                        AIR_Node::index_catch_expression })) {
+        // These are evaluated in the current scope.
+        do_for_each_nested(node, false,
+            [&](cow_vector<AIR_Node>& nested) { do_inline_calls(scopes, nested);  });
+      }
+
+      res.emplace_back(move(node));
+    }
+
+    code.swap(res);
+  }
+
+// Replaces member accesses on the global reference `name`, such as
+// `std.string.find`, with bound references to the values of `lib`, including
+// bodies of closures. Members that don't exist are still accessed at run time.
+// If the value is a function, its parent object is bound instead, so it is
+// still called with `this`.
+void
+do_bind_library_members(cow_vector<AIR_Node>& code, const phcow_string& name,
+                        const Value& lib)
+  {
+    cow_vector<AIR_Node> res;
+    res.reserve(code.size());
+
+    for(size_t i = 0;  i < code.size();  ++i) {
+      AIR_Node node = code.at(i);
+      if((node.index() == AIR_Node::index_push_global_reference)
+         && (node.as<AIR_Node::S_push_global_reference>().name == name)) {
+        size_t nkeys = 0;
+        const Value* qval = &lib;
+        while((i + 1 + nkeys < code.size())
+              && (code.at(i + 1 + nkeys).index() == AIR_Node::index_member_access)
+              && qval->is_object()) {
+          auto qmem = qval->as_object().ptr(
+                                code.at(i + 1 + nkeys).as<AIR_Node::S_member_access>().key);
+          if(!qmem)
+            break;
+
+          qval = qmem;
+          nkeys ++;
+        }
+
+        if((nkeys != 0) && qval->is_function()) {
+          qval = &lib;
+          nkeys --;
+          for(size_t k = 0;  k < nkeys;  ++k)
+            qval = qval->as_object().ptr(
+                          code.at(i + 1 + k).as<AIR_Node::S_member_access>().key);
+        }
+
+        if(nkeys != 0) {
+          // `std.math.pi` => `[bound std.math.pi]`
+          // `std.string.find` => `[bound std.string].find`
+          AIR_Node::S_push_bound_reference xnode;
+          xnode.ref.set_temporary(*qval);
+          res.emplace_back(move(xnode));
+          i += nkeys;
+          continue;
+        }
+      }
+
+      do_for_each_nested(node, true,
+          [&](cow_vector<AIR_Node>& nested) { do_bind_library_members(nested, name, lib);  });
+
+      res.emplace_back(move(node));
+    }
+
+    code.swap(res);
+  }
+
+}  // namespace
 
 AIR_Optimizer::
 ~AIR_Optimizer()
@@ -23,6 +1935,7 @@ clear()
   noexcept
   {
     this->m_code.clear();
+    this->m_generator = false;
   }
 
 void
@@ -32,6 +1945,7 @@ reload(const Abstract_Context* ctx_opt, const cow_vector<phcow_string>& params,
   {
     this->m_code.clear();
     this->m_params = params;
+    this->m_generator = false;
 
     if(stmts.empty())
       return;
@@ -43,19 +1957,75 @@ reload(const Abstract_Context* ctx_opt, const cow_vector<phcow_string>& params,
                     ((i != stmts.size() - 1) && !stmts.at(i + 1).is_empty_return())
                     ? ptc_aware_none : ptc_aware_void);
 
+    this->m_generator = do_has_yield_statements(this->m_code);
+
     if(this->m_opts.optimization_level <= 0)
       return;
 
-    // TODO: Insert optimization passes
+    // Bind members of the standard library. `std` is a temporary value, so
+    // scripts can't modify it. Closures are compiled before the enclosing
+    // function, so this is only done for the whole script. Like inlining,
+    // this requires full optimizations.
+    if(!ctx_opt && (this->m_opts.optimization_level >= 2) && this->m_opts.bind_library_members) {
+      auto qlib = global.get_named_reference_opt(&"std");
+      if(qlib && qlib->is_temporary())
+        do_bind_library_members(this->m_code, &"std", qlib->dereference_readonly());
+    }
+
+    // Perform cheap optimizations.
+    do_fold_constants(this->m_code, global);
+
+    if(this->m_opts.optimization_level <= 1)
+      return;
+
+    // Perform full optimizations. Variables that don't escape are not tracked
+    // by the garbage collector. This must precede dead store elimination, which
+    // turns initializers into by-reference arguments. A suspended generator is
+    // a value that refers to its locals, so they may form cycles.
+    if(!this->m_generator) {
+      cow_dictionary<bool> escaping, pending;
+      do_collect_escaping_names(escaping, pending, this->m_code);
+      do_mark_untracked_variables(this->m_code, escaping);
+    }
+
+    // Hooks may inspect local variables in single-step traps, so they must be
+    // preserved in this case.
+    if(!this->m_opts.verbose_single_step_traps) {
+      cow_dictionary<bool> names;
+      do_collect_referenced_names(names, this->m_code);
+      do_eliminate_dead_stores(this->m_code, names);
+
+      // Hoist loop invariants, and convert loops with integer counters into
+      // counted loops. Parameters may alias arguments of the caller.
+      cow_dictionary<bool> aliases;
+      for(size_t k = 0;  k < this->m_params.size();  ++k)
+        aliases.try_emplace(this->m_params.at(k), true);
+
+      bool refs = do_collect_alias_names(aliases, this->m_code);
+      do_optimize_loops(this->m_code, 0, global, aliases, refs);
+
+      // Inline calls to small functions. Parameters occupy the first few
+      // slots of the function scope. Hooks are not invoked for inlined
+      // calls, so they may be disabled for debugging.
+      if(this->m_opts.inline_functions) {
+        cow_vector<Inline_Scope> scopes;
+        auto& scope = scopes.emplace_back();
+        scope.next_slot = do_get_next_slot(this->m_code,
+                                           static_cast<uint32_t>(this->m_params.size()));
+        scope.recording = true;
+        do_inline_calls(scopes, this->m_code);
+      }
+    }
   }
 
 void
 AIR_Optimizer::
 rebind(const Abstract_Context* ctx_opt, const cow_vector<phcow_string>& params,
-       const cow_vector<AIR_Node>& code)
+       bool generator, const cow_vector<AIR_Node>& code)
   {
     this->m_code = code;
     this->m_params = params;
+    this->m_generator = generator;
 
     if(code.empty())
       return;
@@ -67,32 +2037,35 @@ rebind(const Abstract_Context* ctx_opt, const cow_vector<phcow_string>& params,
         this->m_code.mut(k) = move(*qnode);
   }
 
-cow_function
+void
 AIR_Optimizer::
-create_function(const Source_Location& sloc, const cow_string& name)
+count_node_pairs(cow_dictionary<uint64_t>& counts)
+  const
   {
-    cow_string func = name;
-    if(is_cmask(func.front(), cmask_namei) && is_cmask(func.back(), cmask_name)) {
-      // If `name` looks like a function name, append the parameter list
-      // to form a function signature.
-      func << "(";
-      uint32_t off = 0;
-      switch(this->m_params.size())
-        {
-          do {
-            func << ", ";  // fallthrough
-        default:
-            func << this->m_params[off];
-          } while(++off != this->m_params.size());  // fallthrough
-        case 0:
-          break;
-        }
-      func << ")";
+    do_count_node_pairs(counts, this->m_code);
+  }
+
+refcnt_ptr<const Instantiated_Function>
+AIR_Optimizer::
+create_prototype(const Source_Location& sloc, const cow_string& name)
+  {
+    if(this->m_opts.optimization_level >= 1) {
+      // All references have been rebound, so nodes can be fused now.
+      do_fuse_nodes(this->m_code, false);
+      do_fuse_nodes(this->m_code, true);
     }
 
     // Instantiate the function object now.
     return make_refcnt<Instantiated_Function>(
-                       sloc, func, this->m_params, this->m_code);
+                       sloc, do_make_signature(name, this->m_params), this->m_params,
+                       this->m_generator, this->m_code);
+  }
+
+cow_function
+AIR_Optimizer::
+create_function(const Source_Location& sloc, const cow_string& name)
+  {
+    return this->create_prototype(sloc, name);
   }
 
 }  // namespace asteria
@@ -12,10 +12,13 @@ Analytic_Context(Uxtc_function, const Abstract_Context* parent_opt,
   :
     m_parent_opt(parent_opt)
   {
-    // Set parameters, which are local references.
+    // Set parameters, which are local references. They occupy the first few
+    // slots, in order.
     for(const auto& name : params)
-      if(is_cmask(name[0], cmask_namei))
+      if(is_cmask(name[0], cmask_namei)) {
         this->do_mut_named_reference(nullptr, name);
+        this->insert_slot(name);
+      }
 
     // Set pre-defined references.
     // N.B. If you have ever changed these, remember to update
@@ -30,4 +33,23 @@ Analytic_Context::
   {
   }
 
+uint32_t
+Analytic_Context::
+insert_slot(const phcow_string& name)
+  {
+    uint32_t slot = static_cast<uint32_t>(this->m_slots.size());
+    return this->m_slots.try_emplace(name, slot).first->second;
+  }
+
+uint32_t
+Analytic_Context::
+find_slot(const phcow_string& name)
+  const noexcept
+  {
+    auto qslot = this->m_slots.find(name);
+    if(qslot == this->m_slots.end())
+      return UINT32_MAX;
+    return qslot->second;
+  }
+
 }  // namespace asteria
@@ -8,6 +8,7 @@
 #include "../../runtime/enums.hpp"
 #include "../../runtime/variable.hpp"
 #include "../../runtime/instantiated_function.hpp"
+#include "../../runtime/global_context.hpp"
 #include "../../llds/avm_rod.hpp"
 #include "../../llds/reference_stack.hpp"
 #include "../../utils.hpp"
@@ -21,6 +22,12 @@ Executive_Context(Uxtc_function, Global_Context& xglobal, AIR_Status& xstatus,
     m_parent_opt(nullptr), m_global(&xglobal), m_status(&xstatus),
     m_stack(&xstack), m_alt_stack(&ystack), m_func(&xfunc)
   {
+    // Reuse storage of a previous call, if any. As stacks may be swapped
+    // during execution, the one to return is stored separately.
+    this->m_global->acquire_frame(this->do_mut_named_reference_storage(),
+                                  this->do_mut_slotted_reference_storage(), ystack);
+    this->m_pooled_stack_opt = &ystack;
+
     // Set the `this` reference, but only if it is a temporary value or a
     // variable. When `this` is void, it is likely that it is never
     // referenced in the function, so lazy initialization is performed to
@@ -30,16 +37,18 @@ Executive_Context(Uxtc_function, Global_Context& xglobal, AIR_Status& xstatus,
 
     // Set arguments. Because arguments are evaluated from left to right, the
     // reference at the top is the last argument.
+    // Parameters occupy the first few slots, in order.
     uint32_t nargs = this->m_stack->size();
+    uint32_t slot = 0;
     bool has_ellipsis = false;
 
     for(const auto& name : this->m_func->params())
       if(name == "...")
         has_ellipsis = true;
       else if(nargs == 0)
-        this->do_mut_named_reference(nullptr, name).set_temporary(nullopt);
+        this->insert_slotted_reference(slot++, name).set_temporary(nullopt);
       else
-        this->do_mut_named_reference(nullptr, name).swap(this->m_stack->mut_top(--nargs));
+        this->insert_slotted_reference(slot++, name).swap(this->m_stack->mut_top(--nargs));
 
     if(nargs != 0) {
       // Move all arguments into the variadic argument getter.
@@ -56,6 +65,11 @@ Executive_Context(Uxtc_function, Global_Context& xglobal, AIR_Status& xstatus,
 Executive_Context::
 ~Executive_Context()
   {
+    // Return storage of a function context to the pool.
+    if(this->m_pooled_stack_opt)
+      this->m_global->release_frame(this->do_mut_named_reference_storage(),
+                                    this->do_mut_slotted_reference_storage(),
+                                    *(this->m_pooled_stack_opt));
   }
 
 Reference*
@@ -139,7 +153,7 @@ Executive_Context::
 do_on_scope_exit_exceptional_slow(Runtime_Error& except)
   {
     // Execute all deferred expressions backwards. If an exception is thrown,
-    // replace `except` with it.
+    // replace `except` with it, unless `except` can't be caught.
     while(!this->m_defer.empty()) {
       auto pair = move(this->m_defer.mut_back());
       this->m_defer.pop_back();
@@ -149,10 +163,25 @@ do_on_scope_exit_exceptional_slow(Runtime_Error& except)
         ASTERIA_ASSERT(*(this->m_status) == air_status_next);
       }
       catch(Runtime_Error& nested) {
-        except = nested;
+        if(!except.is_uncatchable())
+          except = nested;
         except.push_frame_defer(pair.first);
       }
     }
   }
 
+void
+Executive_Context::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+  const
+  {
+    this->Abstract_Context::collect_variables(staged, temp);
+
+    for(const auto& pair : this->m_defer)
+      pair.second.collect_variables(staged, temp);
+
+    for(const auto& arg : this->m_lazy_args)
+      arg.collect_variables(staged, temp);
+  }
+
 }  // namespace asteria
@@ -0,0 +1,411 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "../xprecompiled.hpp"
+#include "../../runtime/generator.hpp"
+#include "../../runtime/global_context.hpp"
+#include "../../runtime/executive_context.hpp"
+#include "../../runtime/runtime_error.hpp"
+#include "../../runtime/argument_reader.hpp"
+#include "../../llds/reference_stack.hpp"
+#include "../../utils.hpp"
+#if defined __x86_64__ && defined __ELF__ && !(defined __CET__ && (__CET__ & 2))
+#  define ASTERIA_STACK_CONTEXT_X86_64_  1
+#elif !defined ASTERIA_NO_UCONTEXT
+#  include <ucontext.h>  // ::getcontext(), ::makecontext(), ::swapcontext()
+#endif
+#include <exception>  // ::std::exception_ptr
+namespace asteria {
+namespace {
+
+#if defined ASTERIA_STACK_CONTEXT_X86_64_
+// Stacks are switched by hand, which saves only the stack pointer and the
+// frame pointer; other registers are clobbered, so the compiler saves them
+// if they are in use. Unlike `swapcontext()`, this doesn't make a system call
+// to save and restore the signal mask. This follows the System V ABI, and is
+// not used with shadow stacks, which would have to be switched as well.
+#  define ASTERIA_STACK_CONTEXT_  1
+
+struct Stack_Context
+  {
+    void* sp;
+  };
+
+void
+do_make_stack_context(Stack_Context& ctx, void* stack, size_t size, void entry())
+  noexcept
+  {
+    // `entry` is jumped to, with a null return address, as it never returns.
+    void** sp = reinterpret_cast<void**>(static_cast<char*>(stack) + size);
+    *--sp = nullptr;
+    *--sp = reinterpret_cast<void*>(entry);
+    ctx.sp = sp;
+  }
+
+__attribute__((__noinline__, __noipa__))
+void
+do_swap_stack_context(Stack_Context& save, const Stack_Context& load)
+  noexcept
+  {
+    void** psave = &(save.sp);
+    void* sp = load.sp;
+    __asm__ volatile (
+      "{push %%rbp; lea 1f(%%rip), %%rax; push %%rax; mov %%rsp, (%%rdi);"
+      " mov %%rsi, %%rsp; pop %%rax; jmp *%%rax; 1: endbr64; pop %%rbp"
+      "|push rbp; lea rax, [rip + 1f]; push rax; mov [rdi], rsp;"
+      " mov rsp, rsi; pop rax; jmp rax; 1: endbr64; pop rbp}"
+      : "+D"(psave), "+S"(sp)
+      :
+      : "rax", "rbx", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13",
+        "r14", "r15", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6",
+        "xmm7", "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14",
+        "xmm15", "memory", "cc");
+  }
+#elif !defined ASTERIA_NO_UCONTEXT
+#  define ASTERIA_STACK_CONTEXT_  1
+
+struct Stack_Context
+  {
+    ::ucontext_t uc;
+  };
+
+void
+do_make_stack_context(Stack_Context& ctx, void* stack, size_t size, void entry())
+  noexcept
+  {
+    ::getcontext(&(ctx.uc));
+    ctx.uc.uc_stack.ss_sp = stack;
+    ctx.uc.uc_stack.ss_size = size;
+    ctx.uc.uc_link = nullptr;
+    ::makecontext(&(ctx.uc), entry, 0);
+  }
+
+void
+do_swap_stack_context(Stack_Context& save, const Stack_Context& load)
+  noexcept
+  {
+    ::swapcontext(&(save.uc), &(load.uc));
+  }
+#endif
+
+enum Coroutine_State : uint8_t
+  {
+    coroutine_initial    = 0,
+    coroutine_suspended  = 1,
+    coroutine_running    = 2,
+    coroutine_finished   = 3,
+  };
+
+}  // namespace
+
+struct Generator::Coroutine
+  {
+    // The innermost coroutine that is running on this thread
+    static thread_local Coroutine* current;
+
+    const Instantiated_Function* func;
+    Reference self;
+    Reference_Stack stack;
+    Global_Context* global = nullptr;
+    Coroutine* prev = nullptr;
+
+    Coroutine_State state = coroutine_initial;
+    bool cancelled = false;
+    void* segment = nullptr;
+#ifdef ASTERIA_STACK_CONTEXT_
+    Stack_Context caller;
+    Stack_Context callee;
+#endif
+    const Executive_Context* ctx_suspended = nullptr;
+    const void* caller_base = nullptr;
+    const void* callee_base = nullptr;
+    ::std::exception_ptr caught;
+
+    Value value;
+    ::std::exception_ptr except;
+
+    [[noreturn]]
+    static
+    void
+    do_run()
+      {
+        auto co = current;
+
+        // Arguments are bound here, on the new stack. Exceptions can't be
+        // unwound across stacks, so they are rethrown by the resumer.
+        try {
+          Reference xself = move(co->self);
+          co->func->invoke_body(xself, *(co->global), move(co->stack));
+          xself.check_function_result(*(co->global), move(co->stack));
+        }
+        catch(...) {
+          co->except = ::std::current_exception();
+        }
+
+        co->do_leave(coroutine_finished);
+        ASTERIA_TERMINATE(("Finished coroutine resumed"));
+      }
+
+    void
+    do_enter(Global_Context& xglobal)
+      {
+        // Switch to the stack of the coroutine. This returns when it yields a
+        // value or finishes.
+        this->global = &xglobal;
+        this->prev = current;
+        current = this;
+        this->caller_base = xglobal.get_recursion_base();
+        xglobal.set_recursion_base(this->callee_base);
+        this->caught = ::std::current_exception();
+        this->state = coroutine_running;
+#ifdef ASTERIA_STACK_CONTEXT_
+        do_swap_stack_context(this->caller, this->callee);
+#endif
+        this->caught = nullptr;
+      }
+
+    void
+    do_leave(Coroutine_State next)
+      {
+        // Switch back to the stack of the resumer.
+        this->state = next;
+        this->callee_base = this->global->get_recursion_base();
+        this->global->set_recursion_base(this->caller_base);
+        current = this->prev;
+#ifdef ASTERIA_STACK_CONTEXT_
+        do_swap_stack_context(this->callee, this->caller);
+#endif
+      }
+  };
+
+thread_local Generator::Coroutine* Generator::Coroutine::current;
+
+Generator::
+Generator(const refcnt_ptr<const Instantiated_Function>& xfunc, Reference&& xself,
+          Reference_Stack&& xstack)
+  :
+    m_func(xfunc), m_co(new Coroutine)
+  {
+    this->m_co->func = this->m_func.get();
+    this->m_co->self = move(xself);
+    this->m_co->stack = move(xstack);
+  }
+
+Generator::
+~Generator()
+  {
+    // A generator that has been started is kept alive by its global context
+    // until it finishes, so its function body is never unwound here.
+    if(this->m_co->state == coroutine_running)
+      ASTERIA_TERMINATE(("Running generator destroyed"));
+    else if(this->m_co->state == coroutine_suspended)
+      ASTERIA_TERMINATE(("Suspended generator destroyed"));
+  }
+
+void
+Generator::
+do_finish(Global_Context& global)
+  const noexcept
+  {
+    // The function body has completed, so its stack is no longer needed.
+    auto co = this->m_co.get();
+    ASTERIA_ASSERT(co->state == coroutine_finished);
+    global.release_generator_stack(co->segment);
+    co->segment = nullptr;
+    global.detach_generator(*this);
+    co->global = nullptr;
+  }
+
+void
+Generator::
+do_cancel()
+  const noexcept
+  {
+    auto co = this->m_co.get();
+    if(co->state != coroutine_suspended)
+      return;
+
+    // Unwind the function body, so its deferred expressions are executed and
+    // all its contexts are destroyed. The result is discarded.
+    auto& global = *(co->global);
+    co->cancelled = true;
+    co->do_enter(global);
+    this->do_finish(global);
+    co->except = nullptr;
+  }
+
+void
+Generator::
+cancel()
+  const noexcept
+  {
+    // The global context releases its reference to this generator when it is
+    // finished, which may be the last one, so keep it alive.
+    if(this->m_co->state != coroutine_suspended)
+      return;
+
+    this->add_reference();
+    refcnt_ptr<const Generator> pin(this);
+    this->do_cancel();
+  }
+
+bool
+Generator::
+finished()
+  const noexcept
+  {
+    return this->m_co->state == coroutine_finished;
+  }
+
+bool
+Generator::
+resume(Value& value, Global_Context& global)
+  const
+  {
+    auto co = this->m_co.get();
+    switch(co->state)
+      {
+      case coroutine_initial:
+        {
+#ifndef ASTERIA_STACK_CONTEXT_
+          throw Runtime_Error(xtc_format,
+                   "Generator `$1` not supported on this platform", this->m_func->func());
+#else
+          // Abandoned generators are unwound before a new one is started, so
+          // their stacks can be reused.
+          global.finalize_generators();
+
+          // The function body will be executed on a stack of its own.
+          co->segment = global.allocate_generator_stack();
+          if(!co->segment)
+            throw Runtime_Error(xtc_format,
+                     "Could not allocate stack for generator `$1`", this->m_func->func());
+
+          try {
+            this->add_reference();
+            refcnt_ptr<const Generator> self(this);
+            global.attach_generator(self);
+          }
+          catch(...) {
+            global.release_generator_stack(co->segment);
+            co->segment = nullptr;
+            throw;
+          }
+
+          do_make_stack_context(co->callee, co->segment, Global_Context::generator_stack_size,
+                                Coroutine::do_run);
+          co->callee_base = static_cast<char*>(co->segment) + Global_Context::generator_stack_size;
+          break;
+#endif
+        }
+
+      case coroutine_suspended:
+        {
+          if(co->global != &global)
+            throw Runtime_Error(xtc_format,
+                     "Generator `$1` resumed in another global context",
+                     this->m_func->func());
+          break;
+        }
+
+      case coroutine_running:
+        throw Runtime_Error(xtc_format,
+                 "Generator `$1` already running", this->m_func->func());
+
+      case coroutine_finished:
+        return false;
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), co->state);
+      }
+
+    co->do_enter(global);
+    if(co->state == coroutine_suspended) {
+      value = move(co->value);
+      return true;
+    }
+
+    this->do_finish(global);
+    if(co->except) {
+      auto except = move(co->except);
+      ::std::rethrow_exception(except);
+    }
+    return false;
+  }
+
+void
+Generator::
+yield(const Executive_Context& ctx, Value&& value)
+  {
+    auto co = Coroutine::current;
+    if(!co || (co->global != &(ctx.global())))
+      throw Runtime_Error(xtc_format, "`yield` outside a generator");
+
+    // Exceptions that are being handled are tracked per thread, not per stack,
+    // so a `catch` clause (or a `defer` expression that is executed because of
+    // an exception) can't be suspended.
+    if(::std::current_exception() != co->caught)
+      throw Runtime_Error(xtc_format, "`yield` inside `catch` not allowed");
+
+    co->value = move(value);
+    co->ctx_suspended = &ctx;
+    co->do_leave(coroutine_suspended);
+    co->ctx_suspended = nullptr;
+
+    if(co->cancelled)
+      throw Runtime_Error(xtc_cancel);
+  }
+
+tinyfmt&
+Generator::
+describe(tinyfmt& fmt)
+  const
+  {
+    return format(fmt, "generator of `$1` at '$2'", this->m_func->func(), this->m_func->sloc());
+  }
+
+void
+Generator::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
+  const
+  {
+    this->m_func->collect_variables(staged, temp);
+
+    auto co = this->m_co.get();
+    if(co->state == coroutine_initial) {
+      co->self.collect_variables(staged, temp);
+      co->stack.collect_variables(staged, temp);
+    }
+
+    if(co->state == coroutine_suspended) {
+      // A suspended call holds references in its contexts, from the one where
+      // `yield` was executed to the function context. All contexts of the
+      // call share the same pair of stacks.
+      co->ctx_suspended->stack().collect_variables(staged, temp);
+      co->ctx_suspended->alt_stack().collect_variables(staged, temp);
+      for(auto ctx = co->ctx_suspended;  ctx;  ctx = ctx->get_parent_opt())
+        ctx->collect_variables(staged, temp);
+    }
+  }
+
+void
+Generator::
+invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stack)
+  const
+  {
+    Argument_Reader reader(&"generator", move(stack));
+
+    // A generator takes no argument. It returns the next value, or `null`
+    // if it has completed.
+    reader.start_overload();
+    if(!reader.end_overload())
+      reader.throw_no_matching_function_call();
+
+    Value value;
+    if(this->resume(value, global))
+      self.set_temporary(move(value));
+    else
+      self.set_temporary(nullopt);
+  }
+
+}  // namespace asteria
@@ -7,6 +7,8 @@
 #include "../../runtime/random_engine.hpp"
 #include "../../runtime/module_loader.hpp"
 #include "../../runtime/abstract_hooks.hpp"
+#include "../../runtime/runtime_error.hpp"
+#include "../../runtime/generator.hpp"
 #include "../../library/version.hpp"
 #include "../../library/gc.hpp"
 #include "../../library/system.hpp"
@@ -26,6 +28,12 @@
 #include "../../library/rsa.hpp"
 #include "../../utils.hpp"
 #include <algorithm>
+#include <time.h>  // ::clock_gettime(), ::timespec
+#if !defined ASTERIA_NO_UCONTEXT
+#include <ucontext.h>  // ::getcontext(), ::makecontext(), ::swapcontext()
+#endif
+#include <sys/mman.h>  // ::mmap(), ::mprotect(), ::munmap()
+#include <exception>  // ::std::exception_ptr
 namespace asteria {
 namespace {
 
@@ -57,6 +65,80 @@ constexpr s_modules[] =
     { api_version_0002_0000,  "rsa",         create_bindings_rsa         },
   };
 
+// The clock is read once per this number of safepoints, while a time limit
+// is in effect.
+constexpr uint32_t deadline_check_interval = 256;
+
+int64_t
+do_get_monotonic_msecs()
+  noexcept
+  {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_COARSE
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (int64_t) ts.tv_sec * 1000 + (uint32_t) ts.tv_nsec / 1000000;
+  }
+
+// Stack segments are reserved, but memory is only committed when it is used.
+// The lowest page is a guard page. Some segments are kept for reuse.
+constexpr size_t stack_guard_size = 4096;
+constexpr size_t max_pooled_stack_segments = 8;
+constexpr size_t max_pooled_generator_stacks = 16;
+
+void*
+do_map_stack(size_t size)
+  {
+    void* stack = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if(stack == MAP_FAILED)
+      return nullptr;
+
+    // A segment without a guard page could overflow silently.
+    if(::mprotect(stack, stack_guard_size, PROT_NONE) != 0) {
+      ::munmap(stack, size);
+      return nullptr;
+    }
+
+    return stack;
+  }
+
+// Storage of finished calls is kept for reuse up to these numbers, so a deep
+// recursion doesn't keep its peak number of frames for the rest of the life
+// of the context.
+constexpr size_t max_pooled_frames = 64;
+constexpr size_t max_pooled_ptc_arguments = 64;
+
+#if !defined ASTERIA_NO_UCONTEXT
+struct Stack_Segment_Call
+  {
+    ::ucontext_t caller;
+    void (*fn)(void*);
+    void* param;
+    ::std::exception_ptr except;
+  };
+
+// `makecontext()` can only pass integers, so the call is passed here.
+thread_local Stack_Segment_Call* s_segment_call;
+
+void
+do_run_stack_segment()
+  {
+    auto call = s_segment_call;
+
+    // Exceptions can't be unwound across stacks, so they are rethrown by the
+    // caller. When this function returns, the caller is resumed.
+    try {
+      call->fn(call->param);
+    }
+    catch(...) {
+      call->except = ::std::current_exception();
+    }
+  }
+#endif
+
 struct Module_Comparator
   {
     bool
@@ -109,10 +191,379 @@ Global_Context(API_Version api_version_req)
 Global_Context::
 ~Global_Context()
   {
+    // Unwind suspended generators while this context is still intact. They
+    // can't be resumed afterwards, and destroying them later would need this
+    // context.
+    while(!this->m_generators.empty()) {
+      auto gen = this->m_generators.back();
+      gen->cancel();
+    }
+
     // Perform the final garbage collection. Note if there are still cyclic
     // references afterwards, they are left uncollected!
     this->do_clear_named_references();
+    this->m_generation ++;
+    this->m_frame_pool.clear();
+    this->m_ptc_pool.clear();
     unerase_cast<Garbage_Collector*>(this->m_gcoll.get())->finalize();
+
+    // Segments may have been released during the final garbage collection.
+    this->clear_pooled_stack_segments();
+  }
+
+void
+Global_Context::
+acquire_frame(Reference_Dictionary& named_refs,
+              cow_bivector<phcow_string, Reference>& slotted_refs,
+              Reference_Stack& alt_stack)
+  {
+    ASTERIA_ASSERT(named_refs.size() == 0);
+    ASTERIA_ASSERT(slotted_refs.empty());
+    ASTERIA_ASSERT(alt_stack.size() == 0);
+
+    if(this->m_frame_pool.empty()) {
+      // Every frame that is in use or in the pool has been allocated here, so
+      // reserving room for all of them ensures `release_frame()` will not
+      // need to allocate memory. Frames beyond the limit are not pooled.
+      this->m_frame_pool.reserve(min(this->m_frame_misses + 1, max_pooled_frames));
+      this->m_frame_misses ++;
+      return;
+    }
+
+    auto& frame = this->m_frame_pool.mut_back();
+    named_refs.swap(frame.named_refs);
+    slotted_refs.swap(frame.slotted_refs);
+    alt_stack.swap(frame.alt_stack);
+    this->m_frame_pool.pop_back();
+    this->m_frame_hits ++;
+  }
+
+void
+Global_Context::
+release_frame(Reference_Dictionary& named_refs,
+              cow_bivector<phcow_string, Reference>& slotted_refs,
+              Reference_Stack& alt_stack)
+  noexcept
+  {
+    named_refs.clear();
+    slotted_refs.clear();
+    alt_stack.clear();
+
+    // Storage that cannot be reused is deallocated instead.
+    if((this->m_frame_pool.size() >= this->m_frame_pool.capacity())
+       || (this->m_frame_pool.size() >= max_pooled_frames))
+      return;
+
+    auto& frame = this->m_frame_pool.emplace_back();
+    named_refs.swap(frame.named_refs);
+    slotted_refs.swap(frame.slotted_refs);
+    alt_stack.swap(frame.alt_stack);
+  }
+
+void
+Global_Context::
+clear_pooled_stack_segments()
+  noexcept
+  {
+    for(void* stack : this->m_stack_pool)
+      ::munmap(stack, Global_Context::stack_segment_size);
+
+    for(void* stack : this->m_generator_stack_pool)
+      ::munmap(stack, Global_Context::generator_stack_size);
+
+    this->m_stack_pool.clear();
+    this->m_generator_stack_pool.clear();
+  }
+
+void*
+Global_Context::
+allocate_stack_segment()
+  {
+    if(!this->m_stack_pool.empty()) {
+      void* stack = this->m_stack_pool.back();
+      this->m_stack_pool.pop_back();
+      return stack;
+    }
+
+    // Reserve room for segments to be pooled, so they can be released without
+    // allocating memory.
+    this->m_stack_pool.reserve(max_pooled_stack_segments);
+    return do_map_stack(stack_segment_size);
+  }
+
+void
+Global_Context::
+release_stack_segment(void* stack)
+  noexcept
+  {
+    if(this->m_stack_pool.size() < max_pooled_stack_segments)
+      this->m_stack_pool.emplace_back(stack);
+    else
+      ::munmap(stack, stack_segment_size);
+  }
+
+void*
+Global_Context::
+allocate_generator_stack()
+  {
+    if(!this->m_generator_stack_pool.empty()) {
+      void* stack = this->m_generator_stack_pool.back();
+      this->m_generator_stack_pool.pop_back();
+      return stack;
+    }
+
+    this->m_generator_stack_pool.reserve(max_pooled_generator_stacks);
+    return do_map_stack(generator_stack_size);
+  }
+
+void
+Global_Context::
+release_generator_stack(void* stack)
+  noexcept
+  {
+    if(this->m_generator_stack_pool.size() < max_pooled_generator_stacks)
+      this->m_generator_stack_pool.emplace_back(stack);
+    else
+      ::munmap(stack, generator_stack_size);
+  }
+
+void
+Global_Context::
+attach_generator(const refcnt_ptr<const Generator>& gen)
+  {
+    this->m_generators.emplace_back(gen);
+  }
+
+void
+Global_Context::
+detach_generator(const Generator& gen)
+  noexcept
+  {
+    // Generators are usually finished in reverse order.
+    for(size_t k = this->m_generators.size() - 1;  k != SIZE_MAX;  --k)
+      if(this->m_generators[k].get() == &gen) {
+        this->m_generators.erase(k, 1);
+        return;
+      }
+  }
+
+void
+Global_Context::
+finalize_generators()
+  {
+    // Cancelling a generator executes its `defer` expressions, which may start
+    // or finish other generators, so the index is checked in each iteration.
+    size_t k = this->m_generators.size();
+    while(k != 0) {
+      k --;
+      if(k >= this->m_generators.size())
+        continue;
+
+      if(!this->m_generators[k].unique())
+        continue;
+
+      auto gen = this->m_generators[k];
+      gen->cancel();
+    }
+  }
+
+void
+Global_Context::
+call_on_new_stack(void fn(void*), void* param)
+  {
+#if defined ASTERIA_NO_UCONTEXT
+    // Stacks can't be switched, so only the recursion sentry applies.
+    fn(param);
+#else
+    void* stack = this->allocate_stack_segment();
+    if(!stack) {
+      fn(param);
+      return;
+    }
+
+    Stack_Segment_Call call;
+    call.fn = fn;
+    call.param = param;
+
+    ::ucontext_t callee;
+    ::getcontext(&callee);
+    callee.uc_stack.ss_sp = stack;
+    callee.uc_stack.ss_size = stack_segment_size;
+    callee.uc_link = &(call.caller);
+    ::makecontext(&callee, do_run_stack_segment, 0);
+
+    // The recursion sentry measures usage of the new segment from its top.
+    const void* old_base = this->m_sentry.get_base();
+    this->m_sentry.set_base(static_cast<char*>(stack) + stack_segment_size);
+    this->m_stack_segments ++;
+    s_segment_call = &call;
+    ::swapcontext(&(call.caller), &callee);
+    this->m_stack_segments --;
+    this->m_sentry.set_base(old_base);
+    this->release_stack_segment(stack);
+
+    if(call.except)
+      ::std::rethrow_exception(call.except);
+#endif
+  }
+
+refcnt_ptr<PTC_Arguments>
+Global_Context::
+acquire_ptc_arguments(const Source_Location& sloc, PTC_Aware ptc,
+                      const cow_function& target, Reference&& self,
+                      Reference_Stack& stack)
+  {
+    refcnt_ptr<PTC_Arguments> ptcg;
+
+    if(this->m_ptc_pool.empty()) {
+      // Reserve room for all arguments that have been allocated, so
+      // `release_ptc_arguments()` will not need to allocate memory.
+      this->m_ptc_pool.reserve(min(this->m_ptc_misses + 1, max_pooled_ptc_arguments));
+      ptcg = make_refcnt<PTC_Arguments>(sloc, ptc, target, move(self), Reference_Stack());
+      this->m_ptc_misses ++;
+    }
+    else {
+      ptcg = move(this->m_ptc_pool.mut_back());
+      this->m_ptc_pool.pop_back();
+      ptcg->reload(sloc, ptc, target, move(self));
+      this->m_ptc_hits ++;
+    }
+
+    ptcg->mut_stack().swap(stack);
+    return ptcg;
+  }
+
+void
+Global_Context::
+release_ptc_arguments(refcnt_ptr<PTC_Arguments>&& ptcg)
+  noexcept
+  {
+    // Arguments that cannot be reused are deallocated instead.
+    if((ptcg.use_count() != 1)
+       || (this->m_ptc_pool.size() >= this->m_ptc_pool.capacity())
+       || (this->m_ptc_pool.size() >= max_pooled_ptc_arguments)) {
+      ptcg.reset();
+      return;
+    }
+
+    ptcg->clear();
+    this->m_ptc_pool.emplace_back(move(ptcg));
+  }
+
+void
+Global_Context::
+do_set_safepoint_flags(uint32_t set, uint32_t clear)
+  noexcept
+  {
+    // This may be called from a signal handler, so it must be lock-free.
+    uint32_t flags = this->m_safepoint_flags.load();
+    while(!this->m_safepoint_flags.cmpxchg_weak(flags, (flags | set) & ~clear));
+  }
+
+void
+Global_Context::
+do_check_safepoint_slow(Executive_Context& ctx)
+  {
+    uint32_t flags = this->m_safepoint_flags.load();
+
+    if(flags & safepoint_fuel) {
+      // This exception is not intercepted by `try` or `catch` in scripts, so
+      // it always reaches the host.
+      if(this->m_fuel == 0)
+        throw Runtime_Error(xtc_fuel);
+
+      this->m_fuel --;
+    }
+
+    if(flags & safepoint_deadline) {
+      // This exception is not intercepted by scripts either. Once the time
+      // limit has been reached, it stays in effect, so `defer` expressions
+      // can't run forever.
+      if(-- this->m_deadline_countdown == 0) {
+        this->m_deadline_countdown = deadline_check_interval;
+        if(do_get_monotonic_msecs() >= this->m_deadline) {
+          this->m_deadline_countdown = 1;
+          throw Runtime_Error(xtc_timeout);
+        }
+      }
+    }
+
+    if(flags & safepoint_interrupt) {
+      this->do_set_safepoint_flags(0, safepoint_interrupt);
+
+      if(this->m_hook_mask & hook_mask_interrupt)
+        this->get_hooks_opt()->on_interrupt(ctx);
+      else
+        throw Runtime_Error(xtc_interrupt);
+    }
+  }
+
+void
+Global_Context::
+request_interrupt()
+  noexcept
+  {
+    this->do_set_safepoint_flags(safepoint_interrupt, 0);
+  }
+
+void
+Global_Context::
+cancel_interrupt()
+  noexcept
+  {
+    this->do_set_safepoint_flags(0, safepoint_interrupt);
+  }
+
+bool
+Global_Context::
+is_interrupt_pending()
+  const noexcept
+  {
+    return this->m_safepoint_flags.load() & safepoint_interrupt;
+  }
+
+void
+Global_Context::
+set_time_limit(int64_t msecs)
+  noexcept
+  {
+    this->m_deadline = do_get_monotonic_msecs() + clamp_cast<int64_t>(msecs, 0, INT32_MAX);
+    this->m_deadline_countdown = 1;
+    this->do_set_safepoint_flags(safepoint_deadline, 0);
+  }
+
+void
+Global_Context::
+clear_time_limit()
+  noexcept
+  {
+    this->do_set_safepoint_flags(0, safepoint_deadline);
+  }
+
+void
+Global_Context::
+set_fuel(uint64_t fuel)
+  noexcept
+  {
+    this->m_fuel = fuel;
+    this->do_set_safepoint_flags(safepoint_fuel, 0);
+  }
+
+void
+Global_Context::
+add_fuel(uint64_t fuel)
+  noexcept
+  {
+    this->m_fuel += ::std::min(fuel, UINT64_MAX - this->m_fuel);
+  }
+
+void
+Global_Context::
+clear_fuel()
+  noexcept
+  {
+    this->do_set_safepoint_flags(0, safepoint_fuel);
+    this->m_fuel = 0;
   }
 
 API_Version
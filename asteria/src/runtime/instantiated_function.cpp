@@ -9,6 +9,7 @@
 #include "../../runtime/abstract_hooks.hpp"
 #include "../../runtime/runtime_error.hpp"
 #include "../../runtime/ptc_arguments.hpp"
+#include "../../runtime/generator.hpp"
 #include "../../runtime/enums.hpp"
 #include "../../llds/reference_stack.hpp"
 #include "../../utils.hpp"
@@ -16,15 +17,25 @@ namespace asteria {
 
 Instantiated_Function::
 Instantiated_Function(const Source_Location& xsloc, const cow_string& xfunc,
-                      const cow_vector<phcow_string>& xparams, const cow_vector<AIR_Node>& code)
+                      const cow_vector<phcow_string>& xparams, bool xgenerator,
+                      const cow_vector<AIR_Node>& code)
   :
-    m_sloc(xsloc), m_func(xfunc), m_params(xparams)
+    m_sloc(xsloc), m_func(xfunc), m_params(xparams), m_generator(xgenerator)
   {
     for(size_t i = 0;  i < code.size();  ++i)
       code.at(i).solidify(this->m_rod);
     this->m_rod.finalize();
   }
 
+Instantiated_Function::
+Instantiated_Function(const refcnt_ptr<const Instantiated_Function>& xproto,
+                      cow_vector<Reference>&& xcaptures)
+  :
+    m_sloc(xproto->m_sloc), m_func(xproto->m_func), m_params(xproto->m_params),
+    m_generator(xproto->m_generator), m_proto_opt(xproto), m_captures(move(xcaptures))
+  {
+  }
+
 Instantiated_Function::
 ~Instantiated_Function()
   {
@@ -44,11 +55,57 @@ collect_variables(Variable_HashMap& staged, Variable_HashMap& temp)
   const
   {
     this->m_rod.collect_variables(staged, temp);
+
+    if(this->m_proto_opt)
+      this->m_proto_opt->collect_variables(staged, temp);
+
+    for(const auto& ref : this->m_captures)
+      ref.collect_variables(staged, temp);
   }
 
 void
 Instantiated_Function::
 invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stack)
+  const
+  {
+    if(this->m_generator) {
+      // Arguments are bound when the generator is resumed for the first time.
+      // The generator keeps a reference to this function.
+      this->add_reference();
+      refcnt_ptr<const Instantiated_Function> func(this);
+      auto gen = make_refcnt<Generator>(func, move(self), move(stack));
+      self.set_temporary(cow_function(move(gen)));
+      return;
+    }
+
+    if(ASTERIA_UNEXPECT(global.is_stack_nearly_full())) {
+      // Continue on a new stack segment. If no segment can be allocated, the
+      // body is called on the current stack, where the recursion sentry
+      // still applies.
+      struct Call
+        {
+          const Instantiated_Function* func;
+          Reference* self;
+          Global_Context* global;
+          Reference_Stack* stack;
+        }
+      call = { this, &self, &global, &stack };
+
+      global.call_on_new_stack(
+          +[](void* param) {
+            auto& c = *static_cast<Call*>(param);
+            c.func->invoke_body(*(c.self), *(c.global), move(*(c.stack)));
+          },
+          &call);
+      return;
+    }
+
+    this->invoke_body(self, global, move(stack));
+  }
+
+void
+Instantiated_Function::
+invoke_body(Reference& self, Global_Context& global, Reference_Stack&& stack)
   const
   {
     // Create the stack and context for this function.
@@ -57,9 +114,11 @@ invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stac
     Executive_Context fctx(xtc_function, global, status, stack, alt_stack, *this, move(self));
 
     // Execute the function body on the new context.
+    const auto& rod = this->m_proto_opt ? this->m_proto_opt->m_rod : this->m_rod;
     global.call_hook(&Abstract_Hooks::on_function_enter, *this, fctx);
     try {
-      this->m_rod.execute(fctx);
+      global.check_safepoint(fctx);
+      rod.execute(fctx);
     }
     catch(Runtime_Error& except) {
       global.call_hook(&Abstract_Hooks::on_function_leave, *this, fctx);
@@ -268,8 +268,18 @@ void
 Reference::
 do_use_function_result_slow(Global_Context& global, Reference_Stack&& stack)
   {
+    // Arguments are returned to the pool as soon as their calls have been made,
+    // so only data that are needed after return are retained for each frame.
+    struct PTC_Frame
+      {
+        Source_Location sloc;
+        PTC_Aware ptc;
+        refcnt_ptr<const Instantiated_Function> caller_opt;
+        cow_bivector<Source_Location, AVM_Rod> defer;
+      };
+
     refcnt_ptr<PTC_Arguments> ptcg;
-    cow_vector<refcnt_ptr<PTC_Arguments>> frames;
+    cow_vector<PTC_Frame> frames;
     opt<Value> result_value;
     AIR_Status status = air_status_next;
     Reference_Stack alt_stack;
@@ -283,54 +293,61 @@ do_use_function_result_slow(Global_Context& global, Reference_Stack&& stack)
         ASTERIA_ASSERT(ptcg.use_count() == 1);
 
         global.call_hook(&Abstract_Hooks::on_call, ptcg->sloc(), ptcg->target());
-        frames.emplace_back(ptcg);
-        *this = move(ptcg->self());
+        auto& frame = frames.emplace_back();
+        frame.sloc = ptcg->sloc();
+        frame.ptc = ptcg->ptc_aware();
+        frame.caller_opt = ptcg->caller_opt();
+        frame.defer.swap(ptcg->mut_defer());
+
+        *this = move(ptcg->mut_self());
         ptcg->target().invoke_ptc_aware(*this, global, move(ptcg->mut_stack()));
+        global.release_ptc_arguments(move(ptcg));
       }
 
       // Check the result.
-      if(ptcg->ptc_aware() == ptc_aware_void)
+      if(frames.back().ptc == ptc_aware_void)
         this->m_stor = St_void();
       else if(!this->m_stor.ptr<St_void>())
         result_value = this->dereference_readonly();
 
       // This is the normal return path.
       while(!frames.empty()) {
-        ptcg = move(frames.mut_back());
+        auto frame = move(frames.mut_back());
         frames.pop_back();
 
-        if((ptcg->ptc_aware() == ptc_aware_by_val) && result_value) {
+        if((frame.ptc == ptc_aware_by_val) && result_value) {
           // Convert the result.
           auto& st = this->m_stor.emplace<St_temp>();
           st.val = move(*result_value);
         }
 
         result_value.reset();
-        global.call_hook(&Abstract_Hooks::on_return, ptcg->sloc(), ptcg->ptc_aware());
+        global.call_hook(&Abstract_Hooks::on_return, frame.sloc, frame.ptc);
 
         // Evaluate deferred expressions.
-        defer_ctx.stack() = move(ptcg->mut_stack());
-        defer_ctx.mut_defer() = move(ptcg->mut_defer());
+        defer_ctx.mut_defer() = move(frame.defer);
         defer_ctx.on_scope_exit_normal();
       }
     }
     catch(Runtime_Error& except) {
-      // This is the exceptional path.
+      // This is the exceptional path. Arguments of the call that has thrown
+      // the exception can be reused as well.
+      global.release_ptc_arguments(move(ptcg));
+
       while(!frames.empty()) {
-        ptcg = move(frames.mut_back());
+        auto frame = move(frames.mut_back());
         frames.pop_back();
 
         // Note that if we arrive here, there must have been an exception thrown
         // when unpacking the last frame (i.e. the last call did not return), so
         // the last frame does not have its enclosing function set.
-        except.push_frame_plain(ptcg->sloc(), &"[proper tail call]");
+        except.push_frame_plain(frame.sloc, &"[proper tail call]");
 
-        if(auto caller = ptcg->caller_opt())
-          except.push_frame_function(caller->sloc(), caller->func());
+        if(frame.caller_opt)
+          except.push_frame_function(frame.caller_opt->sloc(), frame.caller_opt->func());
 
         // Evaluate deferred expressions.
-        defer_ctx.stack() = move(ptcg->mut_stack());
-        defer_ctx.mut_defer() = move(ptcg->mut_defer());
+        defer_ctx.mut_defer() = move(frame.defer);
         defer_ctx.on_scope_exit_exceptional(except);
       }
 
@@ -146,6 +146,7 @@ execute(Reference_Stack&& stack)
     this->m_global.set_recursion_base(&self);
     auto func = this->m_func;
     func.invoke(self, this->m_global, move(stack));
+    this->m_global.finalize_generators();
     ::fflush(nullptr);
     return self;
   }
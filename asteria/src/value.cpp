@@ -51,6 +51,39 @@ template class optional<Value>;
 template class cow_vector<Value>;
 template class cow_hashmap<phcow_string, Value, phcow_string::hash>;
 
+#ifdef ASTERIA_COMPACT_VALUE
+void
+details_value::Compact_Storage::
+do_unshare_box()
+  {
+    // Payloads are copy-on-write, so this copies a few pointers at most.
+    auto box = new Compact_Box{ this->do_get_box()->stor };
+    this->do_reset_word(reinterpret_cast<uintptr_t>(box) | box->stor.index());
+  }
+
+void
+details_value::Compact_Storage::
+do_set_integer_slow(V_integer other)
+  {
+    // This integer doesn't fit in the word, so it has to be boxed.
+    if(this->is_boxed() && (this->index() == type_integer) && this->is_box_unique())
+      this->do_get_box()->stor.mut<V_integer>() = other;
+    else
+      this->do_emplace_boxed<V_integer>(other);
+  }
+
+void
+details_value::Compact_Storage::
+do_delete_box(uint64_t word)
+  noexcept
+  {
+    ASTERIA_ASSERT(do_is_boxed_word(word));
+    auto box = reinterpret_cast<Compact_Box*>(static_cast<uintptr_t>(word & cell_mask));
+    if(box->nref.decrement() == 0)
+      delete box;
+  }
+#endif
+
 ASTERIA_FLATTEN
 void
 Value::
@@ -74,6 +107,35 @@ do_destroy_variant_slow()
     cow_vector<bytes_type> stack;
 
   r:
+#ifdef ASTERIA_COMPACT_VALUE
+    if(this->m_stor.is_boxed() && !this->m_stor.is_box_unique())
+      this->m_stor.free_box();
+    else if(this->m_stor.is_boxed()) {
+      // Elements of arrays and objects are moved out before the box is freed.
+      auto& stor = this->m_stor.mut_boxed();
+      if(stor.index() == type_array) {
+        auto& altr = stor.mut<type_array>();
+        if(!altr.empty() && altr.unique()) {
+          for(auto it = altr.mut_begin();  it != altr.end();  ++it) {
+            // Move raw bytes into `stack`.
+            stack.push_back(it->m_bytes);
+            bfill(it->m_bytes, 0);
+          }
+        }
+      }
+      else if(stor.index() == type_object) {
+        auto& altr = stor.mut<type_object>();
+        if(!altr.empty() && altr.unique()) {
+          for(auto it = altr.mut_begin();  it != altr.end();  ++it) {
+            // Move raw bytes into `stack`.
+            stack.push_back(it->second.m_bytes);
+            bfill(it->second.m_bytes, 0);
+          }
+        }
+      }
+      this->m_stor.free_box();
+    }
+#else
     if(this->m_stor.index() >= type_string)
       switch(this->m_stor.index())
         {
@@ -120,6 +182,7 @@ do_destroy_variant_slow()
         default:
           ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
       }
+#endif
 
     if(!stack.empty()) {
       this->m_bytes = stack.back();
@@ -18,7 +18,13 @@ class Value
     using my_Valuable = details_value::Valuable<
             typename remove_cvref<xValue>::type>;
 
+#ifdef ASTERIA_COMPACT_VALUE
+    using variant_type = details_value::Compact_Storage;
+    template<typename xScalar> using scalar_ref = details_value::Scalar_Ref<xScalar>;
+#else
     using variant_type = variant<ASTERIA_TYPES_AIXE9XIG_(V)>;
+    template<typename xScalar> using scalar_ref = xScalar&;
+#endif
     using bytes_type = storage_for<variant_type>;
 
     union {
@@ -114,7 +120,11 @@ class Value
   public:
     ~Value()
       {
+#ifdef ASTERIA_COMPACT_VALUE
+        if(ASTERIA_UNEXPECT(this->m_stor.is_boxed()))
+#else
         if(ASTERIA_UNEXPECT(this->m_stor.index() > type_real))
+#endif
           this->do_destroy_variant_slow();
       }
 
@@ -149,7 +159,7 @@ class Value
         this->do_throw_type_mismatch("`boolean`");
       }
 
-    V_boolean&
+    scalar_ref<V_boolean>
     open_boolean()
       noexcept
       {
@@ -174,7 +184,7 @@ class Value
         this->do_throw_type_mismatch("`integer`");
       }
 
-    V_integer&
+    scalar_ref<V_integer>
     open_integer()
       noexcept
       {
@@ -202,7 +212,7 @@ class Value
         this->do_throw_type_mismatch("`integer` or `real`");
       }
 
-    V_real&
+    scalar_ref<V_real>
     open_real()
       noexcept
       {
@@ -210,7 +220,7 @@ class Value
           return this->m_stor.mut<V_real>();
 
         if(ASTERIA_EXPECT(this->m_stor.index() == type_integer))
-          return this->m_stor.emplace<V_real>(static_cast<V_real>(this->m_stor.mut<V_integer>()));
+          return this->m_stor.emplace<V_real>(static_cast<V_real>(this->m_stor.as<V_integer>()));
 
         return this->m_stor.emplace<V_real>();
       }
@@ -232,7 +242,7 @@ class Value
 
     V_string&
     open_string()
-      noexcept
+      noexcept(details_value::is_nothrow_boxing)
       {
         if(ASTERIA_EXPECT(this->m_stor.index() == type_string))
           return this->m_stor.mut<V_string>();
@@ -257,7 +267,7 @@ class Value
 
     V_function&
     open_function()
-      noexcept
+      noexcept(details_value::is_nothrow_boxing)
       {
         if(ASTERIA_EXPECT(this->m_stor.index() == type_function))
           return this->m_stor.mut<V_function>();
@@ -282,7 +292,7 @@ class Value
 
     V_opaque&
     open_opaque()
-      noexcept
+      noexcept(details_value::is_nothrow_boxing)
       {
         if(ASTERIA_EXPECT(this->m_stor.index() == type_opaque))
           return this->m_stor.mut<V_opaque>();
@@ -307,7 +317,7 @@ class Value
 
     V_array&
     open_array()
-      noexcept
+      noexcept(details_value::is_nothrow_boxing)
       {
         if(ASTERIA_EXPECT(this->m_stor.index() == type_array))
           return this->m_stor.mut<V_array>();
@@ -332,7 +342,7 @@ class Value
 
     V_object&
     open_object()
-      noexcept
+      noexcept(details_value::is_nothrow_boxing)
       {
         if(ASTERIA_EXPECT(this->m_stor.index() == type_object))
           return this->m_stor.mut<V_object>();
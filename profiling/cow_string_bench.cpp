@@ -0,0 +1,94 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "../asteria/rocket/cow_string.hpp"
+#include "../asteria/rocket/cow_vector.hpp"
+#include <chrono>
+#include <stdio.h>
+using namespace ::asteria;
+
+namespace {
+
+// These are typical identifiers and field values, and some longer strings.
+const char* const s_words[] =
+  {
+    "x", "i", "std", "value", "length", "result", "timestamp", "user_id",
+    "content-type", "application/json", "Hello, world!",
+    "an identifier that does not fit in small strings",
+  };
+
+constexpr size_t s_nwords = sizeof(s_words) / sizeof(s_words[0]);
+constexpr size_t s_nrounds = 200000;
+
+template<typename xFunc>
+void
+do_run(const char* name, xFunc&& func)
+  {
+    auto t0 = ::std::chrono::steady_clock::now();
+    size_t sum = func();
+    auto t1 = ::std::chrono::steady_clock::now();
+
+    double ns = ::std::chrono::duration<double, ::std::nano>(t1 - t0).count();
+    ::printf("%-24s %8.2f ns/op  (%zu)\n", name, ns / (s_nrounds * s_nwords), sum);
+  }
+
+}  // namespace
+
+int main()
+  {
+    cow_vector<cow_string> words;
+    for(size_t k = 0;  k < s_nwords;  ++k)
+      words.emplace_back(s_words[k]);
+
+    do_run("construct",
+      [&] {
+        size_t sum = 0;
+        for(size_t r = 0;  r < s_nrounds;  ++r)
+          for(size_t k = 0;  k < s_nwords;  ++k) {
+            cow_string str(s_words[k]);
+            sum += str.size();
+          }
+        return sum;
+      });
+
+    do_run("copy",
+      [&] {
+        size_t sum = 0;
+        for(size_t r = 0;  r < s_nrounds;  ++r)
+          for(size_t k = 0;  k < s_nwords;  ++k) {
+            cow_string str = words[k];
+            sum += str.size();
+          }
+        return sum;
+      });
+
+    do_run("append",
+      [&] {
+        size_t sum = 0;
+        for(size_t r = 0;  r < s_nrounds;  ++r)
+          for(size_t k = 0;  k < s_nwords;  ++k) {
+            cow_string str = words[k];
+            str.push_back('.');
+            sum += str.size();
+          }
+        return sum;
+      });
+
+    do_run("compare",
+      [&] {
+        size_t sum = 0;
+        for(size_t r = 0;  r < s_nrounds;  ++r)
+          for(size_t k = 0;  k < s_nwords;  ++k)
+            sum += words[k] == words[(k + r) % s_nwords];
+        return sum;
+      });
+
+    do_run("hash",
+      [&] {
+        size_t sum = 0;
+        for(size_t r = 0;  r < s_nrounds;  ++r)
+          for(size_t k = 0;  k < s_nwords;  ++k)
+            sum += cow_string::hasher()(words[k]);
+        return sum;
+      });
+  }
@@ -0,0 +1,8 @@
+#!/bin/bash -e
+
+rm -rf cow_string_bench
+
+${CXX:-g++} -std=c++17 -O2 -DNDEBUG cow_string_bench.cpp  \
+  -o cow_string_bench -L../build_release -lasteria
+
+LD_LIBRARY_PATH=../build_release ./cow_string_bench
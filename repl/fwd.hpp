@@ -57,11 +57,15 @@ exit_printf(Exit_Status stat, const char* fmt, ...) noexcept;
 void
 install_verbose_hooks();
 
-// This function is defined in 'single.cpp'.
+// These functions are defined in 'single.cpp'.
 [[noreturn]]
 void
 load_and_execute_single_noreturn();
 
+[[noreturn]]
+void
+load_and_count_node_pairs_noreturn();
+
 // These functions are defined in 'commands.cpp'.
 void
 prepare_repl_commands();
@@ -35,8 +35,15 @@ struct Verbose_Hooks
         repl_printf("* %s", this->m_fmt.c_str());
       }
 
+    uint32_t
+    get_hook_mask()
+      const noexcept override
+      {
+        return hook_mask_interrupt | hook_mask_call | hook_mask_return | hook_mask_throw;
+      }
+
     void
-    on_trap(const Source_Location& sloc, Executive_Context& /*ctx*/) override
+    on_interrupt(Executive_Context& /*ctx*/) override
       {
         int sig = repl_signal.xchg(0);
         if(is_any_of(sig, { 0, SIGURG, SIGCHLD, SIGWINCH, SIGCONT }))
@@ -44,7 +51,8 @@ struct Verbose_Hooks
 
         char sigdesc[128];
         ::snprintf(sigdesc, sizeof(sigdesc), "signal %d (%s)", sig, ::strsignal(sig));
-        this->do_trace(sloc, "received $1", sigdesc);
+        if(repl_verbose)
+          repl_printf("* received %s", sigdesc);
         sprintf_and_throw<::std::runtime_error>("Received %s", sigdesc);
       }
 
@@ -131,7 +139,7 @@ void
 install_verbose_hooks()
   {
     repl_script.mut_global().set_hooks(make_refcnt<Verbose_Hooks>());
-    repl_script.mut_options().verbose_single_step_traps = true;
+    repl_script.mut_options().inline_functions = false;
   }
 
 }  // namespace asteria
@@ -28,6 +28,7 @@ Usage: %s [OPTIONS] [[--] FILE [ARGUMENTS]...]
   -I      suppress interactive mode [default = auto]
   -i      force interactive mode [default = auto]
   -O[n]   set optimization level to `n` [default = 1]
+  -P      count pairs of adjacent IR nodes in FILE then exit
   -V      show version information then exit
   -v      enable verbose mode
 
@@ -50,6 +51,10 @@ In verbose mode, execution details are printed to standard error. It also
 prevents quick termination, which enables some tools such as valgrind to
 discover memory leaks upon exit.
 
+With `-P`, FILE is compiled but not executed. Each pair of adjacent IR
+nodes is printed with the number of times it appears, the most frequent
+first. This helps find sequences of nodes that are worth fusing.
+
 Visit the homepage at <%s>.
 Report bugs to <%s>.
 )'''''''''''''''" """"""""""""""""""""""""""""""""""""""""""""""""""""""""+1,
@@ -89,6 +94,7 @@ do_parse_command_line(int argc, char** argv)
   {
     bool help = false;
     bool version = false;
+    bool pairs = false;
 
     opt<bool> verbose, interactive;
     opt<int> optimize;
@@ -107,7 +113,7 @@ do_parse_command_line(int argc, char** argv)
 
     // Parse command-line options.
     int ch;
-    while((ch = ::getopt(argc, argv, "+hIiO::Vv")) != -1) {
+    while((ch = ::getopt(argc, argv, "+hIiO::PVv")) != -1) {
       switch(ch)
         {
         case 'h':
@@ -130,6 +136,10 @@ do_parse_command_line(int argc, char** argv)
           optimize = optarg[0] - '0';
           continue;
 
+        case 'P':
+          pairs = true;
+          continue;
+
         case 'V':
           version = true;
           continue;
@@ -179,6 +189,10 @@ do_parse_command_line(int argc, char** argv)
     // These arguments are always overwritten.
     repl_file = path.move_value_or(&"-");
     repl_args = move(args);
+
+    // Count pairs of nodes instead of executing the script.
+    if(pairs)
+      load_and_count_node_pairs_noreturn();
   }
 
 }  // namespace
@@ -201,7 +215,10 @@ main(int argc, char** argv)
       install_verbose_hooks();
 
       struct sigaction sigact = { };
-      sigact.sa_handler = +[](int sig) { repl_signal.store(sig);  };
+      sigact.sa_handler = +[](int sig) {
+          repl_signal.store(sig);
+          repl_script.mut_global().request_interrupt();
+        };
       ::sigaction(SIGINT, &sigact, nullptr);
       ::sigaction(SIGWINCH, &sigact, nullptr);
       ::sigaction(SIGCONT, &sigact, nullptr);
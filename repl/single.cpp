@@ -5,6 +5,12 @@
 #include "fwd.hpp"
 #include "../asteria/simple_script.hpp"
 #include "../asteria/value.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/compiler/statement_sequence.hpp"
+#include "../asteria/runtime/air_optimizer.hpp"
+#include "../asteria/rocket/tinyfmt_file.hpp"
+#include "../asteria/utils.hpp"
+#include <algorithm>  // sort()
 namespace asteria {
 
 void
@@ -37,4 +43,52 @@ load_and_execute_single_noreturn()
     quick_exit(status);
   }
 
+void
+load_and_count_node_pairs_noreturn()
+  {
+    // Load and parse the script, but do not execute it.
+    cow_dictionary<uint64_t> counts;
+    try {
+      tinyfmt_file cbuf;
+      cow_string name;
+      if(repl_file == "-") {
+        cbuf.reset(stdin);
+        name = &"[stdin]";
+      }
+      else {
+        name = get_real_path(repl_file);
+        cbuf.open(name.c_str(), tinyfmt::open_read);
+      }
+
+      const auto& opts = repl_script.options();
+      Token_Stream tstrm(opts);
+      tstrm.reload(name, 1, move(cbuf));
+      Statement_Sequence stmtq(opts);
+      stmtq.reload(move(tstrm));
+
+      AIR_Optimizer optmz(opts);
+      cow_vector<phcow_string> script_params;
+      script_params.emplace_back(&"...");
+      optmz.reload(nullptr, script_params, repl_script.global(), stmtq.get_statements());
+      optmz.count_node_pairs(counts);
+    }
+    catch(exception& stdex) {
+      // Print the error and exit.
+      exit_printf(exit_compiler_error, "! exception: %s", stdex.what());
+    }
+
+    // Print pairs of nodes, the most frequent first.
+    cow_bivector<uint64_t, phcow_string> sorted;
+    for(auto it = counts.begin();  it != counts.end();  ++it)
+      sorted.emplace_back(it->second, it->first);
+
+    ::std::sort(sorted.mut_begin(), sorted.mut_end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first;  });
+
+    for(const auto& r : sorted)
+      ::printf("%10llu  %s\n", static_cast<unsigned long long>(r.first), r.second.c_str());
+
+    quick_exit(exit_success);
+  }
+
 }  // namespace asteria
@@ -0,0 +1,112 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "air_utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Compiler_Options opts = { };
+    opts.optimization_level = 1;
+
+    // constant folding
+    auto code = asteria_test_compile(opts, "return 1 + 2 * 3 - (4 <=> 5);");
+    ASTERIA_TEST_CHECK(code.size() == 2);  // clear, return 8
+    ASTERIA_TEST_CHECK(code.at(1).index() == AIR_Node::index_return_statement_bi32);
+    ASTERIA_TEST_CHECK(code.at(1).as<AIR_Node::S_return_statement_bi32>().irhs == 8);
+
+    opts.optimization_level = 0;
+    code = asteria_test_compile(opts, "return 1 + 2 * 3 - (4 <=> 5);");
+    ASTERIA_TEST_CHECK(code.size() > 2);
+
+    // errors are deferred to run time
+    opts.optimization_level = 1;
+    code = asteria_test_compile(opts, "return 1 / 0;");
+    ASTERIA_TEST_CHECK(code.size() == 4);  // clear, 1, `/ 0`, return
+
+    // dead branches and unreachable code
+    code = asteria_test_compile(opts, "if(1 < 2) return 42; else return 43; return 44;");
+    ASTERIA_TEST_CHECK(code.size() == 4);  // clear, true, clear, return 42
+    ASTERIA_TEST_CHECK(code.at(3).index() == AIR_Node::index_return_statement_bi32);
+    ASTERIA_TEST_CHECK(code.at(3).is_terminator());
+
+    code = asteria_test_compile(opts, "if(1 < 2) { var a = 42; return a; } return 44;");
+    ASTERIA_TEST_CHECK(code.size() == 3);  // clear, true, block
+    ASTERIA_TEST_CHECK(code.at(2).index() == AIR_Node::index_execute_block);
+    ASTERIA_TEST_CHECK(code.at(2).is_terminator());
+
+    code = asteria_test_compile(opts, "return false ? 1 : \"meow\";");
+    ASTERIA_TEST_CHECK(code.size() == 3);  // clear, "meow", return
+
+    // dead stores
+    code = asteria_test_compile(opts, "var a = 1;  var b;  return 2;");
+    ASTERIA_TEST_CHECK(code.size() == 7);  // clear, declare, 1, initialize, b, clear, return
+
+    opts.optimization_level = 2;
+    code = asteria_test_compile(opts, "var a = 1;  var b;  return 2;");
+    ASTERIA_TEST_CHECK(code.size() == 5);  // clear, 1, check, clear, return
+
+    code = asteria_test_compile(opts, "var a = 1;  var b;  return func() { return a; };");
+    ASTERIA_TEST_CHECK(code.size() == 7);  // clear, declare, 1, initialize, clear, closure, return
+
+    // literals of constants
+    opts.optimization_level = 1;
+    code = asteria_test_compile(opts, "return [ 1, [ 2, 3 ], { x: 4 } ];");
+    ASTERIA_TEST_CHECK(code.size() == 3);  // clear, [1,[2,3],{x:4}], return
+    ASTERIA_TEST_CHECK(code.at(1).index() == AIR_Node::index_push_constant);
+
+    // compound assignment
+    code = asteria_test_compile(opts, "var a = 1;  a = a + 2;");
+    ASTERIA_TEST_CHECK(code.size() == 8);  // clear, declare, 1, initialize, clear, a, `+= 2`, return
+    ASTERIA_TEST_CHECK(code.at(6).index() == AIR_Node::index_apply_operator_bi32);
+    ASTERIA_TEST_CHECK(code.at(6).as<AIR_Node::S_apply_operator_bi32>().assign);
+
+    // semantics
+    Simple_Script script;
+    for(uint8_t level = 0;  level <= 2;  ++level) {
+      script.mut_options().optimization_level = level;
+      script.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          var count = 0;
+          func bump() { return ++count;  }
+
+          var unused = bump();
+          assert count == 1;
+          const dropped = bump() + 1;
+          assert count == 2;
+
+          assert (1 + 2) * 3 == 9;
+          assert "a" + "b" == "ab";
+          assert (true ? 1 : 2) == 1;
+          assert (null ?? 5) == 5;
+          assert (3 ?? bump()) == 3;
+          assert count == 2;
+
+          if(false)
+            assert false;
+          else
+            bump();
+          assert count == 3;
+
+          try {
+            var x = 1 / 0;
+            assert false;
+          }
+          catch(e)
+            assert countof e != 0;
+
+          try {
+            var y = (func() { })();
+            assert false;
+          }
+          catch(e)
+            assert countof e != 0;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      script.execute();
+    }
+  }
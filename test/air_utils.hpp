@@ -0,0 +1,48 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_TEST_AIR_UTILS_
+#define ASTERIA_TEST_AIR_UTILS_
+
+#include "utils.hpp"
+#include "../asteria/rocket/tinyfmt_str.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/compiler/statement_sequence.hpp"
+#include "../asteria/runtime/air_optimizer.hpp"
+#include "../asteria/runtime/air_node.hpp"
+#include "../asteria/runtime/global_context.hpp"
+
+// Compile a script into AIR nodes without executing it. If `instantiate` is
+// set, a function is created from the code, after which nodes have been fused.
+inline
+::asteria::cow_vector<::asteria::AIR_Node>
+asteria_test_compile(const ::asteria::Compiler_Options& opts, const char* source,
+                     bool instantiate = false)
+  {
+    ::asteria::Token_Stream tstrm(opts);
+    ::asteria::tinyfmt_str cbuf(source, ::asteria::tinyfmt::open_read);
+    tstrm.reload(&"[test]", 1, ::std::move(cbuf));
+    ::asteria::Statement_Sequence sseq(opts);
+    sseq.reload(::std::move(tstrm));
+
+    ::asteria::Global_Context global;
+    ::asteria::AIR_Optimizer optmz(opts);
+    optmz.reload(nullptr, { }, global, sseq.get_statements());
+    if(instantiate)
+      optmz.create_prototype(::asteria::Source_Location(&"[test]", 1, 1), &"[test]");
+    return optmz.get_code();
+  }
+
+// Count nodes of a kind, excluding nested ones.
+inline
+size_t
+asteria_test_count(const ::asteria::cow_vector<::asteria::AIR_Node>& code,
+                   ::asteria::AIR_Node::Index index)
+  {
+    size_t n = 0;
+    for(size_t k = 0;  k < code.size();  ++k)
+      n += code.at(k).index() == index;
+    return n;
+  }
+
+#endif
@@ -0,0 +1,94 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "air_utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+namespace {
+
+size_t
+do_count_global_references(const char* source, bool bind = true, uint8_t level = 2)
+  {
+    Compiler_Options opts = { };
+    opts.optimization_level = level;
+    opts.bind_library_members = bind;
+    return asteria_test_count(asteria_test_compile(opts, source),
+                              AIR_Node::index_push_global_reference);
+  }
+
+size_t
+do_count_member_accesses(const char* source)
+  {
+    Compiler_Options opts = { };
+    opts.optimization_level = 2;
+    return asteria_test_count(asteria_test_compile(opts, source),
+                              AIR_Node::index_member_access);
+  }
+
+}  // namespace
+
+int main()
+  {
+    // calls and values
+    ASTERIA_TEST_CHECK(do_count_global_references("std.io.putf(\"$1\", 1);") == 0);
+    ASTERIA_TEST_CHECK(do_count_global_references("std.io.putf(\"$1\", 1);", false) == 1);
+    ASTERIA_TEST_CHECK(do_count_global_references("std.io.putf(\"$1\", 1);", true, 1) == 1);
+    ASTERIA_TEST_CHECK(do_count_global_references("var x = std.math.pi * 2;") == 0);
+    ASTERIA_TEST_CHECK(do_count_global_references("var x = [ std.math.e ];") == 0);
+    ASTERIA_TEST_CHECK(do_count_global_references("var x = std.string;") == 0);
+
+    // functions, which are called with their parent objects as `this`
+    ASTERIA_TEST_CHECK(do_count_member_accesses("std.string.find(\"hello\", \"l\");") == 1);
+    ASTERIA_TEST_CHECK(do_count_member_accesses("var x = std.math.pi;") == 0);
+
+    // writes to `std`, which fail at runtime
+    ASTERIA_TEST_CHECK(do_count_global_references(
+                   "std.io.putf(\"$1\", 1);  std.math.pi = 3;") == 0);
+    ASTERIA_TEST_CHECK(do_count_global_references(
+                   "std.io.putf(\"$1\", 1);  func f(x) { x = 1; }  f(ref std.math);") == 0);
+    ASTERIA_TEST_CHECK(do_count_global_references(
+                   "std.io.putf(\"$1\", 1);  ref r -> std;") == 1);
+
+    // `std` itself and nonexistent members
+    ASTERIA_TEST_CHECK(do_count_global_references("var x = std;") == 1);
+    ASTERIA_TEST_CHECK(do_count_global_references("var x = std.nonexistent;") == 1);
+
+    Simple_Script code;
+    code.mut_options().optimization_level = 2;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        assert std.string.find("hello", "l") == 2;
+        assert std.math.pi * 2 > 6;
+        assert std.string.nonexistent == null;
+        assert typeof std == "object";
+
+        func f(s) {
+          return std.string.to_upper(s);
+        }
+        assert f("abc") == "ABC";
+
+        var g = func() { return std.array.sort([3,1,2]); };
+        assert g() == [1,2,3];
+
+        try {
+          std.math.pi = 3;
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "not modifiable") != null;
+
+        func h(x) { x = 1; }
+        try {
+          h(ref std.math);
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "not modifiable") != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
@@ -0,0 +1,106 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        // Each closure captures its own iteration variable.
+        var fns = [];
+        for(var i = 0;  i < 5;  ++i) {
+          var k = i * 10;
+          fns[$] = func() { return [ i, k, k ];  };
+        }
+        for(var i = 0;  i < 5;  ++i)
+          assert fns[i]() == [ 5, i * 10, i * 10 ];
+
+        // Captures are references, not copies.
+        var counter = 0;
+        func inc(n) { counter += n;  return counter;  }
+        assert inc(2) == 2;
+        assert inc(3) == 5;
+        assert counter == 5;
+
+        // Names in nested scopes of the closure are not captured.
+        var x = "outer";
+        var f = func(a) {
+          var r = [];
+          for(each v -> [ 1, 2 ]) {
+            var x = v;
+            r[$] = func() { return [ a, x ];  };
+          }
+          if(a > 0) {
+            var y = x;
+            r[$] = func() { return y;  };
+          }
+          try {
+            throw a;
+          }
+          catch(e)
+            r[$] = func() { return e + a;  };
+          return r;
+        };
+        var r = f(7);
+        assert r[0]() == [ 7, 1 ];
+        assert r[1]() == [ 7, 2 ];
+        assert r[2]() == "outer";
+        assert r[3]() == 14;
+
+        // Nested closures capture through enclosing ones.
+        var base = 100;
+        func make_adder(n) {
+          return func(m) {
+            return func() { return base + n + m;  };
+          };
+        }
+        var g1 = make_adder(1);
+        var g2 = make_adder(2);
+        assert g1(10)() == 111;
+        assert g2(20)() == 122;
+        base = 200;
+        assert g1(10)() == 211;
+
+        // Deferred expressions see captures, even after proper tail calls.
+        var log = [];
+        var tag = "d";
+        func deferred(n) {
+          defer log[$] = [ tag, n ];
+          if(n == 0)
+            return 0;
+          return deferred(n - 1);
+        }
+        deferred(2);
+        assert log == [ [ "d", 0 ], [ "d", 1 ], [ "d", 2 ] ];
+
+        // Recursion through a captured name.
+        func fib(n) { return n <= 1 ? n : fib(n - 1) + fib(n - 2);  }
+        assert fib(15) == 610;
+
+        // A closure referring to a bypassed declaration cannot be created.
+        func disp(s) {
+          switch(s) {
+          case 1:
+            var late = "meow";
+          case 2:
+            return func() { return late;  };
+          }
+        }
+        assert disp(1)() == "meow";
+        try {
+          disp(2);
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "bypassed") != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
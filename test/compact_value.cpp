@@ -0,0 +1,120 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/value.hpp"
+#include "../asteria/simple_script.hpp"
+#include <cmath>
+#include <cfloat>
+using namespace ::asteria;
+
+int main()
+  {
+#ifdef ASTERIA_COMPACT_VALUE
+    ASTERIA_TEST_CHECK(sizeof(Value) == 8);
+#endif
+
+    // Integers around the limit of 50 bits, which are stored in different
+    // ways in the compact layout.
+    static constexpr V_integer integers[] =
+      {
+        0, 1, -1, 0x1'FFFF'FFFF'FFFF, 0x2'0000'0000'0000, -0x2'0000'0000'0000,
+        -0x2'0000'0000'0001, INT64_MAX, INT64_MIN,
+      };
+
+    for(V_integer ival : integers) {
+      Value value = ival;
+      ASTERIA_TEST_CHECK(value.is_integer());
+      ASTERIA_TEST_CHECK(value.as_integer() == ival);
+
+      Value copy = value;
+      ASTERIA_TEST_CHECK(copy.as_integer() == ival);
+      copy.open_integer() = 42;
+      ASTERIA_TEST_CHECK(copy.as_integer() == 42);
+      ASTERIA_TEST_CHECK(value.as_integer() == ival);
+
+      value.open_integer() ^= 1;
+      ASTERIA_TEST_CHECK(value.as_integer() == (ival ^ 1));
+      ASTERIA_TEST_CHECK(value.as_real() == static_cast<V_real>(value.as_integer()));
+    }
+
+    // Reals of all kinds are preserved, except NaN payloads.
+    static constexpr V_real reals[] =
+      {
+        0.0, -0.0, 1.5, -1.5, HUGE_VAL, -HUGE_VAL, DBL_MIN, DBL_MAX, DBL_TRUE_MIN,
+      };
+
+    for(V_real rval : reals) {
+      Value value = rval;
+      ASTERIA_TEST_CHECK(value.is_real());
+      ASTERIA_TEST_CHECK(value.as_real() == rval);
+      ASTERIA_TEST_CHECK(::std::signbit(value.as_real()) == ::std::signbit(rval));
+    }
+
+    Value value = ::std::nan("42");
+    ASTERIA_TEST_CHECK(value.is_real());
+    ASTERIA_TEST_CHECK(::std::isnan(value.as_real()));
+    value = -::std::nan("");
+    ASTERIA_TEST_CHECK(value.is_real());
+    ASTERIA_TEST_CHECK(::std::isnan(value.as_real()));
+    ASTERIA_TEST_CHECK(::std::signbit(value.as_real()));
+
+    value = V_integer(7);
+    value.open_real() *= 0.5;
+    ASTERIA_TEST_CHECK(value.is_real());
+    ASTERIA_TEST_CHECK(value.as_real() == 3.5);
+
+    value = true;
+    ASTERIA_TEST_CHECK(value.is_boolean());
+    ASTERIA_TEST_CHECK(value.as_boolean() == true);
+    value.open_boolean() = false;
+    ASTERIA_TEST_CHECK(value.as_boolean() == false);
+
+    // Boxes may be shared by copies, but are not modified through them.
+    value = V_string(&"hello");
+    Value copy = value;
+    copy.open_string() += " world";
+    ASTERIA_TEST_CHECK(value.as_string() == "hello");
+    ASTERIA_TEST_CHECK(copy.as_string() == "hello world");
+    copy = value;
+    ASTERIA_TEST_CHECK(copy.as_string() == "hello");
+    copy = V_string(&"world");
+    ASTERIA_TEST_CHECK(value.as_string() == "hello");
+
+    value = V_array(2, V_integer(1));
+    copy = value;
+    copy.open_array().emplace_back(V_integer(2));
+    ASTERIA_TEST_CHECK(value.as_array().size() == 2);
+    ASTERIA_TEST_CHECK(copy.as_array().size() == 3);
+
+    value = V_integer(INT64_MAX);
+    copy = value;
+    copy.open_integer() -= 1;
+    ASTERIA_TEST_CHECK(value.as_integer() == INT64_MAX);
+    ASTERIA_TEST_CHECK(copy.as_integer() == INT64_MAX - 1);
+
+    // Deeply nested values are destroyed without recursion.
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var a = [ ];
+        for(var i = 0;  i < 100000;  ++i)
+          a = [ a, { k: a ? 1 : 0x7FFFFFFFFFFFFFFF } ];
+        a = null;
+
+        var n = 0x1FFFFFFFFFFFF;
+        n += 1;
+        assert n == 0x2000000000000;
+        n -= 1;
+        assert n == 0x1FFFFFFFFFFFF;
+        assert n * 4 == 0x7FFFFFFFFFFFC;
+        assert -n - 3 == -0x2000000000002;
+        assert typeof (n / 0.0) == "real";
+        assert std.numeric.is_nan(n * 0.0 / 0.0);
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
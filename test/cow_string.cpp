@@ -0,0 +1,97 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/rocket/cow_string.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // Short strings need no dynamic storage.
+    cow_string str;
+    str.append("hello", 5);
+    ASTERIA_TEST_CHECK(str == "hello");
+    ASTERIA_TEST_CHECK(str.size() == 5);
+    ASTERIA_TEST_CHECK(str.c_str()[5] == 0);
+    ASTERIA_TEST_CHECK(str.unique());
+    ASTERIA_TEST_CHECK(str.capacity() >= 5);
+
+    // Copies are independent.
+    cow_string copy = str;
+    ASTERIA_TEST_CHECK(copy == "hello");
+    ASTERIA_TEST_CHECK(copy.data() != str.data());
+    copy.mut(0) = 'j';
+    ASTERIA_TEST_CHECK(copy == "jello");
+    ASTERIA_TEST_CHECK(str == "hello");
+
+    // Moves leave empty strings behind.
+    cow_string moved = move(copy);
+    ASTERIA_TEST_CHECK(moved == "jello");
+    ASTERIA_TEST_CHECK(copy.empty());
+    copy = move(moved);
+    ASTERIA_TEST_CHECK(copy == "jello");
+    ASTERIA_TEST_CHECK(moved.empty());
+    copy.swap(str);
+    ASTERIA_TEST_CHECK(copy == "hello");
+    ASTERIA_TEST_CHECK(str == "jello");
+
+    // Self-move leaves inline strings intact.
+    cow_string self = &"hello world!!";
+    self.mut(0) = 'j';
+    auto& alias = self;
+    self = move(alias);
+    ASTERIA_TEST_CHECK(self.size() == 13);
+    ASTERIA_TEST_CHECK(self == "jello world!!");
+
+    // Strings grow across the inline limit, and shrink back.
+    str.clear();
+    for(size_t k = 0;  k < 100;  ++k) {
+      str.push_back(static_cast<char>('a' + k % 26));
+      ASTERIA_TEST_CHECK(str.size() == k + 1);
+      ASTERIA_TEST_CHECK(str.c_str()[k + 1] == 0);
+      ASTERIA_TEST_CHECK(str.back() == static_cast<char>('a' + k % 26));
+    }
+    ASTERIA_TEST_CHECK(str.substr(0, 3) == "abc");
+    ASTERIA_TEST_CHECK(str.substr(98) == "uv");
+    ASTERIA_TEST_CHECK(str.substr(50).size() == 50);
+
+    copy = str;
+    ASTERIA_TEST_CHECK(copy.data() == str.data());
+    ASTERIA_TEST_CHECK(str.use_count() == 2);
+    copy.pop_back(95);
+    ASTERIA_TEST_CHECK(copy == "abcde");
+    ASTERIA_TEST_CHECK(str.size() == 100);
+    copy.append(copy);
+    ASTERIA_TEST_CHECK(copy == "abcdeabcde");
+    copy.insert(5, copy.data(), 5);
+    ASTERIA_TEST_CHECK(copy == "abcdeabcdeabcde");
+    copy.insert(0, "x");
+    ASTERIA_TEST_CHECK(copy == "xabcdeabcdeabcde");
+    copy.erase(1, 10);
+    ASTERIA_TEST_CHECK(copy == "xabcde");
+    copy.reserve(1000);
+    ASTERIA_TEST_CHECK(copy.capacity() >= 1000);
+    ASTERIA_TEST_CHECK(copy == "xabcde");
+    copy.shrink_to_fit();
+    ASTERIA_TEST_CHECK(copy == "xabcde");
+
+    // Strings that refer to external characters are copied before they are
+    // modified, even if there is storage.
+    str.assign("a long string which is not short", 32);
+    str = &"ab";
+    str.append("c", 1);
+    ASTERIA_TEST_CHECK(str == "abc");
+    str.clear();
+    ASTERIA_TEST_CHECK(str.empty());
+    str = sref("external");
+    str.mut(0) = 'E';
+    ASTERIA_TEST_CHECK(str == "External");
+
+    // Wide characters are stored inline, too.
+    cow_u32string wstr;
+    wstr.append(3, U'a');
+    ASTERIA_TEST_CHECK(wstr == U"aaa");
+    wstr.append(10, U'b');
+    ASTERIA_TEST_CHECK(wstr.size() == 13);
+    ASTERIA_TEST_CHECK(wstr.substr(3) == U"bbbbbbbbbb");
+  }
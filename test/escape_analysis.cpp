@@ -0,0 +1,121 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    for(uint8_t level = 0;  level <= 2;  ++level) {
+      code.mut_options().optimization_level = level;
+      code.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          // Locals that don't escape are not tracked.
+          var level = __varg(0);
+          func work(n) {
+            var sum = 0;
+            for(var i = 0;  i < n;  ++i) {
+              var a = [ i, i + 1 ];
+              var o = { x: a[1] };
+              var z;
+              z = o.x - a[0];
+              sum += z;
+            }
+            return sum;
+          }
+          std.gc.collect();
+          var base = std.gc.count_variables(0);
+          assert work(1000) == 1000;
+          if(level >= 2)
+            assert std.gc.count_variables(0) == base;
+
+          // Members functions receive `this` by reference.
+          func counter() {
+            var c = { n: 0, inc: func() { this.n += 1;  } };
+            c.inc();
+            c.inc();
+            return c.n;
+          }
+          assert counter() == 2;
+
+          // References that are bound, or passed or returned by reference.
+          func bind() {
+            var v = 1;
+            ref r -> v;
+            r = 2;
+            return v;
+          }
+          assert bind() == 2;
+
+          func set(x) { x = 3;  }
+          func pass() {
+            var v = 1;
+            set(->v);
+            return v;
+          }
+          assert pass() == 3;
+
+          func get() {
+            var v = 4;
+            return ref v;
+          }
+          assert get() == 4;
+
+          func iterate() {
+            var arr = [ 1, 2, 3 ];
+            for(each k, v -> arr)
+              v *= 2;
+            return arr;
+          }
+          assert iterate() == [ 2, 4, 6 ];
+
+          // Captured variables are still tracked, so cycles are collected.
+          func cycle() {
+            var self;
+            self = func() { return self;  };
+            return typeof self() == "function";
+          }
+          std.gc.collect();
+          base = std.gc.count_variables(0);
+          for(var i = 0;  i < 10;  ++i)
+            assert cycle();
+          assert std.gc.count_variables(0) > base;
+          std.gc.collect();
+          assert std.gc.count_variables(0) == base;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      code.execute({ V_integer(level) });
+
+      // Locals of a generator are referenced by the generator, so a generator
+      // that holds itself is collected.
+      code.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          var holder = [];
+          func gen() {
+            var me = holder[0];
+            yield 1;
+            yield typeof me;
+          }
+          var g = gen();
+          holder[0] = g;
+          g();
+          holder = null;
+          g = null;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      code.execute();
+      ASTERIA_TEST_CHECK(code.global().count_generators() == 1);
+      code.reload_string(&__FILE__, __LINE__, &"std.gc.collect();");
+      code.execute();
+      ASTERIA_TEST_CHECK(code.global().count_generators() == 0);
+    }
+  }
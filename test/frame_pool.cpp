@@ -0,0 +1,87 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func fib(n) {
+          var r = n;
+          if(n > 1)
+            r = fib(n - 1) + fib(n - 2);
+          return r;
+        }
+        assert fib(15) == 610;
+
+        // Storage from earlier calls must not leak into later ones.
+        func probe(x) {
+          assert __func == "probe(x)";
+          assert __varg() == 0;
+          var y;
+          assert y == null;
+          y = x;
+          return y;
+        }
+        for(var i = 0;  i < 10;  ++i)
+          assert probe(i) == i;
+
+        // Exceptions return frames as well.
+        func fail(n) {
+          if(n == 0)
+            throw "boom";
+          return fail(n - 1) + 1;
+        }
+        for(var i = 0;  i < 10;  ++i)
+          try {
+            fail(i);
+            assert false;
+          }
+          catch(e)
+            assert e == "boom";
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+
+    // All frames have been returned, and most calls have been served from the
+    // pool.
+    const auto& global = code.global();
+    size_t hits = global.get_frame_pool_hits();
+    size_t misses = global.get_frame_pool_misses();
+    ASTERIA_TEST_CHECK(global.count_pooled_frames() == misses);
+    ASTERIA_TEST_CHECK(misses <= 20);
+    ASTERIA_TEST_CHECK(hits >= 1000);
+
+    code.mut_global().clear_pooled_frames();
+    ASTERIA_TEST_CHECK(global.count_pooled_frames() == 0);
+    code.execute();
+    ASTERIA_TEST_CHECK(global.get_frame_pool_misses() > misses);
+    ASTERIA_TEST_CHECK(global.get_frame_pool_hits() >= hits + 1000);
+
+    // A deep recursion doesn't leave all its frames in the pool.
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func deep(n) {
+          var r = 0;
+          if(n > 0)
+            r = deep(n - 1) + 1;
+          return r;
+        }
+        assert deep(200) == 200;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+    ASTERIA_TEST_CHECK(global.count_pooled_frames() >= misses);
+    ASTERIA_TEST_CHECK(global.count_pooled_frames() <= 100);
+  }
@@ -0,0 +1,94 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/runtime_error.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    ASTERIA_TEST_CHECK(!code.global().is_fuel_metered());
+
+    // Each iteration of a loop consumes one unit, and so does the script itself.
+    code.reload_string(&__FILE__, __LINE__, &"for(var i = 0;  i < 100;  ++i) { }");
+    code.mut_global().set_fuel(1000);
+    ASTERIA_TEST_CHECK(code.global().is_fuel_metered());
+    code.execute();
+    ASTERIA_TEST_CHECK(code.global().get_fuel() == 899);
+
+    // So does each function call.
+    code.reload_string(&__FILE__, __LINE__, &"func f(n) { return n == 0 ? 0 : f(n - 1);  }  f(9);");
+    code.execute();
+    ASTERIA_TEST_CHECK(code.global().get_fuel() == 888);
+
+    // Running out of fuel stops infinite loops. Scripts can't catch it to
+    // continue running.
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        try
+          while(true) { }
+        catch(e)
+          assert false;
+        assert false;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+
+    for(size_t k = 0;  k < 2;  ++k)
+      try {
+        code.execute();
+        ASTERIA_TEST_CHECK(false);
+      }
+      catch(Runtime_Error& except) {
+        ASTERIA_TEST_CHECK(except.is_fuel_exhausted());
+        ASTERIA_TEST_CHECK(code.global().get_fuel() == 0);
+      }
+
+    code.reload_string(&__FILE__, __LINE__,
+                       &"var e = catch(func() { while(true) { }  } ());  assert false;");
+    code.mut_global().set_fuel(10);
+    try {
+      code.execute();
+      ASTERIA_TEST_CHECK(false);
+    }
+    catch(Runtime_Error& except) {
+      ASTERIA_TEST_CHECK(except.is_fuel_exhausted());
+    }
+
+    // Other errors are not marked.
+    code.reload_string(&__FILE__, __LINE__, &"throw 42;");
+    code.mut_global().set_fuel(10);
+    try {
+      code.execute();
+      ASTERIA_TEST_CHECK(false);
+    }
+    catch(Runtime_Error& except) {
+      ASTERIA_TEST_CHECK(!except.is_fuel_exhausted());
+    }
+
+    // Fuel can be refilled.
+    code.mut_global().set_fuel(0);
+    code.reload_string(&__FILE__, __LINE__, &"for(var i = 0;  i < 100;  ++i) { }");
+    code.mut_global().add_fuel(150);
+    code.execute();
+    ASTERIA_TEST_CHECK(code.global().get_fuel() == 49);
+    code.mut_global().add_fuel(UINT64_MAX);
+    ASTERIA_TEST_CHECK(code.global().get_fuel() == UINT64_MAX);
+
+    // Fuel is still consumed while other requests are pending.
+    code.mut_global().set_fuel(1000);
+    code.mut_global().set_time_limit(100000);
+    code.execute();
+    ASTERIA_TEST_CHECK(code.global().get_fuel() == 899);
+    code.mut_global().clear_time_limit();
+
+    code.mut_global().clear_fuel();
+    ASTERIA_TEST_CHECK(!code.global().is_fuel_metered());
+    code.reload_string(&__FILE__, __LINE__, &"for(var i = 0;  i < 100000;  ++i) { }");
+    code.execute();
+  }
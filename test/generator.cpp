@@ -0,0 +1,268 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func range(n) {
+          for(var i = 0;  i < n;  ++i)
+            yield i;
+          return "ignored";
+        }
+
+        // Each value is produced when it is requested.
+        var r = [];
+        for(each k, v -> range(4))
+          r[$] = [ k, v ];
+        assert r == [ [0,0], [1,1], [2,2], [3,3] ];
+
+        var g = range(2);
+        assert typeof g == "function";
+        assert g() == 0;
+        assert g() == 1;
+        assert g() == null;
+        assert g() == null;
+
+        func empty() { yield;  }
+        assert empty()() == null;
+
+        // Generators can be chained without materializing arrays.
+        func naturals() {
+          var i = 0;
+          while(true)
+            yield i++;
+        }
+
+        func take(src, n) {
+          var k = n;
+          for(each v -> src) {
+            if(k-- <= 0)
+              break;
+            yield v * 2;
+          }
+        }
+
+        var sum = 0;
+        for(each v -> take(naturals(), 100000))
+          sum += v;
+        assert sum == 9999900000;
+
+        // Generators that are abandoned are destroyed.
+        for(var i = 0;  i < 1000;  ++i) {
+          var t = naturals();
+          assert t() == 0;
+        }
+
+        // Deferred expressions of an abandoned generator are executed, but it
+        // can't catch the cancellation, and errors from them are discarded.
+        var log = [];
+        func cleanup() {
+          defer log[$] = "outer";
+          defer 1 / 0;
+          for(var i = 0;  ;  ++i) {
+            defer log[$] = i;
+            try
+              yield i;
+            catch(e)
+              log[$] = "caught";
+          }
+        }
+        var c = cleanup();
+        assert c() == 0;
+        assert c() == 1;
+        c = null;
+        assert log == [ 0 ];
+
+        // Abandoned generators are cancelled when another one is started.
+        empty()();
+        assert log == [ 0, 1, "outer" ];
+
+        // Exceptions are propagated to the resumer.
+        func failing() {
+          try
+            throw "inner";
+          catch(e)
+            log = e;
+          yield 2;
+          throw "boom";
+        }
+
+        r = [];
+        try
+          for(each v -> failing())
+            try
+              throw v;
+            catch(e)
+              r[$] = e;
+        catch(e)
+          r[$] = std.string.find(e, "boom") != null;
+        assert r == [ 2, true ];
+        assert log == "inner";
+
+        // `yield` inside `catch` is not allowed, but a generator may be resumed
+        // from a `catch` clause.
+        func catching() {
+          try
+            throw "inner";
+          catch(e)
+            yield e;
+        }
+
+        try {
+          catching()();
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "not allowed") != null;
+
+        try
+          throw "outer";
+        catch(e)
+          assert failing()() == 2;
+
+        // Deep recursion in a generator fails, instead of overflowing its stack.
+        func deep(n) {
+          return n == 0 ? 0 : deep(n - 1) + 1;
+        }
+        func shallow() {
+          yield deep(800);
+        }
+        assert shallow()() == deep(800);
+
+        func recursive() {
+          yield deep(1000000);
+        }
+
+        try {
+          recursive()();
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "overflow") != null;
+
+        // A generator can't resume itself.
+        var self_gen;
+        func self_ref() { yield self_gen();  }
+        self_gen = self_ref();
+        try {
+          self_gen();
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "already running") != null;
+
+        // Closures may be generators, too.
+        var base = 100;
+        var h = func() { yield base;  base = 1;  yield base; };
+        r = [];
+        for(each v -> h())
+          r[$] = v;
+        assert r == [ 100, 1 ];
+
+        return range(3);
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    auto gen = code.execute().dereference_readonly().as_function();
+    ASTERIA_TEST_CHECK(gen.is_generator());
+    ASTERIA_TEST_CHECK(code.global().count_pooled_stack_segments() != 0);
+    ASTERIA_TEST_CHECK(code.global().count_generators() == 0);
+
+    // Generators can be resumed from C++.
+    Value value;
+    ASTERIA_TEST_CHECK(gen.resume(value, code.mut_global()));
+    ASTERIA_TEST_CHECK(value.as_integer() == 0);
+    ASTERIA_TEST_CHECK(gen.resume(value, code.mut_global()));
+    ASTERIA_TEST_CHECK(value.as_integer() == 1);
+    ASTERIA_TEST_CHECK(gen.resume(value, code.mut_global()));
+    ASTERIA_TEST_CHECK(value.as_integer() == 2);
+    ASTERIA_TEST_CHECK(!gen.resume(value, code.mut_global()));
+    ASTERIA_TEST_CHECK(!gen.resume(value, code.mut_global()));
+
+    const cow_function& script = code;
+    ASTERIA_TEST_CHECK(!script.is_generator());
+    ASTERIA_TEST_CHECK_CATCH(script.resume(value, code.mut_global()));
+
+    // `yield` is a keyword.
+    ASTERIA_TEST_CHECK_CATCH(code.reload_string(&__FILE__, __LINE__, &"var yield = 1;"));
+
+    // A cycle through a suspended generator is collected.
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func make() {
+          var g;
+          g = func() { var h = g;  yield 1;  yield 2;  } ();
+          assert g() == 1;
+        }
+        make();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+    ASTERIA_TEST_CHECK(code.global().count_generators() == 1);
+    code.reload_string(&__FILE__, __LINE__, &"std.gc.collect();");
+    code.execute();
+    ASTERIA_TEST_CHECK(code.global().count_generators() == 0);
+
+    // A generator may outlive its global context, which cancels it.
+    cow_function orphan;
+    {
+      Simple_Script other;
+      other.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          func counter() {
+            var i = 0;
+            while(true)
+              yield i++;
+          }
+          var g = counter();
+          assert g() == 0;
+          return g;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      orphan = other.execute().dereference_readonly().as_function();
+      ASTERIA_TEST_CHECK(other.global().count_generators() == 1);
+    }
+    ASTERIA_TEST_CHECK(!orphan.resume(value, code.mut_global()));
+    orphan.reset();
+
+    // A suspended generator may hold the last reference to itself when its
+    // global context is destroyed.
+    {
+      Simple_Script other;
+      other.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          var holder = [];
+          func gen() {
+            var me = holder[0];
+            yield 1;
+            yield typeof me;
+          }
+          var g = gen();
+          holder[0] = g;
+          g();
+          holder = null;
+          g = null;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      other.execute();
+      ASTERIA_TEST_CHECK(other.global().count_generators() == 1);
+    }
+  }
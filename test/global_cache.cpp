@@ -0,0 +1,56 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/variable.hpp"
+#include "../asteria/llds/reference_stack.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.mut_options().implicit_global_names = true;
+    code.reload_string(&__FILE__, __LINE__, &"return counter + std.numeric.abs(-1);");
+
+    auto var = code.open_global_variable(&"counter");
+    var->initialize(V_integer(41));
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 42);
+
+    // Assignments to global variables don't change the generation.
+    uint64_t gen = code.global().get_generation();
+    var->initialize(V_integer(1));
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 2);
+    ASTERIA_TEST_CHECK(code.global().get_generation() == gen);
+
+    // Insert a lot of global variables, so existent ones are relocated.
+    for(int k = 0;  k < 1000;  ++k)
+      code.open_global_variable(phcow_string(sformat("var_$1", k)))->initialize(V_integer(k));
+    ASTERIA_TEST_CHECK(code.global().get_generation() != gen);
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 2);
+
+    // Erased global variables can't be found any more.
+    ASTERIA_TEST_CHECK(code.erase_global_variable(&"counter"));
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+
+    var = code.open_global_variable(&"counter");
+    var->initialize(V_integer(9));
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 10);
+
+    // Each global context has its own references.
+    Simple_Script other;
+    other.mut_options().implicit_global_names = true;
+    other.open_global_variable(&"counter")->initialize(V_integer(99));
+
+    code.reload_string(&__FILE__, __LINE__, &"return func() { return counter; };");
+    auto func = code.execute().dereference_readonly().as_function();
+    for(int k = 0;  k < 3;  ++k) {
+      Reference self;
+      func.invoke(self, code.mut_global(), Reference_Stack());
+      ASTERIA_TEST_CHECK(self.dereference_readonly().as_integer() == 9);
+
+      func.invoke(self, other.mut_global(), Reference_Stack());
+      ASTERIA_TEST_CHECK(self.dereference_readonly().as_integer() == 99);
+    }
+  }
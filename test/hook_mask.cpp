@@ -0,0 +1,95 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/abstract_hooks.hpp"
+using namespace ::asteria;
+
+namespace {
+
+struct Counting_Hooks
+  :
+    Abstract_Hooks
+  {
+    uint32_t m_mask;
+    int m_calls = 0;
+    int m_enters = 0;
+    int m_interrupts = 0;
+
+    explicit
+    Counting_Hooks(uint32_t mask)
+      :
+        m_mask(mask)
+      { }
+
+    uint32_t
+    get_hook_mask()
+      const noexcept override
+      { return this->m_mask;  }
+
+    void
+    on_call(const Source_Location& /*sloc*/, const cow_function& /*target*/) override
+      { this->m_calls ++;  }
+
+    void
+    on_function_enter(const Instantiated_Function& /*func*/, Executive_Context& /*fctx*/) override
+      { this->m_enters ++;  }
+
+    void
+    on_interrupt(Executive_Context& /*ctx*/) override
+      { this->m_interrupts ++;  }
+  };
+
+}  // namespace
+
+int main()
+  {
+    Simple_Script code;
+    ASTERIA_TEST_CHECK(code.global().get_hook_mask() == hook_mask_none);
+
+    code.mut_options().inline_functions = false;
+    code.reload_string(&__FILE__, __LINE__, &"func f() { }  f();  f();");
+
+    // All hooks are enabled by default.
+    auto hooks = make_refcnt<Counting_Hooks>(hook_mask_all);
+    code.mut_global().set_hooks(hooks);
+    ASTERIA_TEST_CHECK(code.global().get_hook_mask() == hook_mask_all);
+    code.execute();
+    ASTERIA_TEST_CHECK(hooks->m_calls == 2);
+    ASTERIA_TEST_CHECK(hooks->m_enters == 3);
+
+    // Hooks that are not enabled are not called.
+    hooks = make_refcnt<Counting_Hooks>(hook_mask_call);
+    code.mut_global().set_hooks(hooks);
+    ASTERIA_TEST_CHECK(code.global().get_hook_mask() == hook_mask_call);
+    code.execute();
+    ASTERIA_TEST_CHECK(hooks->m_calls == 2);
+    ASTERIA_TEST_CHECK(hooks->m_enters == 0);
+
+    // Interrupts without the hook stop execution.
+    code.mut_global().request_interrupt();
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+    ASTERIA_TEST_CHECK(hooks->m_interrupts == 0);
+
+    hooks = make_refcnt<Counting_Hooks>(hook_mask_interrupt);
+    code.mut_global().set_hooks(hooks);
+    code.mut_global().request_interrupt();
+    code.execute();
+    ASTERIA_TEST_CHECK(hooks->m_interrupts == 1);
+    ASTERIA_TEST_CHECK(hooks->m_calls == 0);
+
+    // The mask is copied when hooks are set, until it is refreshed.
+    hooks->m_mask = hook_mask_interrupt | hook_mask_call;
+    code.execute();
+    ASTERIA_TEST_CHECK(hooks->m_calls == 0);
+    code.mut_global().refresh_hook_mask();
+    ASTERIA_TEST_CHECK(code.global().get_hook_mask() == (hook_mask_interrupt | hook_mask_call));
+    code.execute();
+    ASTERIA_TEST_CHECK(hooks->m_calls == 2);
+
+    code.mut_global().set_hooks(refcnt_ptr<Abstract_Hooks>());
+    ASTERIA_TEST_CHECK(code.global().get_hook_mask() == hook_mask_none);
+    code.execute();
+  }
@@ -0,0 +1,141 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "air_utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Compiler_Options opts = { };
+    opts.optimization_level = 2;
+
+    // small functions
+    auto code = asteria_test_compile(opts, "func add(a, b) { return a + b; } return add(1, 2);");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_inline_call) == 1);
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_alt_function_call) == 0);
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_return_statement) == 1);
+
+    opts.inline_functions = false;
+    code = asteria_test_compile(opts, "func add(a, b) { return a + b; } return add(1, 2);");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_inline_call) == 0);
+    opts.inline_functions = true;
+
+    code = asteria_test_compile(opts, "const k = func(a) { return a * 2; }; var x = k(3);");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_inline_call) == 1);
+
+    // mutable variables, variadic functions, and functions with statements
+    code = asteria_test_compile(opts, "var k = func(a) { return a * 2; }; var x = k(3);");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_inline_call) == 0);
+
+    code = asteria_test_compile(opts, "func f(...) { return 1; } var x = f();");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_inline_call) == 0);
+
+    code = asteria_test_compile(opts, "func f(a) { var b = a; return b; } var x = f(1);");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_inline_call) == 0);
+
+    code = asteria_test_compile(opts, "func f(a) { return ++a; } var x = f(1);");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_inline_call) == 0);
+
+    code = asteria_test_compile(opts, "func f(a) { return std.numeric.abs(a); } var x = f(1);");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_inline_call) == 0);
+
+    Simple_Script script;
+    cow_string frames;
+    for(uint8_t level = 0;  level <= 2;  ++level)
+      for(int inl = 0;  inl <= 1;  ++inl) {
+        script.mut_options().optimization_level = level;
+        script.mut_options().inline_functions = inl;
+        script.reload_string(
+          &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+            func add(a, b) { return a + b;  }
+            func one() { return 1;  }
+            func pick(c, x, y) { return c ? x : y;  }
+            func dflt(x) { return x ?? "none";  }
+            func elem(a, i) { return a[i];  }
+
+            assert add(1, 2) == 3;
+            assert add(add(1, 2), add(3, 4)) == 10;
+            assert add("a", "b") == "ab";
+            assert one() + one() == 2;
+            assert pick(true, 1, 2) == 1;
+            assert pick(false, 1, 2) == 2;
+            assert dflt(null) == "none";
+            assert dflt(5) == 5;
+            assert dflt() == "none";
+            assert elem([ 1, 2, 3 ], 1) == 2;
+
+            // Variables of enclosing scopes are read when called.
+            var base = 10;
+            func plus(x) { return base + x;  }
+            assert plus(1) == 11;
+            base = 20;
+            assert plus(1) == 21;
+
+            // Results are copies, so arguments are not aliased.
+            func id(x) { return x;  }
+            var arr = [ 1, 2 ];
+            var copy = id(arr);
+            copy[0] = 5;
+            assert arr[0] == 1;
+
+            // Functions are called in loops and nested scopes.
+            var sum = 0;
+            for(var i = 0;  i < 10;  ++i)
+              sum += add(i, one());
+            assert sum == 55;
+
+            {
+              func add(a, b) { return a * b;  }
+              assert add(3, 4) == 12;
+            }
+            assert add(3, 4) == 7;
+
+            sum = 0;
+            for(each k, v -> [ 1, 2, 3 ]) {
+              const sq = func(x) { return x * x;  };
+              sum += sq(v) + add(k, 0);
+            }
+            assert sum == 14 + 3;
+
+            // Too many arguments are still an error.
+            try {
+              add(1, 2, 3);
+              assert false;
+            }
+            catch(e)
+              assert std.string.find(e, "Too many arguments") != null;
+
+            // Results of proper tail calls are returned.
+            func outer(x) {
+              func sq(y) { return y * y;  }
+              if(x > 0)
+                return sq(x);
+              return ref sq(-x);
+            }
+            assert outer(3) == 9;
+            assert outer(-4) == 16;
+
+            // The callee is in backtraces.
+            func div(a, b) { return a / b;  }
+            var frames = "";
+            try
+              div(1, 0);
+            catch(e)
+              for(each k, v -> __backtrace)
+                frames += std.string.format("$1:$2:$3;", v.frame, v.line, v.value);
+            return frames;
+
+///////////////////////////////////////////////////////////////////////////////
+          )__");
+
+        auto res = script.execute();
+        const auto& str = res.dereference_readonly().as_string();
+        ASTERIA_TEST_CHECK(str.find("div(a, b)") != cow_string::npos);
+        if((level == 0) && (inl == 0))
+          frames = str;
+        ASTERIA_TEST_CHECK(str == frames);
+      }
+  }
@@ -3,6 +3,7 @@
 
 #include "utils.hpp"
 #include "../asteria/simple_script.hpp"
+#include "../asteria/library/json.hpp"
 using namespace ::asteria;
 
 int main()
@@ -109,4 +110,31 @@ int main()
 ///////////////////////////////////////////////////////////////////////////////
       )__");
     code.execute();
+
+    // Keys that occur in multiple objects share storage.
+    Value root = std_json_parse(&R"__(
+        [ { "a key that is not too short": 1, "b": 2 },
+          { "b": 3, "a key that is not too short": 4 } ]
+      )__");
+    const auto& first = root.as_array().at(0).as_object();
+    const auto& second = root.as_array().at(1).as_object();
+    ASTERIA_TEST_CHECK(first.size() == 2);
+    ASTERIA_TEST_CHECK(second.size() == 2);
+    auto qkey = first.find(&"a key that is not too short");
+    auto qother = second.find(&"a key that is not too short");
+    ASTERIA_TEST_CHECK(qkey != first.end());
+    ASTERIA_TEST_CHECK(qother != second.end());
+    ASTERIA_TEST_CHECK(qkey->first.data() == qother->first.data());
+    ASTERIA_TEST_CHECK(qkey->second.as_real() == 1);
+    ASTERIA_TEST_CHECK(qother->second.as_real() == 4);
+
+    // Keys may contain null characters.
+    root = std_json_parse(&R"__(
+        [ { "long key\u0000one": 1 }, { "long key\u0000two": 2, "long key": 3 } ]
+      )__");
+    ASTERIA_TEST_CHECK(root.as_array().at(0).as_object().size() == 1);
+    ASTERIA_TEST_CHECK(root.as_array().at(1).as_object().size() == 2);
+    qkey = root.as_array().at(1).as_object().find(cow_string("long key\0two", 12));
+    ASTERIA_TEST_CHECK(qkey != root.as_array().at(1).as_object().end());
+    ASTERIA_TEST_CHECK(qkey->second.as_real() == 2);
   }
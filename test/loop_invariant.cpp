@@ -0,0 +1,141 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "air_utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Compiler_Options opts = { };
+    opts.optimization_level = 2;
+    opts.bind_library_members = false;
+
+    // counted loops
+    auto code = asteria_test_compile(opts,
+                   "var s = 0; for(var i = 0; i < 10; ++i) s += 2; return s;");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_for_statement) == 0);
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_counted_for_statement) == 1);
+    for(size_t k = 0;  k < code.size();  ++k)
+      if(code.at(k).index() == AIR_Node::index_counted_for_statement)
+        ASTERIA_TEST_CHECK(code.at(k).as<AIR_Node::S_counted_for_statement>().count == 10);
+
+    code = asteria_test_compile(opts,
+                   "var s = 0; for(var i = 0; i < 10; ++i) s += i; return s;");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_for_statement) == 1);
+
+    // loop invariants
+    code = asteria_test_compile(opts, "for(var i = 0; i < 10; ++i) std.string.find(\"a\", \"b\");");
+    ASTERIA_TEST_CHECK(asteria_test_count(code, AIR_Node::index_counted_for_statement) == 1);
+    for(size_t k = 0;  k < code.size();  ++k)
+      if(code.at(k).index() == AIR_Node::index_counted_for_statement) {
+        const auto& altr = code.at(k).as<AIR_Node::S_counted_for_statement>();
+        ASTERIA_TEST_CHECK(asteria_test_count(altr.code_init,
+                                   AIR_Node::index_push_global_reference) == 1);
+        ASTERIA_TEST_CHECK(asteria_test_count(altr.code_body,
+                                   AIR_Node::index_push_global_reference) == 0);
+      }
+
+    Simple_Script script;
+    for(uint8_t level = 0;  level <= 2;  ++level) {
+      script.mut_options().optimization_level = level;
+      script.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          var s = 0;
+          for(var i = 0;  i < 10;  ++i)
+            s += 2;
+          assert s == 20;
+
+          s = 0;
+          for(var i = -3;  i <= 3;  i++)
+            s += 1;
+          assert s == 7;
+
+          s = 0;
+          for(var i = 5;  i < 1;  i += 1)
+            s += 1;
+          assert s == 0;
+
+          s = 0;
+          for(var i = 0;  i < 100;  ++i) {
+            s += 1;
+            if(s == 3)
+              continue;
+            if(s == 5)
+              break;
+          }
+          assert s == 5;
+
+          // The induction variable shall not be shadowed.
+          s = 0;
+          for(var i = 0;  i < 4;  ++i) {
+            var i = 10;
+            s += i;
+          }
+          assert s == 40;
+
+          // Members of `std` are looked up once.
+          var r = [];
+          for(var i = 0;  i < 3;  ++i)
+            r[$] = std.numeric.abs(-i) + std.string.find("abcabc", i, "c");
+          assert r == [ 2, 3, 4 ];
+
+          r = [];
+          for(each k, v -> [ "x", "yx" ])
+            r[$] = std.string.find(v, "x");
+          assert r == [ 0, 1 ];
+
+          r = [];
+          var n = 0;
+          while(n < 2) {
+            for(var i = 0;  i < 2;  ++i)
+              r[$] = std.numeric.max(n, i);
+            ++n;
+          }
+          assert r == [ 0, 1, 1, 1 ];
+
+          // The length of an array is looked up once if it's not modified.
+          var a = [ 1, 2, 3 ];
+          s = 0;
+          for(var i = 0;  i < countof a;  ++i)
+            s += a[i];
+          assert s == 6;
+
+          s = 0;
+          for(var i = 0;  i < countof a;  ++i)
+            if(i < 5)
+              a[$] = i;
+          assert countof a == 8;
+
+          a = [ 1, 2, 3 ];
+          for(var i = 0;  i < countof a;  ++i)
+            if(i < 5)
+              a[i + 1] = a[i];
+          assert a == [ 1, 1, 1, 1, 1, 1 ];
+
+          func push(x) { a[$] = x;  }
+          a = [ 1, 2, 3 ];
+          for(var i = 0;  i < countof a;  ++i)
+            if(i < 5)
+              push(i);
+          assert countof a == 8;
+
+          // Closures see the same values.
+          var fns = [];
+          for(var i = 0;  i < 3;  ++i) {
+            var j = -i;
+            fns[$] = func() { return std.numeric.abs(j);  };
+          }
+          assert fns[2]() == 2;
+
+          // A missing member is not an error until it's used.
+          for(var i = 0;  i < 0;  ++i)
+            std.nonexistent.member.access();
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      script.execute();
+    }
+  }
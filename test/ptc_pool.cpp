@@ -0,0 +1,75 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var pong;
+        func ping(n) {
+          if(n == 0)
+            return "ping";
+          return pong(n - 1);
+        }
+        pong = func(n) {
+          if(n == 0)
+            return "pong";
+          return ping(n - 1);
+        };
+        assert ping(100000) == "ping";
+        assert ping(100001) == "pong";
+
+        // Deferred expressions of every frame are evaluated upon return.
+        var log = "";
+        func count(n) {
+          defer log += "d";
+          if(n == 0)
+            return 0;
+          return count(n - 1);
+        }
+        assert count(5) == 0;
+        assert log == "dddddd";
+
+        // Frames appear in backtraces.
+        func fail(n) {
+          if(n == 0)
+            throw "boom";
+          return fail(n - 1);
+        }
+        try {
+          fail(3);
+          assert false;
+        }
+        catch(e) {
+          assert e == "boom";
+          var n = 0;
+          for(each k, v -> __backtrace)
+            if(v.value == "[proper tail call]")
+              ++n;
+          assert n == 3;
+        }
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+
+    // Arguments of tail calls have been reused, rather than allocated once
+    // per call.
+    const auto& global = code.global();
+    size_t hits = global.get_ptc_pool_hits();
+    size_t misses = global.get_ptc_pool_misses();
+    ASTERIA_TEST_CHECK(global.count_pooled_ptc_arguments() == misses);
+    ASTERIA_TEST_CHECK(misses <= 10);
+    ASTERIA_TEST_CHECK(hits >= 200000);
+
+    code.mut_global().clear_pooled_ptc_arguments();
+    ASTERIA_TEST_CHECK(global.count_pooled_ptc_arguments() == 0);
+  }
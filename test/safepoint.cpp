@@ -0,0 +1,104 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/executive_context.hpp"
+#include "../asteria/runtime/abstract_hooks.hpp"
+#include "../asteria/runtime/runtime_error.hpp"
+using namespace ::asteria;
+
+namespace {
+
+struct Counting_Hooks
+  :
+    Abstract_Hooks
+  {
+    int m_count = 0;
+
+    void
+    on_interrupt(Executive_Context& ctx) override
+      {
+        // Resume twice, then stop.
+        if(++ this->m_count < 3) {
+          ctx.global().request_interrupt();
+          return;
+        }
+
+        Abstract_Hooks::on_interrupt(ctx);
+      }
+  };
+
+}  // namespace
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var sum = 0;
+        for(var i = 0;  i < 1000;  ++i)
+          sum += i;
+        func f(n) { return n == 0 ? 0 : f(n - 1);  }
+        return sum + f(100);
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 499500);
+
+    // Pending interrupts stop infinite loops.
+    code.reload_string(&__FILE__, __LINE__, &"while(true) { }");
+    code.mut_global().request_interrupt();
+    ASTERIA_TEST_CHECK(code.global().is_interrupt_pending());
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+    ASTERIA_TEST_CHECK(!code.global().is_interrupt_pending());
+
+    code.reload_string(&__FILE__, __LINE__, &"func f() { return f();  }  f();");
+    code.mut_global().request_interrupt();
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+
+    // Interrupts can't be caught by scripts.
+    code.reload_string(&__FILE__, __LINE__, &"try { for(;;) { }  }  catch(e) { }");
+    code.mut_global().request_interrupt();
+    try {
+      code.execute();
+      ASTERIA_TEST_CHECK(false);
+    }
+    catch(Runtime_Error& except) {
+      ASTERIA_TEST_CHECK(except.is_interrupted());
+      ASTERIA_TEST_CHECK(!except.is_timed_out());
+    }
+
+    code.mut_global().request_interrupt();
+    code.mut_global().cancel_interrupt();
+    code.reload_string(&__FILE__, __LINE__, &"for(var i = 0;  i < 10;  ++i) { }");
+    code.execute();
+
+    // Hooks may resume execution.
+    auto hooks = make_refcnt<Counting_Hooks>();
+    code.mut_global().set_hooks(hooks);
+    code.reload_string(&__FILE__, __LINE__, &"while(true) { }");
+    code.mut_global().request_interrupt();
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+    ASTERIA_TEST_CHECK(hooks->m_count == 3);
+    code.mut_global().set_hooks(refcnt_ptr<Abstract_Hooks>());
+
+    // Time limits can't be caught by scripts.
+    code.reload_string(&__FILE__, __LINE__, &"try { for(;;) { }  }  catch(e) { }");
+    code.mut_global().set_time_limit(50);
+    try {
+      code.execute();
+      ASTERIA_TEST_CHECK(false);
+    }
+    catch(Runtime_Error& except) {
+      ASTERIA_TEST_CHECK(except.is_timed_out());
+      ASTERIA_TEST_CHECK(!except.is_interrupted());
+    }
+
+    code.mut_global().clear_time_limit();
+    code.reload_string(&__FILE__, __LINE__, &"for(var i = 0;  i < 10;  ++i) { }");
+    code.execute();
+  }
@@ -0,0 +1,131 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    for(uint8_t level = 0;  level <= 2;  ++level) {
+      code.mut_options().optimization_level = level;
+      code.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          // Blocks without declarations share the enclosing scope.
+          var sum = 0;
+          for(var i = 0;  i < 10;  ++i)
+            if(i % 2 == 0)
+              sum += i;
+            else {
+              var t = i * 10;
+              sum += t;
+            }
+          assert sum == 0 + 10 + 2 + 30 + 4 + 50 + 6 + 70 + 8 + 90;
+
+          var n = 0;
+          while(n < 5)
+            ++n;
+          assert n == 5;
+
+          do
+            n += 2;
+          while(n < 10);
+          assert n == 11;
+
+          var s = "";
+          for(each k, v -> [ "a", "b", "c" ])
+            s += v;
+          assert s == "abc";
+
+          // Closures capture from the enclosing scope through scopeless blocks.
+          var base = 100;
+          var fns = [];
+          for(each k, v -> [ 1, 2, 3 ])
+            if(v != 2) {
+              sum = (func() { return k * 10 + v;  })();
+              fns[$] = func() { return base + sum;  };
+            }
+          base = 200;
+          assert fns[0]() == 223;
+          assert fns[1]() == 223;
+
+          // Variables in a reused loop body are fresh on each iteration.
+          fns = [];
+          for(var i = 0;  i < 3;  ++i) {
+            var x = i;
+            fns[$] = func() { return x;  };
+          }
+          assert fns[0]() == 0;
+          assert fns[1]() == 1;
+          assert fns[2]() == 2;
+
+          fns = [];
+          for(each k, v -> { a: 1, b: 2 }) {
+            const w = v;
+            fns[$] = func() { return w;  };
+          }
+          assert fns[0]() + fns[1]() == 3;
+
+          // Deferred expressions run at the end of each iteration.
+          var log = "";
+          n = 0;
+          while(n < 3) {
+            defer log += "d";
+            ++n;
+            log += "b";
+            if(n == 2)
+              continue;
+          }
+          assert log == "bdbdbd";
+
+          log = "";
+          try
+            for(var i = 0;  i < 3;  ++i) {
+              defer log += "d";
+              log += "b";
+              if(i == 1)
+                throw "boom";
+            }
+          catch(e)
+            log += e;
+          assert log == "bdbdboom";
+
+          // A name declared in a previous iteration is not visible.
+          n = 0;
+          while(n < 2) {
+            ++n;
+            var y;
+            assert y == null;
+            y = n;
+          }
+
+          // Switch clauses without declarations run in the enclosing scope.
+          log = "";
+          for(var i = 0;  i < 4;  ++i)
+            switch(i) {
+              case 0:
+                log += "a";
+              case 1:
+                log += "b";
+                break;
+              case 2:
+                continue;
+              default:
+                log += std.string.format("$1", func() { return i;  } ());
+            }
+          assert log == "abb3";
+
+          switch(1) {
+            case 1:
+              var z = 5;
+              assert z == 5;
+          }
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      code.execute();
+    }
+  }
@@ -0,0 +1,111 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/executive_context.hpp"
+#include "../asteria/runtime/abstract_hooks.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/variable.hpp"
+using namespace ::asteria;
+
+namespace {
+
+struct Trap_Hooks
+  :
+    Abstract_Hooks
+  {
+    Value last_a;
+    Value last_b;
+
+    void
+    on_trap(const Source_Location& /*sloc*/, Executive_Context& ctx) override
+      {
+        // Slotted references shall still be visible by name.
+        if(auto qref = ctx.get_named_reference_opt(&"a"))
+          if(!qref->is_invalid())
+            this->last_a = qref->dereference_readonly();
+
+        if(auto qref = ctx.get_named_reference_opt(&"b"))
+          if(auto var = qref->unphase_variable_opt())
+            if(var->initialized())
+              this->last_b = var->value();
+      }
+  };
+
+}  // namespace
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func add(x, y) {
+          var z = x + y;
+          const w = z * 2;
+          ref r -> z;
+          r += 1;
+          return [ x, y, z, w ];
+        }
+        assert add(1, 2) == [ 1, 2, 4, 6 ];
+
+        var a = 1;
+        var b = 2;
+        {
+          var a = 3;  // shadowing
+          assert a == 3;
+          assert b == 2;
+          var a = 4;  // redeclaration
+          assert a == 4;
+        }
+        assert a == 1;
+
+        var fs = [];
+        for(var i = 0;  i < 3;  ++i) {
+          var j = i * 10;
+          fs[$] = func() { return j;  };
+        }
+        assert fs[0]() == 0;
+        assert fs[1]() == 10;
+        assert fs[2]() == 20;
+
+        var sum = 0;
+        for(each k, v -> [ 5, 6, 7 ])
+          sum += k * v;
+        assert sum == 20;
+
+        var [ p, q ] = [ 1, 3 ];
+        var { x, y } = { x: "x", y: "y" };
+        assert p == 1 && q == 3;
+        assert x == "x" && y == "y";
+
+        try
+          throw "meow";
+        catch(e)
+          assert e == "meow";
+
+        func fact(n) { return n <= 1 ? 1 : n * fact(n - 1);  }
+        assert fact(10) == 3628800;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+
+    // Check names.
+    code.mut_options().verbose_single_step_traps = true;
+    auto hooks = make_refcnt<Trap_Hooks>();
+    code.mut_global().set_hooks(hooks);
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+        func test(a) {
+          var b = a + 1;
+          b;
+        }
+        test(41);
+      )__");
+    code.execute();
+    ASTERIA_TEST_CHECK(hooks->last_a.as_integer() == 41);
+    ASTERIA_TEST_CHECK(hooks->last_b.as_integer() == 42);
+  }
@@ -0,0 +1,74 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func depth(n) {
+          if(n == 0)
+            return 0;
+          return 1 + depth(n - 1);
+        }
+        assert depth(5000) == 5000;
+
+        // Exceptions propagate across segments.
+        func fail(n) {
+          if(n == 0)
+            throw "boom";
+          return 1 + fail(n - 1);
+        }
+        try {
+          fail(1500);
+          assert false;
+        }
+        catch(e) {
+          assert e == "boom";
+          assert countof __backtrace > 3000;
+        }
+
+        // Calls may recurse through native functions.
+        func nested(n) {
+          if(n == 0)
+            return 0;
+          return std.array.generate(func(i, p) { return 1 + nested(n - 1);  }, 1)[0];
+        }
+        assert nested(2000) == 2000;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+
+#if defined ASTERIA_NO_UCONTEXT
+    // Stacks can't be switched, so deep recursion is still stopped by the
+    // recursion sentry.
+    code.mut_global().set_max_stack_segments(1000);
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+    ASTERIA_TEST_CHECK(code.global().count_stack_segments() == 0);
+    return 0;
+#endif
+
+    // Deep recursion fails without stack segments.
+    ASTERIA_TEST_CHECK(code.global().get_max_stack_segments() == 0);
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+
+    code.mut_global().set_max_stack_segments(1000);
+    code.execute();
+    ASTERIA_TEST_CHECK(code.global().count_stack_segments() == 0);
+    ASTERIA_TEST_CHECK(code.global().count_pooled_stack_segments() > 0);
+
+    code.mut_global().clear_pooled_stack_segments();
+    ASTERIA_TEST_CHECK(code.global().count_pooled_stack_segments() == 0);
+
+    // Segments are limited.
+    code.mut_global().set_max_stack_segments(2);
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+    ASTERIA_TEST_CHECK(code.global().count_stack_segments() == 0);
+  }
@@ -0,0 +1,135 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "air_utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Compiler_Options opts = { };
+    opts.bind_library_members = false;
+
+    // fused nodes
+    auto nodes = asteria_test_compile(opts, "var x = 1;  x += 2;  return x < 5 ? x : 0;", true);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_apply_operator_local_bi32) == 1);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_branch_compare_bi32) == 1);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_apply_operator_bi32) == 0);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_branch_expression) == 0);
+
+    nodes = asteria_test_compile(opts, "return std.math.pi;", true);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_push_global_member) == 1);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_push_global_reference) == 0);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_member_access) == 0);
+
+    opts.optimization_level = 0;
+    nodes = asteria_test_compile(opts, "var x = 1;  x += 2;  return x < 5 ? x : 0;", true);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_apply_operator_local_bi32) == 0);
+    ASTERIA_TEST_CHECK(asteria_test_count(nodes, AIR_Node::index_branch_compare_bi32) == 0);
+
+    // semantics
+    Simple_Script code;
+    for(uint8_t level = 0;  level <= 2;  ++level) {
+      code.mut_options().optimization_level = level;
+      code.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          // local and immediate
+          var x = 5;
+          assert x + 1 == 6;
+          assert x - 7 == -2;
+          assert x == 5;
+          assert x != 4;
+          assert x < 6;
+          assert x > 4;
+          assert x <= 5;
+          assert x >= 5;
+          assert !(x </> 5);
+          x += 3;
+          assert x == 8;
+          x -= 10;
+          assert x == -2;
+          x = x + 4;
+          assert x == 2;
+          x = x * 5;
+          assert x == 10;
+
+          var r = 1.5;
+          assert r + 1 == 2.5;
+          r = r - 1;
+          assert r == 0.5;
+
+          var n = null;
+          assert (n == 1) == false;
+          assert (n != 1) == true;
+          assert n </> 1;
+          try {
+            n < 1;
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "not comparable") != null;
+
+          var s = "meow";
+          try {
+            s + 1;
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "Addition not applicable") != null;
+
+          var big = 0x7FFFFFFFFFFFFFFF;
+          try {
+            big + 1;
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "Integer addition overflow") != null;
+          assert big == 0x7FFFFFFFFFFFFFFF;
+
+          const k = 1;
+          try {
+            k = k + 1;
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "not modifiable") != null;
+          assert k == 1;
+
+          // comparison and branch
+          func fib(v) { return v <= 1 ? v : fib(v - 1) + fib(v - 2);  }
+          assert fib(20) == 6765;
+          var y = 3;
+          assert (y < 5 || "no") == true;
+          assert (y > 5 || "no") == "no";
+          assert (y < 5 && "yes") == "yes";
+          assert (y > 5 && "yes") == false;
+
+          // global members
+          assert std.math.pi > 3;
+          assert std.string.find("abc", "c") == 2;
+          assert std.no_such_member == null;
+          var g = std.math;
+          assert g.pi == std.math.pi;
+
+          // literals of constants
+          var a;
+          for(var i = 0;  i < 3;  ++i) {
+            a = [ 1, [ 2, 3 ], { z: 4 } ];
+            assert a[0] == 1;
+            assert a[1] == [ 2, 3 ];
+            assert a[2].z == 4;
+            a[0] = i;
+            a[1][0] = i;
+            a[2].z = i;
+          }
+          assert a[0] == 2;
+          assert a[1] == [ 2, 3 ];
+          assert a[2].z == 2;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      code.execute();
+    }
+  }
@@ -0,0 +1,161 @@
+// This file is part of Asteria.
+// Copyright (C) 2018-2026 LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    for(uint8_t level = 0;  level <= 2;  ++level) {
+      code.mut_options().optimization_level = level;
+      code.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          func classify(x) {
+            switch(x) {
+              case 1:
+                return "one";
+              case "one":
+                return "str1";
+              default:
+                return "def";
+              case 2:
+                return "two";
+              case 1:
+                return "dup";
+              case "":
+                return "empty";
+              case 3:
+              case 4:
+                var y = "three-four";
+                return y;
+            }
+          }
+
+          assert classify(1) == "one";
+          assert classify(2) == "two";
+          assert classify(3) == "three-four";
+          assert classify(4) == "three-four";
+          assert classify(5) == "def";
+          assert classify("one") == "str1";
+          assert classify("") == "empty";
+          assert classify("two") == "def";
+          assert classify(null) == "def";
+          assert classify(true) == "def";
+          assert classify([1]) == "def";
+
+          // Reals are compared with integer labels.
+          assert classify(1.0) == "one";
+          assert classify(2.0) == "two";
+          assert classify(-0.0) == "def";
+          assert classify(0/0.0) == "def";
+
+          // Fall-through and bypassed names still work.
+          func fall(x) {
+            var r = [];
+            switch(x) {
+              case "a":
+                r[$] = "a";
+              case "b":
+                var z = 42;
+                r[$] = "b";
+              case "c":
+                r[$] = z;
+                break;
+              case "d":
+                r[$] = "d";
+            }
+            return r;
+          }
+
+          assert fall("a") == ["a","b",42];
+          assert fall("b") == ["b",42];
+          try {
+            fall("c");
+            assert false;
+          }
+          catch(e)
+            assert std.string.find(e, "bypassed") != null;
+          assert fall("d") == ["d"];
+          assert fall("e") == [];
+
+          // Without `default`, nothing is executed.
+          func nodef(x) {
+            var r = 0;
+            switch(x) {
+              case 10:
+                r = 1;
+            }
+            return r;
+          }
+
+          assert nodef(10) == 1;
+          assert nodef(11) == 0;
+
+          // Dynamic labels and ranges take the sequential path.
+          var n = 0;
+          func label(v) {
+            n += 1;
+            return v;
+          }
+          func dyn(x) {
+            switch(x) {
+              case label(1):
+                return "one";
+              case label(2):
+                return "two";
+            }
+            return "none";
+          }
+
+          assert dyn(2) == "two";
+          assert n == 2;
+          assert dyn(1) == "one";
+          assert n == 3;
+
+          func range(x) {
+            switch(x) {
+              case 0:
+                return "zero";
+              each [1,10):
+                return "small";
+              case "s":
+                return "string";
+            }
+            return "big";
+          }
+
+          assert range(0) == "zero";
+          assert range(5) == "small";
+          assert range(10) == "big";
+          assert range("s") == "string";
+
+          // Many string labels.
+          func opcode(s) {
+            switch(s) {
+              case "op0":  return 0;
+              case "op1":  return 1;
+              case "op2":  return 2;
+              case "op3":  return 3;
+              case "op4":  return 4;
+              case "op5":  return 5;
+              case "op6":  return 6;
+              case "op7":  return 7;
+              case "op8":  return 8;
+              case "op9":  return 9;
+            }
+            return -1;
+          }
+
+          for(var i = 0;  i < 10;  ++i)
+            assert opcode("op" + std.string.format("$1", i)) == i;
+          assert opcode("op10") == -1;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      code.execute();
+    }
+  }